@@ -113,7 +113,19 @@ class Info:
         layout.set_font_description(font_description)
         layout.set_text("M")
         size = layout.get_pixel_size()
-        return int(6 * size.height)
+        return int(7 * size.height)
+
+    # the text with the values sampled by the program (node, machine, os, cpu,
+    #   memory, load and net), cpu and memory are the history 0..1 oldest first
+    #   (if this is missing draw is used, reading the values here)
+    def drawSnapshot(self,ctx,font,text,cpu,memory):
+        layout = PangoCairo.create_layout(ctx)
+        font_description = Pango.font_description_from_string(font)
+        layout.set_font_description(font_description)
+        layout.set_text(text.rstrip("\n"))
+        ctx.move_to(0,0)
+        PangoCairo.show_layout(ctx, layout)
+        return 0
 
     def draw(self,ctx,font,netinfo):
         layout = PangoCairo.create_layout(ctx)
@@ -25,7 +25,8 @@
 
 /**
  * angular coordinate system, used when it is about visibility
- *   e.g. for a specific time & place on earth
+ *   e.g. for a specific time & place on earth,
+ *   a plain value the shared_ptr variants are kept for compatibility
  *
  */
 class AzimutAltitude
@@ -33,10 +34,11 @@ class AzimutAltitude
 public:
     AzimutAltitude();
     AzimutAltitude(double azimut, double altitude);
-    explicit AzimutAltitude(const AzimutAltitude& orig) = delete;
-    virtual ~AzimutAltitude() = default;
+    AzimutAltitude(const AzimutAltitude& orig) = default;
+    AzimutAltitude& operator=(const AzimutAltitude& orig) = default;
+    ~AzimutAltitude() = default;
 
-    bool isVisible();
+    bool isVisible() const;
 
     //Greg Miller (gmiller@gregmiller.net) 2022
     //Released as public domain
@@ -49,19 +51,19 @@ public:
     //
     //Rectangular:
     //x is left/right, y is forward/backward, z is up/down
-    Point2D toScreen(const Layout& layout);
+    Point2D toScreen(const Layout& layout) const;
 
-    double getAzimut();
-    double getAltitude();
-    double getAzimutDegrees();
-    double getAltitudeDegrees();
+    double getAzimut() const;
+    double getAltitude() const;
+    double getAzimutDegrees() const;
+    double getAltitudeDegrees() const;
 
 
 
 
 private:
-    double azimut;    // the values are in radians
-    double altitude;
+    double azimut{};    // the values are in radians
+    double altitude{};
 
 };
 
@@ -55,9 +55,10 @@ StarOptionGroup::on_error(Glib::OptionContext& /* context */, Glib::OptionGroup&
 }
 
 
-BackgroundApp::BackgroundApp(int argc, char **argv)
+BackgroundApp::BackgroundApp(int argc, char **argv, std::chrono::steady_clock::time_point started)
 : Gtk::Application(argc, argv, "de.pfeifer_syscon.background", Gio::ApplicationFlags::APPLICATION_HANDLES_OPEN)
 , m_exec{argv[0]}
+, m_started{started}
 {
     Glib::OptionContext context;
     StarOptionGroup group;
@@ -188,6 +189,12 @@ BackgroundApp::isDaemon()
     return m_daemon ;
 }
 
+std::chrono::steady_clock::time_point
+BackgroundApp::getStarted() const
+{
+    return m_started;
+}
+
 void
 BackgroundApp::on_action_help() {
 
@@ -232,8 +239,9 @@ BackgroundApp::on_startup()
 
 int main(int argc, char** argv)
 {
+    const auto started = std::chrono::steady_clock::now();
     setlocale(LC_ALL, "");      // make locale dependent
-    BackgroundApp app(argc, argv);
+    BackgroundApp app(argc, argv, started);
 
     return app.run();
 }
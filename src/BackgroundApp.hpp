@@ -19,6 +19,7 @@
 #pragma once
 
 #include <gtkmm.h>
+#include <chrono>
 
 #include <glibmm.h>
 
@@ -49,7 +50,7 @@ class BackgroundApp
 : public Gtk::Application
 {
 public:
-    BackgroundApp(int arc, char **argv);
+    BackgroundApp(int arc, char **argv, std::chrono::steady_clock::time_point started);
     explicit BackgroundApp(const BackgroundApp& nomadApp) = delete;
     virtual ~BackgroundApp() = default;
 
@@ -62,6 +63,8 @@ public:
     void on_open(const Gio::Application::type_vec_files& files, const Glib::ustring& hint) override;
     void on_action_about();
     bool isDaemon();
+    // taken at the start of main, for the startup timing
+    std::chrono::steady_clock::time_point getStarted() const;
 
     static constexpr auto DAEMON_KEY{"daemon"};
 
@@ -73,6 +76,7 @@ private:
     StarWin* m_starAppWindow{nullptr};
     Glib::StdStringView m_exec;
     bool m_daemon{false};
+    const std::chrono::steady_clock::time_point m_started;
     std::shared_ptr<KeyConfig> m_config;
     //Glib::RefPtr<Gtk::Builder> m_builder;
     void on_action_quit();
@@ -0,0 +1,103 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "BandPool.hpp"
+
+BandPool::BandPool(uint32_t threads)
+: m_threads{threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads}
+{
+    m_workers.reserve(m_threads - 1u);
+    for (uint32_t band = 1; band < m_threads; ++band) {
+        m_workers.emplace_back(&BandPool::work, this, band);
+    }
+}
+
+BandPool::~BandPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCondition.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+uint32_t
+BandPool::getThreads() const
+{
+    return m_threads;
+}
+
+void
+BandPool::run(uint32_t bands, const std::function<void(uint32_t band)>& task)
+{
+    bands = std::clamp(bands, 1u, m_threads);
+    if (bands > 1u) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_bands = bands;
+            m_pending = bands - 1u;
+            ++m_generation;
+        }
+        m_startCondition.notify_all();
+    }
+    task(0u);
+    if (bands > 1u) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this] {
+            return m_pending == 0u;
+        });
+        m_task = nullptr;
+    }
+}
+
+void
+BandPool::work(uint32_t band)
+{
+    uint64_t generation{};
+    while (true) {
+        const std::function<void(uint32_t)>* task{};
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCondition.wait(lock, [this, generation] {
+                return m_stop || m_generation != generation;
+            });
+            if (m_stop) {
+                return;
+            }
+            generation = m_generation;
+            if (band >= m_bands) {
+                continue;   // not needed for this image
+            }
+            task = m_task;
+        }
+        (*task)(band);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_pending;
+        }
+        m_doneCondition.notify_one();
+    }
+}
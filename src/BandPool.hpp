@@ -0,0 +1,60 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+
+/**
+ * keeps the threads to draw the bands of a image,
+ *   so a frame does not pay for the thread start
+ *   (and each thread keeps its pango font map).
+ *   Band 0 is drawn by the caller of run.
+ */
+class BandPool
+{
+public:
+    // threads 0 uses the available cores
+    BandPool(uint32_t threads);
+    explicit BandPool(const BandPool& orig) = delete;
+    virtual ~BandPool();
+
+    // the bands (including the calling thread)
+    uint32_t getThreads() const;
+    // call task for the bands 0..bands-1 (at most getThreads), returns when all are done
+    void run(uint32_t bands, const std::function<void(uint32_t band)>& task);
+
+protected:
+    void work(uint32_t band);
+
+private:
+    const uint32_t m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_startCondition;
+    std::condition_variable m_doneCondition;
+    const std::function<void(uint32_t)>* m_task{};
+    uint32_t m_bands{};
+    uint32_t m_pending{};
+    uint64_t m_generation{};
+    bool m_stop{false};
+    std::vector<std::thread> m_workers;
+};
@@ -22,6 +22,7 @@
 #include "Math.hpp"
 #include "FileLoader.hpp"
 #include "background_config.h"
+#include "Compositor.hpp"
 
 void
 Grid::put(Glib::RefPtr<Pango::Layout>& layout
@@ -78,68 +79,102 @@ CalendarModule::getPyScriptName()
     return "cal.py";
 }
 
-void
-CalendarModule::display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin)
+// measure each month, as the rows may change
+size_t
+CalendarModule::getLayoutKey(StarWin* starWin)
 {
-    if (m_height == 0) {
-        getHeight(ctx, starWin);
-    }
+    Glib::DateTime dateToday = Glib::DateTime::create_now_local();
+    return Compositor::combine(Module::getLayoutKey(starWin), std::hash<int>{}(dateToday.get_year() * 12 + dateToday.get_month()));
+}
 
-    getPrimaryColor(ctx);
-    auto calFont = getFont();
-#   ifdef USE_PYTHON
-    auto pyClass = checkPyClass(starWin, pyClassName);
-    if (pyClass) {
-        auto font = calFont.to_string();
-        pyClass->invokeMethod("draw", ctx, font);
-        if (pyClass->hasFailed()) {
-            starWin->showMessage(pyClass->getError(), Gtk::MessageType::MESSAGE_ERROR);
-        }
-    }
-    else {
-        std::cout << "CalendarModule::display no Class!" << std::endl;
-    }
-#   else
-    // as there seems no way to diffrentiate the locale start with monday (but it's the iso way)
-    auto pangoLayout = Pango::Layout::create(ctx);
-    pangoLayout->set_font_description(calFont);
-    starDraw->scale(calFont, 0.6);
-    auto smallLayout = Pango::Layout::create(ctx);
-    smallLayout->set_font_description(calFont);
-    auto boldLayout = Pango::Layout::create(ctx);
-    auto boldFont = getFont();
-    boldFont.set_weight(Pango::WEIGHT_BOLD);
-    boldLayout->set_font_description(boldFont);
-    Grid grid{static_cast<int>(m_width * 2.5), m_height};
+// the calendar only changes with the day
+size_t
+CalendarModule::getContentKey(StarWin* starWin)
+{
     Glib::DateTime dateToday = Glib::DateTime::create_now_local();
-    pangoLayout->set_text(dateToday.format("%B"));  // month name
-    grid.put(pangoLayout, ctx, 1, 0, 0.5, 7);
-    Glib::DateTime dateNames = Glib::DateTime::create_utc(2024, 1, 1, 0, 0, 0); // start with a monday
-    for (auto wd = 1; wd <= 7; ++wd) {
-        pangoLayout->set_text(dateNames.format("%a"));  // weekday abbr.
-        grid.put(pangoLayout, ctx, wd, 1, 1.0);
-        dateNames = dateNames.add_days(1);
-    }
-    Glib::DateTime dateTime = Glib::DateTime::create_now_local();
-    dateTime = dateTime.add_days(-(dateTime.get_day_of_month() - 1)); // beginning of month
-    for (int row = 2; row < 8; ++row) {
-        smallLayout->set_text(dateTime.format("%V"));
-        grid.put(smallLayout, ctx, 0, row, 1.0);
-        int wd = dateTime.get_day_of_week();
-        for (int w = wd; w <= 7; ++w) {
-            auto dayLayout = pangoLayout;
-            if (dateTime.get_day_of_month() == dateToday.get_day_of_month()) {
-                dayLayout = boldLayout;
+    size_t key = std::hash<int>{}(dateToday.get_year() * 400 + dateToday.get_day_of_year());
+    return key == Compositor::UNCACHED ? 1u : key;
+}
+
+// the day changes on a hour
+uint32_t
+CalendarModule::getUpdateSeconds()
+{
+    return 3600u;
+}
+
+Module::DisplayFunc
+CalendarModule::prepareDisplay(StarWin* starWin)
+{
+    std::shared_ptr<PyClass> pyClass;
+#   ifdef USE_PYTHON
+    pyClass = checkPyClass(starWin, pyClassName);
+#   endif
+    // the cell size of getHeight
+    return [pyClass, color = getPrimaryColor(), calFont = getFont(), width = m_width, height = m_height] (const Cairo::RefPtr<Cairo::Context>& ctx) mutable {
+        std::string error;
+        setSource(ctx, color);
+#       ifdef USE_PYTHON
+        if (pyClass) {
+            auto font = calFont.to_string();
+            pyClass->invokeMethod("draw", ctx, font);
+            if (pyClass->hasFailed()) {
+                error = pyClass->getError();
             }
-            dayLayout->set_text(dateTime.format("%e"));
-            grid.put(dayLayout, ctx, w, row, 1.0);
-            dateTime = dateTime.add_days(1);
-            if (dateTime.get_month() != dateToday.get_month()) {
-                return;      // if month ended stop
+        }
+        else {
+            std::cout << "CalendarModule::display no Class!" << std::endl;
+        }
+#       else
+        if (height == 0) {      // not measured, use em as reference
+            auto emLayout = Pango::Layout::create(ctx);
+            emLayout->set_font_description(calFont);
+            emLayout->set_text("M");
+            emLayout->get_pixel_size(width, height);
+        }
+        // as there seems no way to diffrentiate the locale start with monday (but it's the iso way)
+        auto pangoLayout = Pango::Layout::create(ctx);
+        pangoLayout->set_font_description(calFont);
+        auto smallFont = calFont;
+        smallFont.set_size(static_cast<int>(smallFont.get_size() * 0.6));
+        auto smallLayout = Pango::Layout::create(ctx);
+        smallLayout->set_font_description(smallFont);
+        auto boldLayout = Pango::Layout::create(ctx);
+        auto boldFont = calFont;
+        boldFont.set_weight(Pango::WEIGHT_BOLD);
+        boldLayout->set_font_description(boldFont);
+        Grid grid{static_cast<int>(width * 2.5), height};
+        Glib::DateTime dateToday = Glib::DateTime::create_now_local();
+        pangoLayout->set_text(dateToday.format("%B"));  // month name
+        grid.put(pangoLayout, ctx, 1, 0, 0.5, 7);
+        Glib::DateTime dateNames = Glib::DateTime::create_utc(2024, 1, 1, 0, 0, 0); // start with a monday
+        for (auto wd = 1; wd <= 7; ++wd) {
+            pangoLayout->set_text(dateNames.format("%a"));  // weekday abbr.
+            grid.put(pangoLayout, ctx, wd, 1, 1.0);
+            dateNames = dateNames.add_days(1);
+        }
+        Glib::DateTime dateTime = Glib::DateTime::create_now_local();
+        dateTime = dateTime.add_days(-(dateTime.get_day_of_month() - 1)); // beginning of month
+        for (int row = 2; row < 8; ++row) {
+            smallLayout->set_text(dateTime.format("%V"));
+            grid.put(smallLayout, ctx, 0, row, 1.0);
+            int wd = dateTime.get_day_of_week();
+            for (int w = wd; w <= 7; ++w) {
+                auto dayLayout = pangoLayout;
+                if (dateTime.get_day_of_month() == dateToday.get_day_of_month()) {
+                    dayLayout = boldLayout;
+                }
+                dayLayout->set_text(dateTime.format("%e"));
+                grid.put(dayLayout, ctx, w, row, 1.0);
+                dateTime = dateTime.add_days(1);
+                if (dateTime.get_month() != dateToday.get_month()) {
+                    return error;      // if month ended stop
+                }
             }
         }
-    }
-#   endif
+#       endif
+        return error;
+    };
 }
 
 void
@@ -52,13 +52,16 @@ public:
     virtual ~CalendarModule() = default;
 
     int getHeight(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin) override;
-    void display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin) override;
+    DisplayFunc prepareDisplay(StarWin* starWin) override;
+    size_t getLayoutKey(StarWin* starWin) override;
+    size_t getContentKey(StarWin* starWin) override;
+    uint32_t getUpdateSeconds() override;
     void setupParam(const Glib::RefPtr<Gtk::Builder>& builder, StarWin* starWin) override;
 
     Glib::ustring getPyScriptName() override;
     static constexpr auto pyClassName{"Cal"};
 private:
-    int m_width;
+    int m_width{0};
     int m_height{0};
 };
 
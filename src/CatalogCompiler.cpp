@@ -0,0 +1,300 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <cstdlib>
+
+#include "CatalogFile.hpp"
+#include "HipparcosFormat.hpp"
+#include "Milkyway.hpp"
+#include "MessierLoader.hpp"
+#include "ConstellationFormat.hpp"
+#include "HorizonMatrix.hpp"
+#include "StarTiles.hpp"
+#include "Math.hpp"
+
+// tool to convert the shipped resources into the binary catalog (at build time)
+//   usage: background-catalog hipparcos.json mw.json messier.json SnT_constellation.txt catalog.bgcat
+// additionally allows to convert the full hipparcos or tycho-2 catalog
+//   into a star only catalog for the local data dir (installed for this see README)
+
+static void
+addVectors(CatalogWriter& writer, const std::vector<std::shared_ptr<RaDec>>& raDecs
+         , CatalogSectionType xType, CatalogSectionType yType, CatalogSectionType zType)
+{
+    std::vector<int16_t> x, y, z;
+    x.reserve(raDecs.size());
+    y.reserve(raDecs.size());
+    z.reserve(raDecs.size());
+    for (auto& raDec : raDecs) {
+        const double cosDec = std::cos(raDec->getDecRad());
+        x.push_back(UnitVectors::quantize(cosDec * std::cos(raDec->getRaRad())));
+        y.push_back(UnitVectors::quantize(cosDec * std::sin(raDec->getRaRad())));
+        z.push_back(UnitVectors::quantize(std::sin(raDec->getDecRad())));
+    }
+    writer.add<int16_t>(xType, x);
+    writer.add<int16_t>(yType, y);
+    writer.add<int16_t>(zType, z);
+}
+
+static bool
+addStars(CatalogWriter& writer, std::vector<CatalogStar>& stars)
+{
+    if (stars.empty()) {
+        return false;
+    }
+    auto tiles = StarTiles::build(stars);
+    std::vector<int16_t> x, y, z, vmag;
+    std::vector<int32_t> numbers;
+    x.reserve(stars.size());
+    y.reserve(stars.size());
+    z.reserve(stars.size());
+    vmag.reserve(stars.size());
+    numbers.reserve(stars.size());
+    for (auto& star : stars) {
+        const double cosDec = std::cos(star.dec);
+        x.push_back(UnitVectors::quantize(cosDec * std::cos(star.ra)));
+        y.push_back(UnitVectors::quantize(cosDec * std::sin(star.ra)));
+        z.push_back(UnitVectors::quantize(std::sin(star.dec)));
+        vmag.push_back(CatalogFile::quantizeMagnitude(star.vmag));
+        numbers.push_back(star.number);
+    }
+    writer.add<int16_t>(CatalogSectionType::StarX, x);
+    writer.add<int16_t>(CatalogSectionType::StarY, y);
+    writer.add<int16_t>(CatalogSectionType::StarZ, z);
+    writer.add<int16_t>(CatalogSectionType::StarVmag, vmag);
+    writer.add<int32_t>(CatalogSectionType::StarNumber, numbers);
+    writer.add<StarTileRecord>(CatalogSectionType::StarTile, tiles);
+    std::cout << "Stars " << stars.size() << " tiles " << tiles.size() << std::endl;
+    return true;
+}
+
+static std::vector<std::string>
+splitFields(const std::string& line)
+{
+    std::vector<std::string> fields;
+    size_t start{};
+    while (true) {
+        auto end = line.find('|', start);
+        fields.push_back(line.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1u;
+    }
+    return fields;
+}
+
+static bool
+toDouble(const std::string& field, double& value)
+{
+    char* end{};
+    value = std::strtod(field.c_str(), &end);
+    return end != field.c_str();    // a empty (blank) field is not converted
+}
+
+// the main catalog from CDS I/239 hip_main.dat
+static std::vector<CatalogStar>
+readHipparcosMain(const std::string& file)
+{
+    std::vector<CatalogStar> stars;
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line)) {
+        auto fields = splitFields(line);
+        double hip, vmag, ra, dec;
+        if (fields.size() > 9u
+         && toDouble(fields[1], hip)
+         && toDouble(fields[5], vmag)
+         && toDouble(fields[8], ra)
+         && toDouble(fields[9], dec)) {
+            stars.push_back(CatalogStar{Math::toRadians(ra), Math::toRadians(dec), vmag, static_cast<int32_t>(hip)});
+        }
+    }
+    return stars;
+}
+
+// the main catalog from CDS I/259 catalog.dat
+static std::vector<CatalogStar>
+readTycho2(const std::string& file)
+{
+    std::vector<CatalogStar> stars;
+    stars.reserve(2600000u);
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line)) {
+        auto fields = splitFields(line);
+        if (fields.size() < 26u) {
+            continue;
+        }
+        double ra, dec, bt, vt, hip{};
+        if (!toDouble(fields[2], ra)            // mean position
+         || !toDouble(fields[3], dec)) {
+            if (!toDouble(fields[24], ra)       // observed position, for the few without mean
+             || !toDouble(fields[25], dec)) {
+                continue;
+            }
+        }
+        const bool hasBt = toDouble(fields[17], bt);
+        const bool hasVt = toDouble(fields[19], vt);
+        double vmag;
+        if (hasBt && hasVt) {
+            vmag = vt - 0.090 * (bt - vt);      // johnson V see the tycho-2 guide
+        }
+        else if (hasVt) {
+            vmag = vt;
+        }
+        else if (hasBt) {
+            vmag = bt;
+        }
+        else {
+            continue;
+        }
+        toDouble(fields[23], hip);  // tycho ids don't fit the number, so keep hipparcos if known
+        stars.push_back(CatalogStar{Math::toRadians(ra), Math::toRadians(dec), vmag, static_cast<int32_t>(hip)});
+    }
+    return stars;
+}
+
+static bool
+addMilkyway(CatalogWriter& writer, const std::string& file)
+{
+    auto bounds = Milkyway::readBounds(file);
+    if (bounds.empty()) {
+        std::cout << "No milkyway read from " << file << std::endl;
+        return false;
+    }
+    std::vector<std::shared_ptr<RaDec>> raDecs;
+    std::vector<MilkywayPolyRecord> polys;
+    polys.reserve(bounds.size());
+    for (auto& poly : bounds) {
+        MilkywayPolyRecord rec{};
+        rec.first = static_cast<uint32_t>(raDecs.size());
+        auto points = poly->getPoints();
+        rec.count = static_cast<uint32_t>(points.size());
+        rec.intensity = poly->getIntensity();
+        raDecs.insert(raDecs.end(), points.begin(), points.end());
+        polys.push_back(rec);
+    }
+    addVectors(writer, raDecs, CatalogSectionType::MilkywayX, CatalogSectionType::MilkywayY, CatalogSectionType::MilkywayZ);
+    writer.add<MilkywayPolyRecord>(CatalogSectionType::MilkywayPoly, polys);
+    std::cout << "Milkyway polys " << polys.size() << " points " << raDecs.size() << std::endl;
+    return true;
+}
+
+static bool
+addMessier(CatalogWriter& writer, const std::string& file)
+{
+    auto messiers = MessierLoader::readObjects(file);
+    if (messiers.empty()) {
+        std::cout << "No messier objects read from " << file << std::endl;
+        return false;
+    }
+    std::vector<std::shared_ptr<RaDec>> raDecs;
+    std::vector<int16_t> vmag;
+    std::vector<MessierNameRecord> names;
+    for (auto& messier : messiers) {
+        raDecs.push_back(messier->getRaDec());
+        vmag.push_back(CatalogFile::quantizeMagnitude(messier->getVmagnitude()));
+        MessierNameRecord name{};
+        std::strncpy(name.name, messier->getName().c_str(), sizeof(name.name) - 1u);
+        names.push_back(name);
+    }
+    addVectors(writer, raDecs, CatalogSectionType::MessierX, CatalogSectionType::MessierY, CatalogSectionType::MessierZ);
+    writer.add<int16_t>(CatalogSectionType::MessierVmag, vmag);
+    writer.add<MessierNameRecord>(CatalogSectionType::MessierName, names);
+    std::cout << "Messier " << messiers.size() << std::endl;
+    return true;
+}
+
+static bool
+addConstellations(CatalogWriter& writer, const std::string& file)
+{
+    auto constellations = ConstellationFormat::readConstellations(Gio::File::create_for_path(file));
+    if (constellations.empty()) {
+        std::cout << "No constellations read from " << file << std::endl;
+        return false;
+    }
+    std::vector<std::shared_ptr<RaDec>> raDecs;
+    std::vector<ConstellationLineRecord> lines;
+    std::vector<ConstellationNameRecord> names;
+    for (auto& constl : constellations) {
+        for (auto& polyline : constl->getPolylines()) {
+            ConstellationLineRecord rec{};
+            rec.first = static_cast<uint32_t>(raDecs.size());
+            auto points = polyline->getPoints();
+            rec.count = static_cast<uint32_t>(points.size());
+            rec.width = polyline->getWidth();
+            rec.group = static_cast<uint32_t>(names.size());
+            raDecs.insert(raDecs.end(), points.begin(), points.end());
+            lines.push_back(rec);
+        }
+        ConstellationNameRecord name{};
+        std::strncpy(name.name, constl->getName().c_str(), sizeof(name.name) - 1u);
+        names.push_back(name);
+    }
+    addVectors(writer, raDecs, CatalogSectionType::ConstellationX, CatalogSectionType::ConstellationY, CatalogSectionType::ConstellationZ);
+    writer.add<ConstellationLineRecord>(CatalogSectionType::ConstellationLine, lines);
+    writer.add<ConstellationNameRecord>(CatalogSectionType::ConstellationName, names);
+    std::cout << "Constellations " << names.size() << " lines " << lines.size() << " points " << raDecs.size() << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    // a local star catalog to place as HipparcosFormat::LOCAL_STARS_FILE
+    if (argc == 4
+     && (std::strcmp(argv[1], "--hipparcos") == 0
+      || std::strcmp(argv[1], "--tycho2") == 0)) {
+        auto stars = std::strcmp(argv[1], "--hipparcos") == 0
+                        ? readHipparcosMain(argv[2])
+                        : readTycho2(argv[2]);
+        CatalogWriter writer;
+        if (!addStars(writer, stars)) {
+            std::cout << "No stars read from " << argv[2] << std::endl;
+            return 2;
+        }
+        return writer.write(argv[3]) ? 0 : 3;
+    }
+    if (argc != 6) {
+        std::cout << "Usage: " << argv[0] << " hipparcos.json mw.json messier.json SnT_constellation.txt catalog.bgcat" << std::endl;
+        std::cout << "       " << argv[0] << " --hipparcos hip_main.dat " << HipparcosFormat::LOCAL_STARS_FILE << std::endl;
+        std::cout << "       " << argv[0] << " --tycho2 catalog.dat " << HipparcosFormat::LOCAL_STARS_FILE << std::endl;
+        return 1;
+    }
+    CatalogWriter writer;
+    auto stars = HipparcosFormat::toCatalogStars(HipparcosFormat::readStars(argv[1]));
+    if (!addStars(writer, stars)) {
+        std::cout << "No stars read from " << argv[1] << std::endl;
+        return 2;
+    }
+    if (!addMilkyway(writer, argv[2])
+     || !addMessier(writer, argv[3])
+     || !addConstellations(writer, argv[4])) {
+        return 2;
+    }
+    if (!writer.write(argv[5])) {
+        return 3;
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "CatalogFile.hpp"
+
+static constexpr uint64_t SECTION_ALIGN{8u};
+
+static uint64_t
+align(uint64_t offset)
+{
+    return (offset + SECTION_ALIGN - 1u) & ~(SECTION_ALIGN - 1u);
+}
+
+CatalogFile::~CatalogFile()
+{
+    unmap();
+}
+
+void
+CatalogFile::unmap()
+{
+    m_sections = std::span<const CatalogSection>();
+    m_data = nullptr;
+    if (m_mapped) {
+        g_mapped_file_unref(m_mapped);
+        m_mapped = nullptr;
+    }
+}
+
+// the header values are not trusted, the checks are written so they don't overflow
+bool
+CatalogFile::map(const std::string& fileName)
+{
+    unmap();
+    GError* err{};
+    m_mapped = g_mapped_file_new(fileName.c_str(), false, &err);
+    if (err) {
+        std::cout << "Error mapping " << fileName << " " << err->message << std::endl;
+        g_error_free(err);
+        m_mapped = nullptr;
+        return false;
+    }
+    const uint64_t size = g_mapped_file_get_length(m_mapped);
+    m_data = g_mapped_file_get_contents(m_mapped);
+    if (size < sizeof(CatalogHeader)) {
+        std::cout << "The catalog " << fileName << " is truncated!" << std::endl;
+        unmap();
+        return false;
+    }
+    auto header = reinterpret_cast<const CatalogHeader*>(m_data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+     || header->version != VERSION
+     || header->byteOrder != BYTE_ORDER_MARK) {
+        std::cout << "The catalog " << fileName << " has a unsupported format!" << std::endl;
+        unmap();
+        return false;
+    }
+    if (header->sectionCount > (size - sizeof(CatalogHeader)) / sizeof(CatalogSection)) {
+        std::cout << "The catalog " << fileName << " is truncated!" << std::endl;
+        unmap();
+        return false;
+    }
+    m_sections = std::span<const CatalogSection>(
+                    reinterpret_cast<const CatalogSection*>(m_data + sizeof(CatalogHeader))
+                    , header->sectionCount);
+    for (auto& section : m_sections) {
+        if (section.offset % SECTION_ALIGN != 0u
+         || section.recordSize == 0u
+         || section.offset > size
+         || section.count > (size - section.offset) / section.recordSize) {
+            std::cout << "The catalog " << fileName << " has a invalid section " << static_cast<uint32_t>(section.type) << "!" << std::endl;
+            unmap();
+            return false;
+        }
+    }
+    return true;
+}
+
+const CatalogSection*
+CatalogFile::findSection(CatalogSectionType type) const
+{
+    for (auto& section : m_sections) {
+        if (section.type == type) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+int16_t
+CatalogFile::quantizeMagnitude(double vmag)
+{
+    return static_cast<int16_t>(std::clamp(std::round(vmag * MAG_SCALE), -32767.0, 32767.0));
+}
+
+double
+CatalogFile::toMagnitude(int16_t vmag)
+{
+    return static_cast<double>(vmag) / MAG_SCALE;
+}
+
+bool
+CatalogWriter::write(const std::string& fileName)
+{
+    CatalogHeader header{};
+    std::memcpy(header.magic, CatalogFile::MAGIC, sizeof(CatalogFile::MAGIC));
+    header.version = CatalogFile::VERSION;
+    header.byteOrder = CatalogFile::BYTE_ORDER_MARK;
+    header.sectionCount = static_cast<uint32_t>(m_entries.size());
+    std::vector<CatalogSection> sections;
+    sections.reserve(m_entries.size());
+    uint64_t offset = align(sizeof(CatalogHeader) + m_entries.size() * sizeof(CatalogSection));
+    for (auto& entry : m_entries) {
+        CatalogSection section{};
+        section.type = entry.type;
+        section.recordSize = entry.recordSize;
+        section.count = entry.count;
+        section.offset = offset;
+        sections.push_back(section);
+        offset = align(offset + entry.data.size());
+    }
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cout << "The catalog " << fileName << " could not be created!" << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(CatalogSection));
+    uint64_t pos = sizeof(CatalogHeader) + sections.size() * sizeof(CatalogSection);
+    const char pad[SECTION_ALIGN]{};
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        out.write(pad, sections[i].offset - pos);
+        out.write(m_entries[i].data.data(), m_entries[i].data.size());
+        pos = sections[i].offset + m_entries[i].data.size();
+    }
+    out.close();
+    if (!out) {
+        std::cout << "The catalog " << fileName << " could not be written!" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,192 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <cstdint>
+#include <string>
+#include <span>
+#include <vector>
+
+/**
+ * The binary catalog is compiled at build time from the json/txt
+ *   resources (see CatalogCompiler) and mapped read-only at runtime.
+ *   Layout:
+ *     CatalogHeader
+ *     CatalogSection[sectionCount]
+ *     section data, each aligned to 8 bytes
+ *   Each section is a column of fixed size records,
+ *   positions are stored as unit vectors quantized to int16
+ *   (see UnitVectors::QUANT_SCALE), magnitudes as int16 millimag,
+ *   stars are sorted by magnitude tier, sky cell and magnitude (see StarTiles).
+ *   The values are in host byte order, the byteOrder field
+ *   allows to detect a foreign file.
+ */
+enum class CatalogSectionType : uint32_t
+{
+      StarX = 1         // int16
+    , StarY             // int16
+    , StarZ             // int16
+    , StarVmag          // int16 millimag
+    , StarNumber        // int32 hipparcos number
+    , MilkywayX         // int16
+    , MilkywayY         // int16
+    , MilkywayZ         // int16
+    , MilkywayPoly      // MilkywayPolyRecord
+    , MessierX          // int16
+    , MessierY          // int16
+    , MessierZ          // int16
+    , MessierVmag       // int16 millimag
+    , MessierName       // MessierNameRecord
+    , StarTile          // StarTileRecord, optional
+    , ConstellationX    // int16
+    , ConstellationY    // int16
+    , ConstellationZ    // int16
+    , ConstellationLine // ConstellationLineRecord
+    , ConstellationName // ConstellationNameRecord, indexed by the line group
+};
+
+struct CatalogHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t sectionCount;
+    uint32_t reserved;
+};
+
+struct CatalogSection
+{
+    CatalogSectionType type;
+    uint32_t recordSize;
+    uint64_t count;
+    uint64_t offset;    // from file start
+};
+
+struct MilkywayPolyRecord
+{
+    uint32_t first;     // index into milkyway points
+    uint32_t count;
+    int32_t intensity;
+    uint32_t reserved;
+};
+
+// a range of stars within a magnitude tier and a sky cell,
+//   the stars of a tile are sorted by magnitude
+struct StarTileRecord
+{
+    uint32_t first;     // index into stars
+    uint32_t count;
+    int16_t minVmag;    // millimag
+    int16_t maxVmag;
+    int16_t x;          // center as quantized unit vector
+    int16_t y;
+    int16_t z;
+    uint16_t radius;    // angular radius around center (see StarTiles::RADIUS_SCALE)
+};
+
+struct MessierNameRecord
+{
+    char name[8];       // zero terminated e.g. "M110"
+};
+
+struct ConstellationLineRecord
+{
+    uint32_t first;     // index into constellation points
+    uint32_t count;
+    int32_t width;
+    uint32_t group;     // index into constellation names
+};
+
+struct ConstellationNameRecord
+{
+    char name[8];       // zero terminated e.g. "UMa"
+};
+
+class CatalogFile
+{
+public:
+    CatalogFile() = default;
+    explicit CatalogFile(const CatalogFile& orig) = delete;
+    virtual ~CatalogFile();
+
+    static constexpr auto CATALOG_FILE{"catalog.bgcat"};
+    static constexpr char MAGIC[8]{'B', 'G', 'C', 'A', 'T', 0, 0, 0};
+    static constexpr uint32_t VERSION{1u};
+    static constexpr uint32_t BYTE_ORDER_MARK{0x01020304u};
+    static constexpr double MAG_SCALE{1000.0};
+
+    // returns false if the file is missing or not compatible,
+    //   a previous mapping is released
+    bool map(const std::string& fileName);
+    // an empty span if section is missing or the record size doesn't match
+    template<typename T>
+    std::span<const T> getSection(CatalogSectionType type) const
+    {
+        auto section = findSection(type);
+        if (section == nullptr
+         || section->recordSize != sizeof(T)) {
+            return std::span<const T>();
+        }
+        return std::span<const T>(reinterpret_cast<const T*>(m_data + section->offset), section->count);
+    }
+
+    static int16_t quantizeMagnitude(double vmag);
+    static double toMagnitude(int16_t vmag);
+
+private:
+    const CatalogSection* findSection(CatalogSectionType type) const;
+    void unmap();
+
+    GMappedFile* m_mapped{};
+    const char* m_data{};
+    std::span<const CatalogSection> m_sections;
+};
+
+// used to create the catalog, values are copied
+class CatalogWriter
+{
+public:
+    CatalogWriter() = default;
+    explicit CatalogWriter(const CatalogWriter& orig) = delete;
+    virtual ~CatalogWriter() = default;
+
+    template<typename T>
+    void add(CatalogSectionType type, std::span<const T> records)
+    {
+        Entry entry;
+        entry.type = type;
+        entry.recordSize = sizeof(T);
+        entry.count = records.size();
+        auto bytes = reinterpret_cast<const char*>(records.data());
+        entry.data.assign(bytes, bytes + records.size_bytes());
+        m_entries.emplace_back(std::move(entry));
+    }
+    bool write(const std::string& fileName);
+
+private:
+    struct Entry
+    {
+        CatalogSectionType type;
+        uint32_t recordSize;
+        uint64_t count;
+        std::vector<char> data;
+    };
+    std::vector<Entry> m_entries;
+};
@@ -27,17 +27,16 @@
 #include "Math.hpp"
 #include "FileLoader.hpp"
 #include "background_config.h"
+#include "Compositor.hpp"
 
 
 Glib::RefPtr<Pango::Layout>
-ClockModule::createLayout(const Cairo::RefPtr<Cairo::Context>& ctx)
+ClockModule::createLayout(const Cairo::RefPtr<Cairo::Context>& ctx, const Pango::FontDescription& font, const Glib::ustring& fmt)
 {
-    auto fmt = getEffectiveFormat();
     Glib::DateTime dateTime = Glib::DateTime::create_now_local();
-    auto clockFont = getFont();
     auto pangoLayout = Pango::Layout::create(ctx);
     pangoLayout->set_line_spacing(1.2f);    // move lines out of center
-    pangoLayout->set_font_description(clockFont);
+    pangoLayout->set_font_description(font);
     pangoLayout->set_text(dateTime.format(fmt));
     return pangoLayout;
 }
@@ -73,7 +72,7 @@ ClockModule::getHeight(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWi
         analogHeight = static_cast<int>(getRadius() * 2.0);
     }
     if (isDisplayDigital()) {
-        auto pangoLayout = createLayout(ctx);
+        auto pangoLayout = createLayout(ctx, getFont(), getEffectiveFormat());
         int width;
         pangoLayout->get_pixel_size(width, digitalHeight);
     }
@@ -182,14 +181,14 @@ ClockModule::drawHand(const Cairo::RefPtr<Cairo::Context>& ctx, int value, int f
 // this was kept for reference the drawing was migrated
 //    to python to allow more flexibility
 void
-ClockModule::displayAnalog(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin)
+ClockModule::displayAnalog(const Cairo::RefPtr<Cairo::Context>& ctx, double radius)
 {
     ctx->save();
-    ctx->translate(getRadius(), getRadius());
+    ctx->translate(radius, radius);
     ctx->set_line_cap(Cairo::LineCap::LINE_CAP_BUTT);
     ctx->begin_new_path();  // as we get a strange stoke otherwise
     ctx->set_line_width(1.0);
-    ctx->arc(0.0, 0.0, getRadius(), 0.0, Math::TWO_PI);
+    ctx->arc(0.0, 0.0, radius, 0.0, Math::TWO_PI);
     ctx->stroke();
 	//const double inner5 = m_radius * MINUTE_TICK_FACTOR;
     //ctx->arc(0.0, 0.0, inner5, 0.0, Math::TWO_PI);
@@ -197,10 +196,10 @@ ClockModule::displayAnalog(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* st
 
     Glib::DateTime dateTime = Glib::DateTime::create_now_local();
     int hourM = (dateTime.get_hour() % 12) * 60 + dateTime.get_minute();
-    drawHand(ctx, hourM, 12 * 60, getRadius() * 0.6, 2.0);
-    drawHand(ctx, dateTime.get_minute(), 60, getRadius() * 0.8, 1.0);
+    drawHand(ctx, hourM, 12 * 60, radius * 0.6, 2.0);
+    drawHand(ctx, dateTime.get_minute(), 60, radius * 0.8, 1.0);
 	for (int i = 0; i < 60; ++i) {
-        drawRadialLine(ctx, i, 60, (i % 5) == 0, getRadius());
+        drawRadialLine(ctx, i, 60, (i % 5) == 0, radius);
 	}
     ctx->restore();
 }
@@ -217,16 +216,16 @@ ClockModule::getEffectiveFormat()
 }
 
 void
-ClockModule::displayDigital(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin, bool center)
+ClockModule::displayDigital(const Cairo::RefPtr<Cairo::Context>& ctx, const Pango::FontDescription& font, const Glib::ustring& fmt, double radius)
 {
-    auto pangoLayout = createLayout(ctx);
-    if (!center) {
+    auto pangoLayout = createLayout(ctx, font, fmt);
+    if (radius <= 0.0) {
         ctx->move_to(0.0, 0.0);
     }
     else {
         int width, height;
         pangoLayout->get_pixel_size(width, height);
-        ctx->move_to(getRadius() - width / 2.0, getRadius() - height / 2.0);
+        ctx->move_to(radius - width / 2.0, radius - height / 2.0);
     }
     pangoLayout->show_in_cairo_context(ctx);
 }
@@ -237,44 +236,85 @@ ClockModule::getPyScriptName()
     return "clock.py";
 }
 
-void
-ClockModule::display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin)
+// changes with the displayed time, so the clock is redrawn each minute
+//   (or with the digital format)
+// the height depends on the kind of display, not on the time
+size_t
+ClockModule::getLayoutKey(StarWin* starWin)
 {
-    getPrimaryColor(ctx);
-#   ifdef USE_PYTHON
-    auto pyClass = checkPyClass(starWin, pyClassName);
-    if (!pyClass) {
-        std::cout << "ClockModule::display no Class!" << std::endl;
-        return;
+    size_t key = Module::getLayoutKey(starWin);
+    key = Compositor::combine(key, std::hash<std::string>{}(getFormat().raw()));
+    key = Compositor::combine(key, std::hash<double>{}(getRadius()));
+    key = Compositor::combine(key, (isDisplayAnalog() ? 1u : 0u) | (isDisplayDigital() ? 2u : 0u));
+    return key;
+}
+
+size_t
+ClockModule::getContentKey(StarWin* starWin)
+{
+    Glib::DateTime dateTime = Glib::DateTime::create_now_local();
+    size_t key = std::hash<int>{}(dateTime.get_hour() * 60 + dateTime.get_minute());
+    if (isDisplayDigital()) {
+        key = Compositor::combine(key, std::hash<std::string>{}(dateTime.format(getEffectiveFormat()).raw()));
     }
+    return key == Compositor::UNCACHED ? 1u : key;
+}
+
+// the minute, updating the background for the seconds is too much
+uint32_t
+ClockModule::getUpdateSeconds()
+{
+    return 60u;
+}
+
+Module::DisplayFunc
+ClockModule::prepareDisplay(StarWin* starWin)
+{
+    std::shared_ptr<PyClass> pyClass;
+#   ifdef USE_PYTHON
+    pyClass = checkPyClass(starWin, pyClassName);
 #   endif
-    if (isDisplayAnalog()) {
-        getPrimaryColor(ctx);   // set the here so we don't have to pass this
-        ctx->begin_new_path();  // as we get a strange stoke otherwise
+    return [pyClass
+          , color = getPrimaryColor()
+          , font = getFont()
+          , fmt = getEffectiveFormat()
+          , radius = getRadius()
+          , analog = isDisplayAnalog()
+          , digital = isDisplayDigital()] (const Cairo::RefPtr<Cairo::Context>& ctx) {
+        std::string error;
+        setSource(ctx, color);
 #       ifdef USE_PYTHON
-        pyClass->invokeMethod("drawAnalog", ctx, getRadius());
-        if (pyClass->hasFailed()) {
-            starWin->showMessage(pyClass->getError(), Gtk::MessageType::MESSAGE_ERROR);
+        if (!pyClass) {
+            std::cout << "ClockModule::display no Class!" << std::endl;
+            return error;
         }
-#       else
-        displayAnalog(ctx, starDraw);
 #       endif
-    }
-    if (isDisplayDigital()) {
-        auto color = getPrimaryColor();
-        ctx->set_source_rgba(color.get_red(), color.get_green(), color.get_blue(), isDisplayAnalog() ? 0.6 : 1.0);
-#       ifdef USE_PYTHON
-        auto fmt = getEffectiveFormat();
-        auto clockFont = getFont();
-        auto fontName= clockFont.to_string();
-        pyClass->invokeMethod("drawDigital", ctx, fontName, fmt, isDisplayAnalog() ? getRadius() : 0.0);
-        if (pyClass->hasFailed()) {
-            starWin->showMessage(pyClass->getError(), Gtk::MessageType::MESSAGE_ERROR);
+        if (analog) {
+            setSource(ctx, color);  // set the here so we don't have to pass this
+            ctx->begin_new_path();  // as we get a strange stoke otherwise
+#           ifdef USE_PYTHON
+            pyClass->invokeMethod("drawAnalog", ctx, radius);
+            if (pyClass->hasFailed()) {
+                error = pyClass->getError();
+            }
+#           else
+            displayAnalog(ctx, radius);
+#           endif
         }
-#       else
-        displayDigital(ctx, starDraw, isDisplayAnalog());
-#       endif
-    }
+        if (digital) {
+            setSource(ctx, color, analog ? 0.6 : 1.0);
+#           ifdef USE_PYTHON
+            auto fontName = font.to_string();
+            pyClass->invokeMethod("drawDigital", ctx, fontName, fmt, analog ? radius : 0.0);
+            if (pyClass->hasFailed()) {
+                error = pyClass->getError();
+            }
+#           else
+            displayDigital(ctx, font, fmt, analog ? radius : 0.0);
+#           endif
+        }
+        return error;
+    };
 }
 
 void
@@ -286,6 +326,7 @@ ClockModule::setupParam(const Glib::RefPtr<Gtk::Builder>& builder, StarWin* star
     builder->get_widget("clockRadius", m_clockRadius);
     m_clockRadius->set_value(getRadius());
     m_clockRadius->signal_value_changed().connect([this,starWin] {
+        auto lock = starWin->lockPaint();
         setRadius(m_clockRadius->get_value());
         starWin->update();
     });
@@ -293,6 +334,7 @@ ClockModule::setupParam(const Glib::RefPtr<Gtk::Builder>& builder, StarWin* star
     builder->get_widget("clockFormat", m_clockFormat);
     m_clockFormat->set_text(getFormat());
     m_clockFormat->signal_changed().connect([this,starWin] {
+        auto lock = starWin->lockPaint();
         setFormat(m_clockFormat->get_text());
         starWin->update();
     });
@@ -302,11 +344,13 @@ ClockModule::setupParam(const Glib::RefPtr<Gtk::Builder>& builder, StarWin* star
     m_displayAnalog->set_active(isDisplayAnalog());
     m_displayDigital->set_active(isDisplayDigital());
     m_displayAnalog->signal_clicked().connect([this,starWin] {
+        auto lock = starWin->lockPaint();
         update();
         setDisplayAnalog(m_displayAnalog->get_active());
         starWin->update();
     });
     m_displayDigital->signal_clicked().connect([this,starWin] {
+        auto lock = starWin->lockPaint();
         update();
         setDisplayDigital(m_displayDigital->get_active());
         starWin->update();
@@ -34,7 +34,10 @@ public:
     virtual ~ClockModule() = default;
 
     int getHeight(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin) override;
-    void display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin) override;
+    DisplayFunc prepareDisplay(StarWin* starWin) override;
+    size_t getLayoutKey(StarWin* starWin) override;
+    size_t getContentKey(StarWin* starWin) override;
+    uint32_t getUpdateSeconds() override;
     void setupParam(const Glib::RefPtr<Gtk::Builder>& builder, StarWin* starWin) override;
     void saveParam(bool save) override;
     static constexpr auto RADIUS_KEY{"radius"};
@@ -53,11 +56,12 @@ public:
     static constexpr auto pyClassName{"Clock"};
 protected:
     void update();
-    void drawRadialLine(const Cairo::RefPtr<Cairo::Context>& ctx, int value, int full, bool emphasis, double outer);
-    void drawHand(const Cairo::RefPtr<Cairo::Context>& ctx, int value, int full, double outer, double width);
-    void displayAnalog(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin);
-    void displayDigital(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin, bool center);
-    Glib::RefPtr<Pango::Layout> createLayout(const Cairo::RefPtr<Cairo::Context>& ctx);
+    static void drawRadialLine(const Cairo::RefPtr<Cairo::Context>& ctx, int value, int full, bool emphasis, double outer);
+    static void drawHand(const Cairo::RefPtr<Cairo::Context>& ctx, int value, int full, double outer, double width);
+    static void displayAnalog(const Cairo::RefPtr<Cairo::Context>& ctx, double radius);
+    // centered in the analog clock of radius if > 0
+    static void displayDigital(const Cairo::RefPtr<Cairo::Context>& ctx, const Pango::FontDescription& font, const Glib::ustring& fmt, double radius);
+    static Glib::RefPtr<Pango::Layout> createLayout(const Cairo::RefPtr<Cairo::Context>& ctx, const Pango::FontDescription& font, const Glib::ustring& fmt);
 
     Glib::ustring getEffectiveFormat();
     void installFont(StarWin* starDraw);
@@ -0,0 +1,205 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Compositor.hpp"
+
+void
+Compositor::begin(int width, int height)
+{
+    if (width != m_width
+     || height != m_height) {
+        m_layers.clear();
+        m_width = width;
+        m_height = height;
+    }
+    for (auto& entry : m_layers) {
+        entry.second.used = false;
+    }
+    m_drawn = 0u;
+    m_cached = 0u;
+}
+
+void
+Compositor::paint(const Cairo::RefPtr<Cairo::Context>& ctx, const std::string& name, size_t key
+                , double x, double y, int width, int height, const DrawFunc& draw)
+{
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    auto& layer = m_layers[name];
+    layer.used = true;
+    bool prepared{false};   // a uncached layer may also be drawn ahead for this image
+    if (layer.prepared
+     && key == layer.preparedKey
+     && layer.prepared->get_width() == width
+     && layer.prepared->get_height() == height) {
+        layer.surface = std::move(layer.prepared);
+        layer.key = key;
+        prepared = true;
+    }
+    layer.prepared.clear();
+    if (!layer.surface
+     || layer.surface->get_width() != width
+     || layer.surface->get_height() != height) {
+        layer.surface = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, width, height);
+        layer.key = UNCACHED;
+    }
+    if (!prepared
+     && (key == UNCACHED
+      || key != layer.key)) {
+        auto layerCtx = Cairo::Context::create(layer.surface);
+        layerCtx->save();
+        layerCtx->set_operator(Cairo::Operator::OPERATOR_CLEAR);
+        layerCtx->paint();
+        layerCtx->restore();
+        draw(layerCtx);
+        layer.surface->flush();
+        layer.key = key;
+        ++m_drawn;
+        ++m_stats[name].misses;
+    }
+    else {
+        ++m_cached;
+        ++m_stats[name].hits;
+    }
+    ctx->save();
+    ctx->set_source(layer.surface, x, y);
+    ctx->paint();
+    ctx->restore();
+}
+
+void
+Compositor::prepare(const std::string& name, size_t key, Cairo::RefPtr<Cairo::ImageSurface>&& surface)
+{
+    auto& layer = m_layers[name];
+    layer.prepared = std::move(surface);
+    layer.preparedKey = key;
+}
+
+bool
+Compositor::isCurrent(const std::string& name, size_t key, int width, int height) const
+{
+    auto entry = m_layers.find(name);
+    if (entry == m_layers.end()) {
+        return false;
+    }
+    const auto& layer = entry->second;
+    if (layer.prepared
+     && key == layer.preparedKey
+     && layer.prepared->get_width() == width
+     && layer.prepared->get_height() == height) {
+        return true;
+    }
+    return key != UNCACHED
+        && layer.surface
+        && key == layer.key
+        && layer.surface->get_width() == width
+        && layer.surface->get_height() == height;
+}
+
+bool
+Compositor::paintLast(const Cairo::RefPtr<Cairo::Context>& ctx, const std::string& name, double x, double y)
+{
+    auto entry = m_layers.find(name);
+    if (entry == m_layers.end()
+     || (!entry->second.surface && !entry->second.prepared)) {
+        return false;
+    }
+    auto& layer = entry->second;
+    layer.used = true;
+    if (layer.prepared) {   // e.g. finished late for a previous image
+        layer.surface = std::move(layer.prepared);
+        layer.key = layer.preparedKey;
+    }
+    ++m_cached;
+    ++m_stats[name].hits;
+    ctx->save();
+    ctx->set_source(layer.surface, x, y);
+    ctx->paint();
+    ctx->restore();
+    return true;
+}
+
+bool
+Compositor::hasLayer(const std::string& name) const
+{
+    auto entry = m_layers.find(name);
+    return entry != m_layers.end()
+        && (entry->second.surface || entry->second.prepared);
+}
+
+bool
+Compositor::hasPrepared(const std::string& name) const
+{
+    auto entry = m_layers.find(name);
+    return entry != m_layers.end()
+        && entry->second.prepared;
+}
+
+void
+Compositor::end()
+{
+    for (auto iter = m_layers.begin(); iter != m_layers.end(); ) {
+        if (!iter->second.used) {
+            iter = m_layers.erase(iter);
+        }
+        else {
+            ++iter;
+        }
+    }
+}
+
+void
+Compositor::invalidate()
+{
+    for (auto& entry : m_layers) {
+        entry.second.key = UNCACHED;
+    }
+}
+
+uint32_t
+Compositor::getDrawn() const
+{
+    return m_drawn;
+}
+
+uint32_t
+Compositor::getCached() const
+{
+    return m_cached;
+}
+
+uint64_t
+Compositor::getHits(const std::string& name) const
+{
+    auto entry = m_stats.find(name);
+    return entry != m_stats.end() ? entry->second.hits : 0u;
+}
+
+uint64_t
+Compositor::getMisses(const std::string& name) const
+{
+    auto entry = m_stats.find(name);
+    return entry != m_stats.end() ? entry->second.misses : 0u;
+}
+
+size_t
+Compositor::combine(size_t seed, size_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
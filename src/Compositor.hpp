@@ -0,0 +1,91 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtkmm.h>
+#include <functional>
+#include <map>
+#include <string>
+
+/**
+ * keeps the layers of an image (sky, modules) as surfaces,
+ *   a layer is only redrawn if its key changed,
+ *   otherwise the cached surface gets painted.
+ */
+class Compositor
+{
+public:
+    using DrawFunc = std::function<void(const Cairo::RefPtr<Cairo::Context>& ctx)>;
+
+    Compositor() = default;
+    explicit Compositor(const Compositor& orig) = delete;
+    virtual ~Compositor() = default;
+
+    static constexpr size_t UNCACHED{0u};   // a layer with this key is drawn each time
+
+    // start an image, a changed size invalidates all layers
+    void begin(int width, int height);
+    // paint the layer at x,y onto ctx, draw is only called if the key changed
+    void paint(const Cairo::RefPtr<Cairo::Context>& ctx, const std::string& name, size_t key
+             , double x, double y, int width, int height, const DrawFunc& draw);
+    // offer a layer that was drawn ahead,
+    //   the next paint with the key uses it instead of drawing
+    void prepare(const std::string& name, size_t key, Cairo::RefPtr<Cairo::ImageSurface>&& surface);
+    // true if a paint with the key and size would not draw
+    bool isCurrent(const std::string& name, size_t key, int width, int height) const;
+    // paint the newest surface the layer has (a prepared before the last), regardless of the key,
+    //   false if there is none
+    bool paintLast(const Cairo::RefPtr<Cairo::Context>& ctx, const std::string& name, double x, double y);
+    // true if paintLast has a surface to paint
+    bool hasLayer(const std::string& name) const;
+    bool hasPrepared(const std::string& name) const;
+    // layers not painted since begin are released
+    void end();
+    // redraw all layers on next use e.g. after a config change
+    void invalidate();
+    // counts of the last image
+    uint32_t getDrawn() const;
+    uint32_t getCached() const;
+    // counts of a layer since start, a hit used the cached surface
+    uint64_t getHits(const std::string& name) const;
+    uint64_t getMisses(const std::string& name) const;
+
+    static size_t combine(size_t seed, size_t value);
+
+private:
+    struct Layer
+    {
+        Cairo::RefPtr<Cairo::ImageSurface> surface;
+        size_t key{UNCACHED};
+        bool used{false};
+        Cairo::RefPtr<Cairo::ImageSurface> prepared;
+        size_t preparedKey{UNCACHED};
+    };
+    struct Stats
+    {
+        uint64_t hits{};
+        uint64_t misses{};
+    };
+    std::map<std::string, Layer> m_layers;
+    std::map<std::string, Stats> m_stats;  // kept if the layers are released
+    int m_width{};
+    int m_height{};
+    uint32_t m_drawn{};
+    uint32_t m_cached{};
+};
@@ -32,7 +32,7 @@ Constellation::getName()
 }
 
 void
-Constellation::addPosition(const std::shared_ptr<RaDec>& raDec, int width)
+Constellation::addPosition(const RaDec& raDec, int width)
 {
 	std::shared_ptr<psc::geom::Polyline> polyline;
 	if (m_lines.empty()
@@ -46,8 +46,15 @@ Constellation::addPosition(const std::shared_ptr<RaDec>& raDec, int width)
 	polyline->add(raDec);
 }
 
-const std::list<std::shared_ptr<psc::geom::Polyline>>
-Constellation::getPolylines()
+std::span<const std::shared_ptr<psc::geom::Polyline>>
+Constellation::getPolylines() const
 {
-	return m_lines;     // c++ equivalent to Collections.unmodifiable ?
+	return m_lines;     // view, valid as long as no position is added
+}
+
+void
+Constellation::clearPolylines()
+{
+    m_lines.clear();
+    m_lines.shrink_to_fit();
 }
@@ -19,7 +19,8 @@
 #pragma once
 
 #include <string>
-#include <list>
+#include <vector>
+#include <span>
 #include <memory>
 
 #include "RaDec.hpp"
@@ -33,11 +34,13 @@ public:
     virtual ~Constellation() = default;
 
     std::string getName();
-    void addPosition(const std::shared_ptr<RaDec>& raDec, int width);
-    const std::list<std::shared_ptr<psc::geom::Polyline>> getPolylines();
+    void addPosition(const RaDec& raDec, int width);
+    std::span<const std::shared_ptr<psc::geom::Polyline>> getPolylines() const;
+    // the lines are no longer needed e.g. as they were added to a PolylineStore
+    void clearPolylines();
 
 private:
     std::string m_name;
-    std::list<std::shared_ptr<psc::geom::Polyline>> m_lines;
+    std::vector<std::shared_ptr<psc::geom::Polyline>> m_lines;
 };
 
@@ -17,10 +17,12 @@
  */
 
 #include <iostream>
+#include <cstring>
 #include <StringUtils.hpp>
 
 #include "ConstellationFormat.hpp"
 #include "FileLoader.hpp"
+#include "CatalogFile.hpp"
 
 ConstellationFormat::ConstellationFormat(const std::shared_ptr<FileLoader>& fileLoader)
 : m_fileLoader{fileLoader}
@@ -55,9 +57,9 @@ ConstellationFormat::parseLine(const std::string& line, std::map<std::string, st
 	    auto cons = line.substr(29);
         auto dRa = StringUtils::parseCDouble(ra);
         auto dDec = StringUtils::parseCDouble(pol);
-	    auto raDec = std::make_shared<RaDec>();
-	    raDec->setRaHours(dRa);
-	    raDec->setDecDegreesPolar(dDec);
+	    RaDec raDec;
+	    raDec.setRaHours(dRa);
+	    raDec.setDecDegreesPolar(dDec);
 	    auto constlIter = constellations.find(cons);
         std::shared_ptr<Constellation> constl;
 	    if (constlIter == constellations.end()) {
@@ -76,40 +78,113 @@ ConstellationFormat::parseLine(const std::string& line, std::map<std::string, st
     }
 }
 
-std::list<std::shared_ptr<Constellation>>
+std::span<const std::shared_ptr<Constellation>>
 ConstellationFormat::getConstellations()
 {
     if (m_list.empty()) {
-        m_list = readConstellations();
+        if (!loadCatalog()) {
+            auto file = m_fileLoader->findFile(constlDataFile);
+            if (file) {
+                m_list = readConstellations(file);
+            }
+            else {
+                std::cout << "The constellation data " << constlDataFile << " was not found!" << std::endl;
+            }
+            uint32_t group{};
+            for (auto& constl : m_list) {
+                for (auto& line : constl->getPolylines()) {
+                    m_store.add(line->getUnitVectors(), line->getWidth(), group);
+                }
+                constl->clearPolylines();     // the store keeps the only copy
+                ++group;
+            }
+        }
+        const auto& vertices = m_store.getVertices();
+        for (uint32_t item = 0; item < m_store.size(); ++item) {
+            const auto& line = m_store.getLine(item);
+            m_index.add(item, vertices, line.first, line.count);
+        }
         //std::cout << "ConstellationFormat::getConstellations loaded " << m_list.size() << std::endl;
     }
     return m_list;
 }
 
-std::list<std::shared_ptr<Constellation>>
-ConstellationFormat::readConstellations()
+const PolylineStore&
+ConstellationFormat::getStore()
+{
+    getConstellations();
+    return m_store;
+}
+
+const SkyIndex&
+ConstellationFormat::getIndex()
+{
+    getConstellations();
+    return m_index;
+}
+
+// use the compiled catalog if available
+bool
+ConstellationFormat::loadCatalog()
+{
+    auto file = m_fileLoader->find(CatalogFile::CATALOG_FILE);
+    if (file.empty()) {
+        return false;
+    }
+    auto catalog = std::make_shared<CatalogFile>();
+    if (!catalog->map(file)) {
+        return false;
+    }
+    auto x = catalog->getSection<int16_t>(CatalogSectionType::ConstellationX);
+    auto y = catalog->getSection<int16_t>(CatalogSectionType::ConstellationY);
+    auto z = catalog->getSection<int16_t>(CatalogSectionType::ConstellationZ);
+    auto lines = catalog->getSection<ConstellationLineRecord>(CatalogSectionType::ConstellationLine);
+    auto names = catalog->getSection<ConstellationNameRecord>(CatalogSectionType::ConstellationName);
+    if (lines.empty()
+     || names.empty()
+     || y.size() != x.size()
+     || z.size() != x.size()) {
+        std::cout << "The catalog " << file << " has no usable constellation data!" << std::endl;
+        return false;
+    }
+    std::vector<PolylineInfo> infos;
+    infos.reserve(lines.size());
+    for (auto& rec : lines) {
+        if (static_cast<size_t>(rec.first) + rec.count > x.size()
+         || rec.group >= names.size()) {
+            std::cout << "The catalog " << file << " has a invalid constellation line!" << std::endl;
+            return false;
+        }
+        infos.push_back(PolylineInfo{rec.first, rec.count, rec.width, rec.group});
+    }
+    m_list.reserve(names.size());
+    for (auto& rec : names) {
+        m_list.push_back(std::make_shared<Constellation>(std::string(rec.name, strnlen(rec.name, sizeof(rec.name)))));
+    }
+    m_store.setQuantized(x, y, z, std::move(infos));
+    m_catalog = catalog;    // keep mapping
+    return true;
+}
+
+std::vector<std::shared_ptr<Constellation>>
+ConstellationFormat::readConstellations(const Glib::RefPtr<Gio::File>& file)
 {
 	std::map<std::string, std::shared_ptr<Constellation>> constellations;
 	try {
-        auto file = m_fileLoader->findFile(constlDataFile);
-        if (file) {
-            LineReader lineReader(file);
-            std::string line;
-            line.reserve(80);
-            while (lineReader.hasNext()) {
-                lineReader.next(line);
-                parseLine(line, constellations);
-            }
+        LineReader lineReader(file);
+        std::string line;
+        line.reserve(80);
+        while (lineReader.hasNext()) {
+            lineReader.next(line);
+            parseLine(line, constellations);
         }
-	    else {
-            std::cout << "The constellation data " << constlDataFile << " was not found!" << std::endl;
-	    }
 	}
 	catch (const Gio::Error& exc) {
-	    std::cout << "Error " << exc.what() << " reading constellations " << constlDataFile << "!" << std::endl;
+	    std::cout << "Error " << exc.what() << " reading constellations " << file->get_path() << "!" << std::endl;
 	}
-    std::list<std::shared_ptr<Constellation>> list;
-    for (auto pair : constellations) {
+    std::vector<std::shared_ptr<Constellation>> list;
+    list.reserve(constellations.size());
+    for (auto& pair : constellations) {
         list.push_back(pair.second);
     }
 	return list;
@@ -21,11 +21,16 @@
 #include <gtkmm.h>
 #include <string>
 #include <memory>
+#include <vector>
+#include <span>
 
 #include "Constellation.hpp"
 #include "RaDec.hpp"
+#include "SkyIndex.hpp"
+#include "PolylineStore.hpp"
 
 class FileLoader;
+class CatalogFile;
 
 class ConstellationFormat
 {
@@ -34,12 +39,24 @@ public:
     explicit ConstellationFormat(const ConstellationFormat& orig) = delete;
     virtual ~ConstellationFormat() = default;
 
-    std::list<std::shared_ptr<Constellation>> getConstellations();
+    // the constellations only have the name (the lines are in the store)
+    std::span<const std::shared_ptr<Constellation>> getConstellations();
+    // the polylines of all constellations, the value is the width
+    //   and the group the index of getConstellations
+    const PolylineStore& getStore();
+    // the items are the polylines of the store
+    const SkyIndex& getIndex();
+    // read the text format, used for the catalog compiler
+    static std::vector<std::shared_ptr<Constellation>> readConstellations(const Glib::RefPtr<Gio::File>& file);
+protected:
+    bool loadCatalog();
 private:
     static constexpr auto constlDataFile = "SnT_constellation.txt";
     const std::shared_ptr<FileLoader> m_fileLoader;
-    std::list<std::shared_ptr<Constellation>> m_list;
-    std::list<std::shared_ptr<Constellation>> readConstellations();
-    void parseLine(const std::string& line, std::map<std::string, std::shared_ptr<Constellation>>& constellations);
+    std::vector<std::shared_ptr<Constellation>> m_list;
+    PolylineStore m_store;
+    SkyIndex m_index;
+    std::shared_ptr<CatalogFile> m_catalog;     // keeps the mapping used by the store
+    static void parseLine(const std::string& line, std::map<std::string, std::shared_ptr<Constellation>>& constellations);
 };
 
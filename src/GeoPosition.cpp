@@ -70,18 +70,21 @@ GeoPosition::getLatRad() const
 std::shared_ptr<AzimutAltitude>
 GeoPosition::toAzimutAltitude(const std::shared_ptr<RaDec>& raDec, const JulianDate& jd) const
 {
-    double lonRad = getLonRad();
+    return std::make_shared<AzimutAltitude>(toAzimutAltitude(*raDec, jd));
+}
+
+AzimutAltitude
+GeoPosition::toAzimutAltitude(const RaDec& raDec, const JulianDate& jd) const
+{
     double latRad = getLatRad();
-    double raRad = raDec->getRaRad();
-    double decRad = raDec->getDecRad();
+    double raRad = raDec.getRaRad();
+    double decRad = raDec.getDecRad();
     //Meeus 13.5 and 13.6, modified so West longitudes are negative and 0 is North
     //System.out.format("jd %.3f\n", jd);
-    const double gmst = greenwichMeanSiderealTime(jd);
-    //System.out.format("gmst %.3f\n", gmst);
-    double localSiderealTime = std::fmod((gmst + lonRad), (Math::TWO_PI));
+    const double lst = localSiderealTime(jd);
     //System.out.format("localSiderealTime %.3f\n", localSiderealTime);
 
-    double H = (localSiderealTime - raRad);
+    double H = (lst - raRad);
     //System.out.format("H %.3f\n", H);
     if (H < 0.0) {
         H += Math::TWO_PI;
@@ -98,7 +101,15 @@ GeoPosition::toAzimutAltitude(const std::shared_ptr<RaDec>& raDec, const JulianD
     if (az < 0.0) {
         az += Math::TWO_PI;
     }
-    return std::make_shared<AzimutAltitude>(az, a);
+    return AzimutAltitude(az, a);
+}
+
+double
+GeoPosition::localSiderealTime(const JulianDate& jd) const
+{
+    const double gmst = greenwichMeanSiderealTime(jd);
+    //System.out.format("gmst %.3f\n", gmst);
+    return std::fmod((gmst + getLonRad()), (Math::TWO_PI));
 }
 
 double
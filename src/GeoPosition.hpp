@@ -43,7 +43,10 @@ public:
     //Greg Miller (gmiller@gregmiller.net) 2021
     //Released as public domain
     //http://www.celestialprogramming.com/
+    AzimutAltitude toAzimutAltitude(const RaDec& raDec, const JulianDate& jd) const;
+    // compatibility, allocates
     std::shared_ptr<AzimutAltitude> toAzimutAltitude(const std::shared_ptr<RaDec>& raDec, const JulianDate& jd) const;
+    double localSiderealTime(const JulianDate& jd) const;
 
 
 private:
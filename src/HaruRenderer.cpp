@@ -355,6 +355,42 @@ HaruRenderer::dot(double x, double y, double r)
     m_page->fill();
 }
 
+// the circles are collected into one pdf path
+void
+HaruRenderer::dots(std::span<const double> x, std::span<const double> y, std::span<const double> r)
+{
+#   ifdef DEBUG
+    std::cout << "HaruRenderer::dots " << x.size() << std::endl;
+#   endif
+    if (x.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+        m_page->circle(toX(x[i]), toY(y[i]), toFloat(r[i] * 0.75));
+    }
+    m_page->fill();
+}
+
+void
+HaruRenderer::polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets)
+{
+#   ifdef DEBUG
+    std::cout << "HaruRenderer::polylines " << offsets.size() << std::endl;
+#   endif
+    for (size_t l = 0; l < offsets.size(); ++l) {
+        const size_t end = l + 1 < offsets.size() ? offsets[l + 1] : x.size();
+        for (size_t i = offsets[l]; i < end; ++i) {
+            if (i == offsets[l]) {
+                moveTo(x[i], y[i]);
+            }
+            else {
+                lineTo(x[i], y[i]);
+            }
+        }
+    }
+    stroke();
+}
+
 void
 HaruRenderer::diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop)
 {
@@ -97,6 +97,8 @@ public:
     void dot(double x, double y, double r) override;
     void diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop) override;
     void showPhase(Phase phase, double x, double y, double radius) override;
+    void dots(std::span<const double> x, std::span<const double> y, std::span<const double> r) override;
+    void polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets) override;
 
     void save(const Glib::ustring& file);
     Layout getLayout();
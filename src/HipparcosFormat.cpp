@@ -22,31 +22,148 @@
 #include "HipparcosFormat.hpp"
 #include "Math.hpp"
 #include "FileLoader.hpp"
+#include "CatalogFile.hpp"
+#include "StarTiles.hpp"
 
 HipparcosFormat::HipparcosFormat(const std::shared_ptr<FileLoader>& fileLoader)
 : m_fileLoader{fileLoader}
 {
 }
 
-std::vector<std::shared_ptr<Star>>
+// use the compiled catalog if available
+bool
+HipparcosFormat::loadCatalog(const std::string& file)
+{
+    auto catalog = std::make_shared<CatalogFile>();
+    if (!catalog->map(file)) {
+        return false;
+    }
+    auto x = catalog->getSection<int16_t>(CatalogSectionType::StarX);
+    auto y = catalog->getSection<int16_t>(CatalogSectionType::StarY);
+    auto z = catalog->getSection<int16_t>(CatalogSectionType::StarZ);
+    auto vmag = catalog->getSection<int16_t>(CatalogSectionType::StarVmag);
+    auto numbers = catalog->getSection<int32_t>(CatalogSectionType::StarNumber);
+    auto tiles = catalog->getSection<StarTileRecord>(CatalogSectionType::StarTile);
+    if (x.empty()
+     || y.size() != x.size()
+     || z.size() != x.size()
+     || vmag.size() != x.size()
+     || numbers.size() != x.size()) {
+        std::cout << "The catalog " << file << " has no usable star data!" << std::endl;
+        return false;
+    }
+    for (auto& tile : tiles) {
+        if (static_cast<size_t>(tile.first) + tile.count > x.size()) {
+            std::cout << "The catalog " << file << " has a invalid star tile!" << std::endl;
+            return false;
+        }
+    }
+    if (tiles.empty()) {
+        m_tileStore.push_back(StarTiles::all(static_cast<uint32_t>(x.size())));
+        tiles = m_tileStore;
+    }
+    m_vectors.setQuantized(x, y, z);
+    m_vmag = vmag;
+    m_numbers = numbers;
+    m_tiles = tiles;
+    m_catalog = catalog;    // keep mapping
+    std::cout << "Stars " << x.size() << " tiles " << m_tiles.size() << " from " << file << std::endl;
+    return true;
+}
+
+void
+HipparcosFormat::load()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+    // prefer a user supplied catalog e.g. with full hipparcos/tycho-2 see CatalogCompiler
+    auto local = m_fileLoader->getLocalDir()->get_child(LOCAL_STARS_FILE);
+    if (local->query_exists()
+     && loadCatalog(local->get_path())) {
+        return;
+    }
+    auto file = m_fileLoader->find(CatalogFile::CATALOG_FILE);
+    if (!file.empty()
+     && loadCatalog(file)) {
+        return;
+    }
+    file = m_fileLoader->find(starsDataFile);
+    if (!file.empty()) {
+        auto stars = toCatalogStars(readStars(file));
+        m_tileStore = StarTiles::build(stars);
+        m_vectors.reserve(stars.size());
+        m_vmagStore.reserve(stars.size());
+        m_numberStore.reserve(stars.size());
+        for (auto& star : stars) {
+            m_vectors.add(star.ra, star.dec);
+            m_vmagStore.push_back(CatalogFile::quantizeMagnitude(star.vmag));
+            m_numberStore.push_back(star.number);
+        }
+        m_vmag = m_vmagStore;
+        m_numbers = m_numberStore;
+        m_tiles = m_tileStore;
+    }
+    else {
+        std::cout << "The star data " << starsDataFile << " was not found!" << std::endl;
+    }
+}
+
+std::vector<CatalogStar>
+HipparcosFormat::toCatalogStars(const std::vector<std::shared_ptr<HipparcosStar>>& stars)
+{
+    std::vector<CatalogStar> catalogStars;
+    catalogStars.reserve(stars.size());
+    for (auto& star : stars) {
+        auto raDec = star->getRaDec();
+        catalogStars.push_back(CatalogStar{raDec->getRaRad(), raDec->getDecRad(), star->getVmagnitude(), static_cast<int32_t>(star->getNumber())});
+    }
+    return catalogStars;
+}
+
+const UnitVectors&
+HipparcosFormat::getUnitVectors()
+{
+    load();
+    return m_vectors;
+}
+
+std::span<const int16_t>
+HipparcosFormat::getVmagnitude()
+{
+    load();
+    return m_vmag;
+}
+
+std::span<const StarTileRecord>
+HipparcosFormat::getTiles()
+{
+    load();
+    return m_tiles;
+}
+
+std::span<const std::shared_ptr<Star>>
 HipparcosFormat::getStars()
 {
+    load();
     if (m_stars.empty()) {
-        m_stars = readStars();
-    }
-    std::vector<std::shared_ptr<Star>> rstars;
-    rstars.reserve(m_stars.size());
-    for (auto s : m_stars) {
-        rstars.push_back(s);
+        m_stars.reserve(m_vectors.size());
+        for (size_t i = 0; i < m_vectors.size(); ++i) {
+            auto star = std::make_shared<HipparcosStar>();
+            star->setNumber(m_numbers[i]);
+            star->setVmagnitude(CatalogFile::toMagnitude(m_vmag[i]));
+            star->setRaDec(std::make_shared<RaDec>(m_vectors.toRaDec(i)));
+            m_stars.push_back(star);
+        }
     }
-    return rstars;	// keep internal structure
+    return m_stars;
 }
 
 std::vector<std::shared_ptr<HipparcosStar>>
-HipparcosFormat::readStars()
+HipparcosFormat::readStars(const std::string& file)
 {
     std::vector<std::shared_ptr<HipparcosStar>> stars;
-    auto file = m_fileLoader->find(starsDataFile);
     if (!file.empty()) {
         try {
             JsonHelper jsonHelper;
@@ -90,8 +207,5 @@ HipparcosFormat::readStars()
             std::cout << "The star data was not be loaded exception " << exc.what() << "!" << std::endl;
         }
     }
-    else {
-        std::cout << "The star data " << starsDataFile << " was not found!" << std::endl;
-    }
     return stars;
 }
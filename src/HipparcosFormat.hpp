@@ -22,12 +22,16 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <span>
 #include <JsonHelper.hpp>
 
 #include "Star.hpp"
 #include "HipparcosStar.hpp"
+#include "HorizonMatrix.hpp"
+#include "StarTiles.hpp"
 
 class FileLoader;
+class CatalogFile;
 
 class Field {
 public:
@@ -70,13 +74,35 @@ public:
     explicit HipparcosFormat(const HipparcosFormat& orig) = delete;
     virtual ~HipparcosFormat() = default;
 
-    std::vector<std::shared_ptr<Star>> getStars();
+    // created on first call, better use the columns below
+    std::span<const std::shared_ptr<Star>> getStars();
+    // column wise star values for the batch transform,
+    //   ordered by the tiles, the index matches getStars
+    const UnitVectors& getUnitVectors();
+    // millimag see CatalogFile::toMagnitude
+    std::span<const int16_t> getVmagnitude();
+    std::span<const StarTileRecord> getTiles();
+    // read the json format, used for the catalog compiler
+    static std::vector<std::shared_ptr<HipparcosStar>> readStars(const std::string& file);
+    static std::vector<CatalogStar> toCatalogStars(const std::vector<std::shared_ptr<HipparcosStar>>& stars);
 
+    static constexpr auto LOCAL_STARS_FILE{"stars.bgcat"};
 
 private:
     static constexpr auto starsDataFile = "hipparcos.json";
-    std::vector<std::shared_ptr<HipparcosStar>> readStars();
-    std::vector<std::shared_ptr<HipparcosStar>> m_stars;
+    void load();
+    bool loadCatalog(const std::string& file);
+    bool m_loaded{false};
+    UnitVectors m_vectors;
+    // the spans either refer to the mapped catalog or the stores
+    std::span<const int16_t> m_vmag;
+    std::span<const int32_t> m_numbers;
+    std::span<const StarTileRecord> m_tiles;
+    std::vector<int16_t> m_vmagStore;
+    std::vector<int32_t> m_numberStore;
+    std::vector<StarTileRecord> m_tileStore;
+    std::vector<std::shared_ptr<Star>> m_stars;
+    std::shared_ptr<CatalogFile> m_catalog;
     const std::shared_ptr<FileLoader> m_fileLoader;
 };
 
@@ -0,0 +1,264 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "HorizonMatrix.hpp"
+#include "GeoPosition.hpp"
+#include "JulianDate.hpp"
+#include "Layout.hpp"
+#include "RaDec.hpp"
+#include "Math.hpp"
+
+int16_t
+UnitVectors::quantize(double value)
+{
+    return static_cast<int16_t>(std::clamp(std::round(value * QUANT_SCALE), -QUANT_SCALE, QUANT_SCALE));
+}
+
+void
+UnitVectors::add(double ra, double dec)
+{
+    const double cosDec = std::cos(dec);
+    m_x.push_back(cosDec * std::cos(ra));
+    m_y.push_back(cosDec * std::sin(ra));
+    m_z.push_back(std::sin(dec));
+}
+
+void
+UnitVectors::add(const RaDec& raDec)
+{
+    add(raDec.getRaRad(), raDec.getDecRad());
+}
+
+void
+UnitVectors::append(const UnitVectors& other)
+{
+    if (other.isQuantized()) {
+        for (size_t i = 0; i < other.size(); ++i) {
+            m_x.push_back(other.m_qx[i] / QUANT_SCALE);
+            m_y.push_back(other.m_qy[i] / QUANT_SCALE);
+            m_z.push_back(other.m_qz[i] / QUANT_SCALE);
+        }
+    }
+    else {
+        m_x.insert(m_x.end(), other.m_x.begin(), other.m_x.end());
+        m_y.insert(m_y.end(), other.m_y.begin(), other.m_y.end());
+        m_z.insert(m_z.end(), other.m_z.begin(), other.m_z.end());
+    }
+}
+
+void
+UnitVectors::reserve(size_t size)
+{
+    m_x.reserve(size);
+    m_y.reserve(size);
+    m_z.reserve(size);
+}
+
+void
+UnitVectors::clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_qx = std::span<const int16_t>();
+    m_qy = std::span<const int16_t>();
+    m_qz = std::span<const int16_t>();
+}
+
+size_t
+UnitVectors::size() const
+{
+    return isQuantized() ? m_qx.size() : m_x.size();
+}
+
+bool
+UnitVectors::empty() const
+{
+    return size() == 0u;
+}
+
+void
+UnitVectors::setQuantized(std::span<const int16_t> x, std::span<const int16_t> y, std::span<const int16_t> z)
+{
+    clear();
+    const auto n = std::min({x.size(), y.size(), z.size()});
+    m_qx = x.first(n);
+    m_qy = y.first(n);
+    m_qz = z.first(n);
+}
+
+bool
+UnitVectors::isQuantized() const
+{
+    return m_qx.data() != nullptr;
+}
+
+RaDec
+UnitVectors::toRaDec(size_t idx) const
+{
+    double x, y, z;
+    if (isQuantized()) {
+        x = m_qx[idx] / QUANT_SCALE;
+        y = m_qy[idx] / QUANT_SCALE;
+        z = m_qz[idx] / QUANT_SCALE;
+    }
+    else {
+        x = m_x[idx];
+        y = m_y[idx];
+        z = m_z[idx];
+    }
+    double ra = std::atan2(y, x);
+    if (ra < 0.0) {
+        ra += Math::TWO_PI;
+    }
+    return RaDec(ra, std::atan2(z, std::sqrt(x * x + y * y)));
+}
+
+std::span<const double>
+UnitVectors::getX() const
+{
+    return m_x;
+}
+
+std::span<const double>
+UnitVectors::getY() const
+{
+    return m_y;
+}
+
+std::span<const double>
+UnitVectors::getZ() const
+{
+    return m_z;
+}
+
+std::span<const int16_t>
+UnitVectors::getQuantizedX() const
+{
+    return m_qx;
+}
+
+std::span<const int16_t>
+UnitVectors::getQuantizedY() const
+{
+    return m_qy;
+}
+
+std::span<const int16_t>
+UnitVectors::getQuantizedZ() const
+{
+    return m_qz;
+}
+
+
+HorizonMatrix::HorizonMatrix(const GeoPosition& geoPos, const JulianDate& jd)
+{
+    // the hour angle H = lst - ra gives with the latitude phi
+    //   x = -sin(H) cos(dec)
+    //   y = sin(dec) cos(phi) - cos(H) cos(dec) sin(phi)
+    //   z = sin(dec) sin(phi) + cos(H) cos(dec) cos(phi)
+    // expanding H gives a rotation by lst around z and a tilt by phi
+    const double lst = geoPos.localSiderealTime(jd);
+    const double sinLst = std::sin(lst);
+    const double cosLst = std::cos(lst);
+    const double lat = geoPos.getLatRad();
+    const double sinLat = std::sin(lat);
+    const double cosLat = std::cos(lat);
+    m_rot = {
+        -sinLst,          cosLst,          0.0,
+        -sinLat * cosLst, -sinLat * sinLst, cosLat,
+         cosLat * cosLst,  cosLat * sinLst, sinLat
+    };
+}
+
+void
+HorizonMatrix::toHorizon(double ex, double ey, double ez, double& x, double& y, double& z) const
+{
+    x = m_rot[0] * ex + m_rot[1] * ey + m_rot[2] * ez;
+    y = m_rot[3] * ex + m_rot[4] * ey + m_rot[5] * ez;
+    z = m_rot[6] * ex + m_rot[7] * ey + m_rot[8] * ez;
+}
+
+// the scale allows to fold the quantization into the matrix
+template<typename T>
+static void
+project(const std::array<double, 9>& rot, double scale
+      , std::span<const T> ex, std::span<const T> ey, std::span<const T> ez, double r
+      , double* __restrict xs, double* __restrict ys, double* __restrict zs)
+{
+    // locals allow the compiler to vectorize
+    const double m0 = rot[0] * scale, m1 = rot[1] * scale, m2 = rot[2] * scale;
+    const double m3 = rot[3] * scale, m4 = rot[4] * scale, m5 = rot[5] * scale;
+    const double m6 = rot[6] * scale, m7 = rot[7] * scale, m8 = rot[8] * scale;
+    const size_t n = ex.size();
+    for (size_t i = 0; i < n; ++i) {
+        const double vx = static_cast<double>(ex[i]);
+        const double vy = static_cast<double>(ey[i]);
+        const double vz = static_cast<double>(ez[i]);
+        const double hx = m0 * vx + m1 * vy + m2 * vz;
+        const double hy = m3 * vx + m4 * vy + m5 * vz;
+        const double hz = m6 * vx + m7 * vy + m8 * vz;
+        const double f = -r / (1.0 + hz);   // negativ to match stellarium and screen quadrant
+        xs[i] = hx * f;
+        ys[i] = hy * f;
+        zs[i] = hz;
+    }
+}
+
+void
+HorizonMatrix::toScreen(const UnitVectors& vectors, const Layout& layout
+                      , std::span<double> x, std::span<double> y, std::span<double> z) const
+{
+    toScreen(vectors, 0u, vectors.size(), layout, x, y, z);
+}
+
+void
+HorizonMatrix::toScreen(const UnitVectors& vectors, size_t first, size_t count, const Layout& layout
+                      , std::span<double> x, std::span<double> y, std::span<double> z) const
+{
+    const double r = layout.getMin() / 2.0;
+    if (vectors.isQuantized()) {
+        project<int16_t>(m_rot, 1.0 / UnitVectors::QUANT_SCALE
+                , vectors.getQuantizedX().subspan(first, count)
+                , vectors.getQuantizedY().subspan(first, count)
+                , vectors.getQuantizedZ().subspan(first, count), r
+                , x.data(), y.data(), z.data());
+    }
+    else {
+        project<double>(m_rot, 1.0
+                , vectors.getX().subspan(first, count)
+                , vectors.getY().subspan(first, count)
+                , vectors.getZ().subspan(first, count), r
+                , x.data(), y.data(), z.data());
+    }
+}
+
+void
+HorizonMatrix::toScreen(const RaDec& raDec, const Layout& layout, double& x, double& y, double& z) const
+{
+    const double cosDec = std::cos(raDec.getDecRad());
+    double hx, hy;
+    toHorizon(cosDec * std::cos(raDec.getRaRad()), cosDec * std::sin(raDec.getRaRad()), std::sin(raDec.getDecRad())
+            , hx, hy, z);
+    const double f = -(layout.getMin() / 2.0) / (1.0 + z);
+    x = hx * f;
+    y = hy * f;
+}
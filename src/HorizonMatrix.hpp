@@ -0,0 +1,108 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <span>
+#include <array>
+#include <cstdint>
+
+class GeoPosition;
+class JulianDate;
+class Layout;
+class RaDec;
+
+/**
+ * catalog positions as unit vectors in the equatorial frame
+ *   (x towards ra 0h, z towards the celestial north pole),
+ *   kept column wise so the transform loops vectorize.
+ * The values are either owned doubles or quantized int16 values
+ *   referenced e.g. from a mapped catalog.
+ */
+class UnitVectors
+{
+public:
+    UnitVectors() = default;
+    explicit UnitVectors(const UnitVectors& orig) = delete;
+    virtual ~UnitVectors() = default;
+
+    static constexpr double QUANT_SCALE{32767.0};
+    static int16_t quantize(double value);
+
+    // radians
+    void add(double ra, double dec);
+    void add(const RaDec& raDec);
+    // appends the vectors of other, as this is owned a quantized other gets expanded
+    void append(const UnitVectors& other);
+    void reserve(size_t size);
+    void clear();
+    size_t size() const;
+    bool empty() const;
+    // the memory has to outlive this (values are / QUANT_SCALE)
+    void setQuantized(std::span<const int16_t> x, std::span<const int16_t> y, std::span<const int16_t> z);
+    bool isQuantized() const;
+    RaDec toRaDec(size_t idx) const;
+
+    // only for !isQuantized
+    std::span<const double> getX() const;
+    std::span<const double> getY() const;
+    std::span<const double> getZ() const;
+    // only for isQuantized
+    std::span<const int16_t> getQuantizedX() const;
+    std::span<const int16_t> getQuantizedY() const;
+    std::span<const int16_t> getQuantizedZ() const;
+
+private:
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+    std::span<const int16_t> m_qx;
+    std::span<const int16_t> m_qy;
+    std::span<const int16_t> m_qz;
+};
+
+/**
+ * rotation from the equatorial frame to the horizon frame for a
+ *   place and time, build once per frame.
+ *   The horizon frame uses x = cos(alt) sin(az), y = cos(alt) cos(az), z = sin(alt)
+ *   as AzimutAltitude::toScreen.
+ *   Corrections like precession, nutation would be a additional rotation
+ *   multiplied in by the constructor.
+ */
+class HorizonMatrix
+{
+public:
+    HorizonMatrix(const GeoPosition& geoPos, const JulianDate& jd);
+    HorizonMatrix(const HorizonMatrix& orig) = default;
+    virtual ~HorizonMatrix() = default;
+
+    void toHorizon(double ex, double ey, double ez, double& x, double& y, double& z) const;
+    // stereographic projection as AzimutAltitude::toScreen,
+    //   z is the sine of the altitude so z >= 0.0 is equivalent to AzimutAltitude::isVisible
+    //   the output spans are expected to have at least the size of vectors
+    void toScreen(const UnitVectors& vectors, const Layout& layout
+                , std::span<double> x, std::span<double> y, std::span<double> z) const;
+    // only the range first..first+count of vectors, output starts at index 0
+    void toScreen(const UnitVectors& vectors, size_t first, size_t count, const Layout& layout
+                , std::span<double> x, std::span<double> y, std::span<double> z) const;
+    void toScreen(const RaDec& raDec, const Layout& layout, double& x, double& y, double& z) const;
+
+private:
+    std::array<double, 9> m_rot;    // row major
+};
@@ -0,0 +1,291 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <array>
+#include <cstring>
+#include <algorithm>
+
+#include "ImageEncoder.hpp"
+
+ImageEncoder::ImageEncoder()
+{
+    m_resultDispatcher.connect([this] {
+        std::deque<EncodeResult> results;
+        {
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            results.swap(m_results);
+        }
+        for (auto& result : results) {
+            m_signalEncoded.emit(result);
+        }
+    });
+    m_thread = std::thread(&ImageEncoder::run, this);
+}
+
+ImageEncoder::~ImageEncoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_stop = true;
+    }
+    m_requestCondition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void
+ImageEncoder::encode(Cairo::RefPtr<Cairo::ImageSurface>&& image, const std::string& path, const EncodeOptions& options)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_pending = Request{std::move(image), path, options};
+    }
+    m_requestCondition.notify_one();
+}
+
+sigc::signal<void(const EncodeResult&)>
+ImageEncoder::signal_encoded()
+{
+    return m_signalEncoded;
+}
+
+const char*
+ImageEncoder::getExtension(ImageFormat format)
+{
+    switch (format) {
+    case ImageFormat::Qoi:
+        return ".qoi";
+    case ImageFormat::Png:
+    default:
+        return ".png";
+    }
+}
+
+ImageFormat
+ImageEncoder::parseFormat(const Glib::ustring& name)
+{
+    if (name.lowercase() == "qoi") {
+        return ImageFormat::Qoi;
+    }
+    return ImageFormat::Png;
+}
+
+// fnv-1a using words, as this is called for each update
+uint64_t
+ImageEncoder::hash(const uint8_t* data, int width, int height, int stride)
+{
+    constexpr uint64_t prime{0x100000001b3ull};
+    uint64_t hash{0xcbf29ce484222325ull};
+    const size_t rowBytes = static_cast<size_t>(width) * sizeof(uint32_t);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = data + static_cast<size_t>(y) * stride;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= rowBytes; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, row + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < rowBytes; ++i) {
+            hash = (hash ^ row[i]) * prime;
+        }
+    }
+    return hash;
+}
+
+std::vector<uint8_t>
+ImageEncoder::encodeQoi(const uint8_t* data, int width, int height, int stride, bool alpha)
+{
+    struct Pixel
+    {
+        uint8_t r, g, b, a;
+        bool operator==(const Pixel& other) const = default;
+    };
+    std::vector<uint8_t> out;
+    out.reserve(QOI_HEADER_SIZE + static_cast<size_t>(width) * height * 2u);
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    for (auto value : {static_cast<uint32_t>(width), static_cast<uint32_t>(height)}) {
+        out.push_back(static_cast<uint8_t>(value >> 24));     // big endian
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    out.push_back(alpha ? 4u : 3u);
+    out.push_back(0u);  // srgb with linear alpha
+    std::array<Pixel, 64> index{};
+    Pixel prev{0u, 0u, 0u, 255u};
+    uint32_t run{};
+    for (int y = 0; y < height; ++y) {
+        const auto row = reinterpret_cast<const uint32_t*>(data + static_cast<size_t>(y) * stride);
+        for (int x = 0; x < width; ++x) {
+            const uint32_t argb = row[x];
+            Pixel px{static_cast<uint8_t>(argb >> 16)
+                   , static_cast<uint8_t>(argb >> 8)
+                   , static_cast<uint8_t>(argb)
+                   , alpha ? static_cast<uint8_t>(argb >> 24) : static_cast<uint8_t>(255u)};
+            if (px.a == 0u) {
+                px.r = px.g = px.b = 0u;
+            }
+            else if (px.a < 255u) {     // cairo uses premultiplied
+                const uint32_t half = px.a / 2u;
+                px.r = static_cast<uint8_t>(std::min((px.r * 255u + half) / px.a, 255u));
+                px.g = static_cast<uint8_t>(std::min((px.g * 255u + half) / px.a, 255u));
+                px.b = static_cast<uint8_t>(std::min((px.b * 255u + half) / px.a, 255u));
+            }
+            if (px == prev) {
+                ++run;
+                if (run == QOI_MAX_RUN) {
+                    out.push_back(static_cast<uint8_t>(0xc0u | (run - 1u)));
+                    run = 0u;
+                }
+                continue;
+            }
+            if (run > 0u) {
+                out.push_back(static_cast<uint8_t>(0xc0u | (run - 1u)));
+                run = 0u;
+            }
+            const uint32_t pos = (px.r * 3u + px.g * 5u + px.b * 7u + px.a * 11u) % 64u;
+            if (index[pos] == px) {
+                out.push_back(static_cast<uint8_t>(pos));
+            }
+            else {
+                index[pos] = px;
+                if (px.a == prev.a) {
+                    const int dr = static_cast<int8_t>(px.r - prev.r);
+                    const int dg = static_cast<int8_t>(px.g - prev.g);
+                    const int db = static_cast<int8_t>(px.b - prev.b);
+                    const int drg = dr - dg;
+                    const int dbg = db - dg;
+                    if (dr >= -2 && dr <= 1
+                     && dg >= -2 && dg <= 1
+                     && db >= -2 && db <= 1) {
+                        out.push_back(static_cast<uint8_t>(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                    }
+                    else if (dg >= -32 && dg <= 31
+                          && drg >= -8 && drg <= 7
+                          && dbg >= -8 && dbg <= 7) {
+                        out.push_back(static_cast<uint8_t>(0x80 | (dg + 32)));
+                        out.push_back(static_cast<uint8_t>((drg + 8) << 4 | (dbg + 8)));
+                    }
+                    else {
+                        out.insert(out.end(), {0xfeu, px.r, px.g, px.b});
+                    }
+                }
+                else {
+                    out.insert(out.end(), {0xffu, px.r, px.g, px.b, px.a});
+                }
+            }
+            prev = px;
+        }
+    }
+    if (run > 0u) {
+        out.push_back(static_cast<uint8_t>(0xc0u | (run - 1u)));
+    }
+    out.insert(out.end(), {0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u});
+    return out;
+}
+
+void
+ImageEncoder::run()
+{
+    while (true) {
+        Request request{};
+        {
+            std::unique_lock<std::mutex> lock(m_requestMutex);
+            m_requestCondition.wait(lock, [this] {
+                return m_stop || m_pending.has_value();
+            });
+            if (m_stop) {
+                break;
+            }
+            request = std::move(m_pending.value());
+            m_pending.reset();
+        }
+        write(request.image, request.path, request.options);
+        request.image.clear();  // release on this thread, we are the only owner
+    }
+}
+
+void
+ImageEncoder::write(Cairo::RefPtr<Cairo::ImageSurface>& image, const std::string& path, const EncodeOptions& options)
+{
+    EncodeResult result;
+    result.path = path;
+    auto start = std::chrono::steady_clock::now();
+    image->flush();
+    const bool alpha = image->get_format() == Cairo::Format::FORMAT_ARGB32;
+    const uint64_t imageHash = hash(image->get_data(), image->get_width(), image->get_height(), image->get_stride());
+    if (imageHash == m_lastHash
+     && m_lastOptions == options) {
+        result.skipped = true;
+    }
+    else {
+        // a consumer shall never see a partial file
+        const std::string temp = path + TEMP_SUFFIX;
+        try {
+            if (options.format == ImageFormat::Qoi) {
+                auto qoi = encodeQoi(image->get_data(), image->get_width(), image->get_height(), image->get_stride(), alpha);
+                std::ofstream stream(temp, std::ios::binary);
+                stream.write(reinterpret_cast<const char*>(qoi.data()), static_cast<std::streamsize>(qoi.size()));
+                if (!stream) {
+                    result.error = "write failed";
+                }
+            }
+            else if (options.compression >= 0) {
+                auto pixbuf = Gdk::Pixbuf::create(image, 0, 0, image->get_width(), image->get_height());
+                pixbuf->save(temp, "png"
+                            , std::vector<Glib::ustring>{"compression"}
+                            , std::vector<Glib::ustring>{Glib::ustring::format(std::min(options.compression, 9))});
+            }
+            else {
+                image->write_to_png(temp);
+            }
+        }
+        catch (const Glib::Error& exc) {
+            result.error = exc.what();
+        }
+        catch (const std::exception& exc) {
+            result.error = exc.what();
+        }
+        std::error_code err;
+        if (result.error.empty()) {
+            result.size = std::filesystem::file_size(temp, err);
+            std::filesystem::rename(temp, path, err);
+            if (err) {
+                result.error = err.message();
+            }
+        }
+        if (result.error.empty()) {
+            m_lastHash = imageHash;
+            m_lastOptions = options;
+        }
+        else {
+            std::filesystem::remove(temp, err);
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    {
+        std::lock_guard<std::mutex> lock(m_resultMutex);
+        m_results.push_back(std::move(result));
+    }
+    m_resultDispatcher.emit();
+}
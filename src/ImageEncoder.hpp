@@ -0,0 +1,106 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtkmm.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <deque>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+enum class ImageFormat
+{
+      Png
+    , Qoi       // see https://qoiformat.org/ fast, but not all consumers accept it
+};
+
+struct EncodeOptions
+{
+    ImageFormat format{ImageFormat::Png};
+    int compression{-1};    // png 0..9, -1 cairo default
+    bool operator==(const EncodeOptions& other) const = default;
+};
+
+struct EncodeResult
+{
+    std::string path;
+    bool skipped{false};    // unchanged, nothing was written
+    double seconds{};       // encoding time
+    uint64_t size{};        // bytes written
+    std::string error;
+};
+
+/**
+ * writes the images on its own thread, so the main loop stays responsive.
+ *   Images arriving while a image is written are combined,
+ *   only the newest gets written.
+ *   A image with the same pixels as the last written is skipped.
+ *   The file is written to a temporary and renamed when complete.
+ *   The alpha will be dropped for images with FORMAT_RGB24.
+ */
+class ImageEncoder
+{
+public:
+    // written to path + suffix and renamed when complete
+    static constexpr auto TEMP_SUFFIX{".part"};
+
+    ImageEncoder();
+    explicit ImageEncoder(const ImageEncoder& orig) = delete;
+    virtual ~ImageEncoder();
+
+    // takes the image, keep no other reference as the refcount is not thread safe
+    void encode(Cairo::RefPtr<Cairo::ImageSurface>&& image, const std::string& path, const EncodeOptions& options);
+    // emitted on the main thread for each encoded (or skipped) image
+    sigc::signal<void(const EncodeResult&)> signal_encoded();
+    static const char* getExtension(ImageFormat format);
+    static ImageFormat parseFormat(const Glib::ustring& name);
+    // the pixels of the visible width, ignores the stride padding
+    static uint64_t hash(const uint8_t* data, int width, int height, int stride);
+    // the data in the cairo layout (native endian premultiplied argb)
+    static std::vector<uint8_t> encodeQoi(const uint8_t* data, int width, int height, int stride, bool alpha);
+
+protected:
+    void run();
+    void write(Cairo::RefPtr<Cairo::ImageSurface>& image, const std::string& path, const EncodeOptions& options);
+
+private:
+    struct Request
+    {
+        Cairo::RefPtr<Cairo::ImageSurface> image;
+        std::string path;
+        EncodeOptions options;
+    };
+    static constexpr auto QOI_HEADER_SIZE{14u};
+    static constexpr auto QOI_MAX_RUN{62u};
+    std::mutex m_requestMutex;
+    std::condition_variable m_requestCondition;
+    std::optional<Request> m_pending;
+    bool m_stop{false};
+    uint64_t m_lastHash{};              // used by the worker
+    std::optional<EncodeOptions> m_lastOptions;
+    std::mutex m_resultMutex;
+    std::deque<EncodeResult> m_results;
+    Glib::Dispatcher m_resultDispatcher;
+    sigc::signal<void(const EncodeResult&)> m_signalEncoded;
+    std::thread m_thread;               // last, started with all members ready
+};
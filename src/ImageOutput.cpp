@@ -0,0 +1,101 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <filesystem>
+
+#include "ImageOutput.hpp"
+
+ImageOutput::ImageOutput(const std::string& dir, const std::string& prefix)
+: m_dir{dir}
+, m_prefix{prefix}
+{
+    if (!m_dir.empty()
+     && m_dir.back() != '/') {
+        m_dir += '/';
+    }
+}
+
+std::string
+ImageOutput::getSlot(size_t slot, const char* extension) const
+{
+    return m_dir + m_prefix + SLOTS[slot] + extension;
+}
+
+std::string
+ImageOutput::getNext(const char* extension)
+{
+    auto first = getSlot(0u, extension);
+    auto second = getSlot(1u, extension);
+    if (first == m_shown) {
+        m_next = second;
+    }
+    else if (second == m_shown) {
+        m_next = first;
+    }
+    else {
+        m_next = first == m_next ? second : first;
+    }
+    return m_next;
+}
+
+void
+ImageOutput::restoreShown(const char* extension)
+{
+    std::filesystem::file_time_type newest;
+    for (size_t slot = 0; slot < SLOTS.size(); ++slot) {
+        auto path = getSlot(slot, extension);
+        std::error_code err;
+        auto time = std::filesystem::last_write_time(path, err);
+        if (!err
+         && (m_shown.empty() || time > newest)) {
+            m_shown = path;
+            newest = time;
+        }
+    }
+}
+
+void
+ImageOutput::setShown(const std::string& path)
+{
+    m_shown = path;
+}
+
+void
+ImageOutput::setUnused(const std::string& path)
+{
+    if (path == m_next) {
+        m_next = m_shown;
+    }
+}
+
+const std::string&
+ImageOutput::getShown() const
+{
+    return m_shown;
+}
+
+bool
+ImageOutput::isSlot(const std::string& name, const char* extension) const
+{
+    for (auto slot : SLOTS) {
+        if (name == m_prefix + slot + extension) {
+            return true;
+        }
+    }
+    return false;
+}
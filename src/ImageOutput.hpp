@@ -0,0 +1,59 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <array>
+
+/**
+ * the daemon writes the image alternating to two files,
+ *   as the background is only updated if the name changes,
+ *   and the shown file stays untouched while the other is written.
+ *   So there is no need to look into the directory for leftovers.
+ */
+class ImageOutput
+{
+public:
+    ImageOutput(const std::string& dir, const std::string& prefix);
+    explicit ImageOutput(const ImageOutput& orig) = delete;
+    virtual ~ImageOutput() = default;
+
+    // the file to write next, never the shown one,
+    //   if nothing is shown alternates from the last one handed out
+    //   (so a image still encoding while the next is requested gets a new name if possible)
+    std::string getNext(const char* extension);
+    // after a restart the newest of the files is most likely still set as background,
+    //   take it as shown, so the first image gets the other name
+    void restoreShown(const char* extension);
+    // the file was written and set as background
+    void setShown(const std::string& path);
+    // the file was not written (skipped or failed), hand it out again
+    void setUnused(const std::string& path);
+    const std::string& getShown() const;
+    // the name is one of ours
+    bool isSlot(const std::string& name, const char* extension) const;
+
+private:
+    static constexpr std::array<const char*, 2> SLOTS{"a", "b"};
+    std::string getSlot(size_t slot, const char* extension) const;
+    std::string m_dir;
+    std::string m_prefix;
+    std::string m_shown;
+    std::string m_next;
+};
@@ -17,10 +17,12 @@
  */
 
 #include <iostream>
+#include <algorithm>
 
 #include "StarWin.hpp"
 #include "Math.hpp"
 #include "background_config.h"
+#include "Compositor.hpp"
 
 #include "InfoModule.hpp"
 
@@ -46,56 +48,198 @@ InfoModule::getHeight(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin
     auto height = static_cast<int>(pyClass->invokeMethod("getHeight", ctx, fontName));
     if (pyClass->hasFailed()) {
         starWin->showMessage(pyClass->getError(), Gtk::MessageType::MESSAGE_ERROR);
-        height = 0;
+        return 0;
     }
-    return height;
+    return height + (isGraph() ? GRAPH_HEIGHT : 0);
 #   else
     auto pangoLayout = Pango::Layout::create(ctx);
     pangoLayout->set_font_description(infoFont);
     pangoLayout->set_text("M");
     int width, height;
     pangoLayout->get_pixel_size(width, height);
-    return 6 * height;
+    return 7 * height + (isGraph() ? GRAPH_HEIGHT : 0);
 #   endif
 }
 
+uint32_t
+InfoModule::getSampleSeconds()
+{
+    return static_cast<uint32_t>(std::max(m_config->getInteger(getName().c_str(), SAMPLE_SECONDS_KEY, 5), 1));
+}
+
+bool
+InfoModule::isGraph()
+{
+    return m_config->getBoolean(getName().c_str(), GRAPH_KEY, false);
+}
+
+std::shared_ptr<const SysSnapshot>
+InfoModule::getSnapshot()
+{
+    auto seconds = getSampleSeconds();
+    if (!m_sampler
+     || seconds != m_samplerSeconds) {
+        m_sampler.reset();      // stop the previous before starting
+        m_sampler = std::make_shared<SysSampler>(seconds);
+        m_samplerSeconds = seconds;
+    }
+    return m_sampler->getSnapshot();
+}
+
 std::string
-InfoModule::getText(SysInfo& sysInfo)
+InfoModule::getText(const SysSnapshot& snapshot)
 {
+    if (m_staticText.empty()) {
+        SysInfo sysInfo;
+        m_staticText = sysInfo.nodeName() + "\n"
+                     + sysInfo.machine() + "\n"
+                     + sysInfo.osVersion() + "\n"
+                     + sysInfo.cpuInfo() + "\n";
+    }
     std::string text;
     text.reserve(512);
-    for (auto info : sysInfo.allInfos()) {
-        text += info + "\n";
-    }
+    text += m_staticText;
+    text += Glib::ustring::sprintf("%luMB used of %luMB\n"
+                , static_cast<unsigned long>((snapshot.memTotalKb - snapshot.memAvailableKb) / 1024u)
+                , static_cast<unsigned long>(snapshot.memTotalKb / 1024u));
+    text += Glib::ustring::sprintf("load %.2f %.2f %.2f cpu %.0f%% disk %.1fMB/s net %.1fMB/s\n"
+                , snapshot.load[0], snapshot.load[1], snapshot.load[2]
+                , snapshot.cpu * 100.0
+                , (snapshot.diskReadRate + snapshot.diskWriteRate) / 1.0e6
+                , (snapshot.netRxRate + snapshot.netTxRate) / 1.0e6);
+    text += snapshot.netInfo + "\n";
     return text;
 }
 
-void
-InfoModule::display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin)
+size_t
+InfoModule::getLayoutKey(StarWin* starWin)
 {
-    getPrimaryColor(ctx);
-    auto infoFont = getFont();
-    SysInfo sysInfo;
-    auto netInfo = sysInfo.netInfo();
-#   ifdef USE_PYTHON
-    auto pyClass = checkPyClass(starWin, pyClassName);
-    if (pyClass) {
-        auto font = infoFont.to_string();
-        pyClass->invokeMethod("draw", ctx, font, netInfo);
-        if (pyClass->hasFailed()) {
-            starWin->showMessage(pyClass->getError(), Gtk::MessageType::MESSAGE_ERROR);
-        }
+    size_t key = Module::getLayoutKey(starWin);
+    return Compositor::combine(key, isGraph() ? 1u : 0u);
+}
+
+// redraw if the info changed, the values are taken from the sampler without any i/o
+size_t
+InfoModule::getContentKey(StarWin* starWin)
+{
+    auto snapshot = getSnapshot();
+    if (!snapshot) {
+        return Compositor::UNCACHED;
     }
-    else {
-        std::cout << "InfoModule::display no Class!" << std::endl;
+    m_snapshot = snapshot;          // keep for display, so all use the same values
+    m_text = getText(*snapshot);
+    m_netInfo = snapshot->netInfo;
+    size_t key = std::hash<std::string>{}(m_text);
+    if (isGraph()) {
+        key = Compositor::combine(key, std::hash<uint64_t>{}(snapshot->sequence));
     }
-#   else
-    auto pangoLayout = Pango::Layout::create(ctx);
-    pangoLayout->set_font_description(infoFont);
-    pangoLayout->set_text(getText(sysInfo));
-    ctx->move_to(0.0, 0.0);
-    pangoLayout->show_in_cairo_context(ctx);
+    return key == Compositor::UNCACHED ? 1u : key;
+}
+
+uint32_t
+InfoModule::getUpdateSeconds()
+{
+    return 60u;
+}
+
+// the snapshot and text of the last getContentKey are copied,
+//   so the worker draws the values the key was built from
+Module::DisplayFunc
+InfoModule::prepareDisplay(StarWin* starWin)
+{
+    if (!m_snapshot) {
+        getContentKey(starWin);
+    }
+    auto color = getPrimaryColor();
+    auto font = getFont().to_string();
+    const double graphOffset = isGraph() && m_measuredHeight > GRAPH_HEIGHT
+                             ? static_cast<double>(m_measuredHeight - GRAPH_HEIGHT)
+                             : -1.0;
+    std::shared_ptr<PyClass> pyClass;
+#   ifdef USE_PYTHON
+    pyClass = checkPyClass(starWin, pyClassName);
 #   endif
+    return [pyClass, color, font, graphOffset, snapshot = m_snapshot, text = m_text, netInfo = m_netInfo] (const Cairo::RefPtr<Cairo::Context>& ctx) {
+        std::string error;
+        setSource(ctx, color);
+#       ifdef USE_PYTHON
+        if (pyClass) {
+            if (pyClass->hasMethod("drawSnapshot")) {
+                // the sampled values, so the script shows what the key was built from
+                std::vector<double> cpu, memory;
+                if (snapshot) {
+                    cpu.reserve(snapshot->history.size());
+                    memory.reserve(snapshot->history.size());
+                    for (auto& sample : snapshot->history) {
+                        cpu.push_back(static_cast<double>(sample.cpu));
+                        memory.push_back(static_cast<double>(sample.memory));
+                    }
+                }
+                pyClass->invokeMethod("drawSnapshot", ctx, font, text, cpu, memory);
+            }
+            else {      // a local script of a previous version reads the values itself
+                pyClass->invokeMethod("draw", ctx, font, netInfo);
+            }
+            if (pyClass->hasFailed()) {
+                error = pyClass->getError();
+            }
+        }
+        else {
+            std::cout << "InfoModule::display no Class!" << std::endl;
+        }
+#       else
+        auto pangoLayout = Pango::Layout::create(ctx);
+        pangoLayout->set_font_description(Pango::FontDescription(font));
+        pangoLayout->set_text(text);
+        ctx->move_to(0.0, 0.0);
+        pangoLayout->show_in_cairo_context(ctx);
+#       endif
+        if (snapshot
+         && graphOffset >= 0.0) {
+            ctx->save();
+            ctx->translate(0.0, graphOffset);
+            displayGraph(ctx, *snapshot, color);
+            ctx->restore();
+        }
+        return error;
+    };
+}
+
+void
+InfoModule::displayGraph(const Cairo::RefPtr<Cairo::Context>& ctx, const SysSnapshot& snapshot, const Gdk::RGBA& color)
+{
+    constexpr double step{2.0};
+    const double height = static_cast<double>(GRAPH_HEIGHT) - 4.0;
+    const double width = step * static_cast<double>(SysSampler::HISTORY - 1u);
+    setSource(ctx, color);
+    ctx->set_line_width(1.0);
+    ctx->rectangle(0.5, 2.5, width, height);
+    ctx->stroke();
+    if (snapshot.history.size() < 2u) {
+        return;
+    }
+    // the latest right aligned
+    const double x0 = width - step * static_cast<double>(snapshot.history.size() - 1u);
+    auto plot = [&] (float SysSample::* value) {
+        double x = x0;
+        bool first{true};
+        for (auto& sample : snapshot.history) {
+            double y = 2.0 + height * (1.0 - std::clamp(static_cast<double>(sample.*value), 0.0, 1.0));
+            if (first) {
+                ctx->move_to(x, y);
+                first = false;
+            }
+            else {
+                ctx->line_to(x, y);
+            }
+            x += step;
+        }
+        ctx->stroke();
+    };
+    ctx->set_line_width(1.5);
+    plot(&SysSample::cpu);
+    setSource(ctx, color, color.get_alpha() * 0.5);
+    plot(&SysSample::memory);
 }
 
 void
@@ -20,6 +20,7 @@
 
 #include "Module.hpp"
 #include "SysInfo.hpp"
+#include "SysSampler.hpp"
 
 class InfoModule
 : public Module
@@ -33,12 +34,31 @@ public:
     virtual ~InfoModule() = default;
 
     int getHeight(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin) override;
-    void display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin) override;
+    DisplayFunc prepareDisplay(StarWin* starWin) override;
+    size_t getLayoutKey(StarWin* starWin) override;
+    size_t getContentKey(StarWin* starWin) override;
+    uint32_t getUpdateSeconds() override;
     void setupParam(const Glib::RefPtr<Gtk::Builder>& builder, StarWin* starWin) override;
     Glib::ustring getPyScriptName() override;
     static constexpr auto pyClassName{"Info"};
+    static constexpr auto SAMPLE_SECONDS_KEY{"sampleSeconds"};
+    static constexpr auto GRAPH_KEY{"graph"};
+    static constexpr auto GRAPH_HEIGHT{48};
+    uint32_t getSampleSeconds();
+    bool isGraph();
 protected:
-    std::string getText(SysInfo& sysInfo);
+    std::string getText(const SysSnapshot& snapshot);
+    std::shared_ptr<const SysSnapshot> getSnapshot();
+    // the cpu and memory history below the text
+    static void displayGraph(const Cairo::RefPtr<Cairo::Context>& ctx, const SysSnapshot& snapshot, const Gdk::RGBA& color);
 
 private:
+    std::shared_ptr<SysSampler> m_sampler;
+    uint32_t m_samplerSeconds{};
+    // node, machine, os and cpu do not change, read once
+    std::string m_staticText;
+    // the infos of the last getContentKey
+    std::shared_ptr<const SysSnapshot> m_snapshot;
+    std::string m_text;
+    std::string m_netInfo;
 };
\ No newline at end of file
@@ -54,8 +54,8 @@ Messier::setName(const Glib::ustring& _ident)
 	m_name = _ident;
 }
 
-Glib::ustring 
-Messier::getName()
+const Glib::ustring&
+Messier::getName() const
 {
     return m_name;
 }
\ No newline at end of file
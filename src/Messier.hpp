@@ -37,7 +37,7 @@ public:
     double getVmagnitude() const override;
     void setVmagnitude(double vmagnitude);
     void setName(const Glib::ustring& ident);
-    Glib::ustring getName();
+    const Glib::ustring& getName() const;
 private:
     Glib::ustring m_name;
     double m_vmagnitude{};
@@ -19,8 +19,11 @@
 #include <string>
 #include <charconv>
 #include <iostream>
+#include <cstring>
 
 #include "MessierLoader.hpp"
+#include "CatalogFile.hpp"
+#include "HorizonMatrix.hpp"
 
 
 MessierLoader::MessierLoader(const std::shared_ptr<FileLoader>& fileLoader)
@@ -82,20 +85,63 @@ MessierLoader::readMessier(JsonObject* m, JsonHelper& jsonHelper)
     return messier;
 }
 
-std::list<std::shared_ptr<Messier>>
+std::span<const std::shared_ptr<Messier>>
 MessierLoader::getMessiers()
 {
-    if (m_messier.empty()) {
-        m_messier = readObjects();
+    if (m_messier.empty()
+     && !loadCatalog()) {
+        auto file = m_fileLoader->find(messierDataFile);
+        if (!file.empty()) {
+            m_messier = readObjects(file);
+        }
+        else {
+            std::cout << "The messier data " << messierDataFile << " was not found!" << std::endl;
+        }
     }
     return m_messier;
 }
 
-std::list<std::shared_ptr<Messier>>
-MessierLoader::readObjects()
+// use the compiled catalog if available
+bool
+MessierLoader::loadCatalog()
+{
+    auto file = m_fileLoader->find(CatalogFile::CATALOG_FILE);
+    if (file.empty()) {
+        return false;
+    }
+    CatalogFile catalog;    // the few objects are copied
+    if (!catalog.map(file)) {
+        return false;
+    }
+    auto x = catalog.getSection<int16_t>(CatalogSectionType::MessierX);
+    auto y = catalog.getSection<int16_t>(CatalogSectionType::MessierY);
+    auto z = catalog.getSection<int16_t>(CatalogSectionType::MessierZ);
+    auto vmag = catalog.getSection<int16_t>(CatalogSectionType::MessierVmag);
+    auto names = catalog.getSection<MessierNameRecord>(CatalogSectionType::MessierName);
+    if (x.empty()
+     || y.size() != x.size()
+     || z.size() != x.size()
+     || vmag.size() != x.size()
+     || names.size() != x.size()) {
+        std::cout << "The catalog " << file << " has no usable messier data!" << std::endl;
+        return false;
+    }
+    UnitVectors vectors;
+    vectors.setQuantized(x, y, z);
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        auto messier = std::make_shared<Messier>();
+        messier->setRaDec(std::make_shared<RaDec>(vectors.toRaDec(i)));
+        messier->setName(std::string(names[i].name, strnlen(names[i].name, sizeof(names[i].name))));
+        messier->setVmagnitude(CatalogFile::toMagnitude(vmag[i]));
+        m_messier.emplace_back(std::move(messier));
+    }
+    return true;
+}
+
+std::vector<std::shared_ptr<Messier>>
+MessierLoader::readObjects(const std::string& file)
 {
-    std::list<std::shared_ptr<Messier>> messiers;
-    auto file = m_fileLoader->find(messierDataFile);
+    std::vector<std::shared_ptr<Messier>> messiers;
     if (!file.empty()) {
         try {
             JsonHelper jsonHelper;
@@ -121,8 +167,5 @@ MessierLoader::readObjects()
             std::cout << "The messier data was not be loaded exception " << exc.what() << "!" << std::endl;
         }
     }
-    else {
-        std::cout << "The messier data " << messierDataFile << " was not found!" << std::endl;
-    }
     return messiers;
 }
\ No newline at end of file
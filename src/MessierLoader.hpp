@@ -18,13 +18,15 @@
 
 #pragma once
 
-#include <list>
+#include <vector>
+#include <span>
 #include <memory>
 #include <JsonHelper.hpp>
 
 #include "FileLoader.hpp"
 #include "Messier.hpp"
 
+class CatalogFile;
 
 class MessierLoader
 {
@@ -33,16 +35,18 @@ public:
     explicit MessierLoader(const MessierLoader& orig) = delete;
     virtual ~MessierLoader() = default;
 
-    std::list<std::shared_ptr<Messier>> getMessiers();
+    std::span<const std::shared_ptr<Messier>> getMessiers();
     static double toDecimal(const Glib::ustring& xms);
+    // read the json format, used for the catalog compiler
+    static std::vector<std::shared_ptr<Messier>> readObjects(const std::string& file);
 protected:
-    std::list<std::shared_ptr<Messier>> readObjects();
-    std::shared_ptr<Messier> readMessier(JsonObject* m, JsonHelper& jsonHelper);
+    static std::shared_ptr<Messier> readMessier(JsonObject* m, JsonHelper& jsonHelper);
+    bool loadCatalog();
 
 private:
     static constexpr auto messierDataFile = "messier.json";
     std::shared_ptr<FileLoader> m_fileLoader;
-    std::list<std::shared_ptr<Messier>> m_messier;
+    std::vector<std::shared_ptr<Messier>> m_messier;
 
 };
 
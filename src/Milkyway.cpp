@@ -20,6 +20,7 @@
 
 #include "Milkyway.hpp"
 #include "FileLoader.hpp"
+#include "CatalogFile.hpp"
 
 // descr https://astronomy.stackexchange.com/questions/18229/milky-way-position-on-the-sky
 Milkyway::Milkyway(const std::shared_ptr<FileLoader>& fileLoader)
@@ -27,17 +28,73 @@ Milkyway::Milkyway(const std::shared_ptr<FileLoader>& fileLoader)
 {
 }
 
-std::list<std::shared_ptr<Poly>>
+void
+Milkyway::load()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+    if (!loadCatalog()) {
+        auto file = m_fileLoader->find(milkywayDataFile);
+        if (!file.empty()) {
+            for (auto& poly : readBounds(file)) {
+                m_store.add(poly->getUnitVectors(), poly->getIntensity());
+            }   // the store keeps the only copy, getBounds creates them again
+        }
+        else {
+            std::cout << "The milkyway data " << milkywayDataFile << " was not found!" << std::endl;
+        }
+    }
+    const auto& vertices = m_store.getVertices();
+    for (uint32_t item = 0; item < m_store.size(); ++item) {
+        const auto& line = m_store.getLine(item);
+        m_index.add(item, vertices, line.first, line.count);
+    }
+}
+
+std::span<const std::shared_ptr<Poly>>
 Milkyway::getBounds()
 {
-    if (m_bounds.empty()) {
-        m_bounds = readBounds();
+    load();
+    if (m_bounds.empty()) {     // only created on request
+        const auto& vertices = m_store.getVertices();
+        m_bounds.reserve(m_store.size());
+        for (auto& line : m_store.getLines()) {
+            auto poly = std::make_shared<Poly>();
+            poly->setIntensity(line.value);
+            if (vertices.isQuantized()) {
+                poly->setQuantized(vertices.getQuantizedX().subspan(line.first, line.count)
+                                 , vertices.getQuantizedY().subspan(line.first, line.count)
+                                 , vertices.getQuantizedZ().subspan(line.first, line.count));
+            }
+            else {
+                for (uint32_t i = 0; i < line.count; ++i) {
+                    poly->add(vertices.toRaDec(line.first + i));
+                }
+            }
+            m_bounds.push_back(poly);
+        }
     }
-    return m_bounds;	//??? give away internal structure
+    return m_bounds;
+}
+
+const PolylineStore&
+Milkyway::getStore()
+{
+    load();
+    return m_store;
+}
+
+const SkyIndex&
+Milkyway::getIndex()
+{
+    load();
+    return m_index;
 }
 
 void
-Milkyway::readFeature(JsonObject* feature, JsonHelper& jsonHelper, std::list<std::shared_ptr<Poly>>& polys)
+Milkyway::readFeature(JsonObject* feature, JsonHelper& jsonHelper, std::vector<std::shared_ptr<Poly>>& polys)
 {
     Glib::ustring id = json_object_get_string_member(feature, "id");
     auto ints = id.substr(2);   // e.g. "ol1" -> intensity 1
@@ -61,11 +118,46 @@ Milkyway::readFeature(JsonObject* feature, JsonHelper& jsonHelper, std::list<std
 }
 
 
-std::list<std::shared_ptr<Poly>>
-Milkyway::readBounds()
+// use the compiled catalog if available
+bool
+Milkyway::loadCatalog()
+{
+    auto file = m_fileLoader->find(CatalogFile::CATALOG_FILE);
+    if (file.empty()) {
+        return false;
+    }
+    auto catalog = std::make_shared<CatalogFile>();
+    if (!catalog->map(file)) {
+        return false;
+    }
+    auto x = catalog->getSection<int16_t>(CatalogSectionType::MilkywayX);
+    auto y = catalog->getSection<int16_t>(CatalogSectionType::MilkywayY);
+    auto z = catalog->getSection<int16_t>(CatalogSectionType::MilkywayZ);
+    auto polys = catalog->getSection<MilkywayPolyRecord>(CatalogSectionType::MilkywayPoly);
+    if (polys.empty()
+     || y.size() != x.size()
+     || z.size() != x.size()) {
+        std::cout << "The catalog " << file << " has no usable milkyway data!" << std::endl;
+        return false;
+    }
+    std::vector<PolylineInfo> lines;
+    lines.reserve(polys.size());
+    for (auto& rec : polys) {
+        if (static_cast<size_t>(rec.first) + rec.count > x.size()) {
+            std::cout << "The catalog " << file << " has a invalid milkyway poly!" << std::endl;
+            return false;
+        }
+        lines.push_back(PolylineInfo{rec.first, rec.count, rec.intensity, 0u});
+    }
+    m_store.setQuantized(x, y, z, std::move(lines));
+    m_catalog = catalog;    // keep mapping
+    return true;
+}
+
+std::vector<std::shared_ptr<Poly>>
+Milkyway::readBounds(const std::string& file)
 {
-    std::list<std::shared_ptr<Poly>> polys;
-    auto file = m_fileLoader->find(milkywayDataFile);
+    std::vector<std::shared_ptr<Poly>> polys;
     if (!file.empty()) {
         try {
             JsonHelper jsonHelper;
@@ -81,17 +173,20 @@ Milkyway::readBounds()
             std::cout << "The milkyway data was not be loaded exception " << exc.what() << "!" << std::endl;
         }
     }
-    else {
-        std::cout << "The milkyway data " << milkywayDataFile << " was not found!" << std::endl;
-    }
     return polys;
 }
 
+RaDec
+Milkyway::galacticCenter()
+{
+    RaDec raDec;
+    raDec.setRaDegrees(gaCentRa);
+    raDec.setDecDegrees(gaCentDec);
+    return raDec;
+}
+
 std::shared_ptr<RaDec>
 Milkyway::getGalacticCenter()
 {
-    auto raDec = std::make_shared<RaDec>();
-    raDec->setRaDegrees(gaCentRa);
-    raDec->setDecDegrees(gaCentDec);
-    return raDec;
+    return std::make_shared<RaDec>(galacticCenter());
 }
@@ -19,12 +19,16 @@
 #pragma once
 
 #include <gtkmm.h>
-#include <list>
+#include <vector>
+#include <span>
 #include <memory>
 
 #include "Poly.hpp"
+#include "SkyIndex.hpp"
+#include "PolylineStore.hpp"
 
 class FileLoader;
+class CatalogFile;
 
 class Milkyway
 {
@@ -33,18 +37,31 @@ public:
     explicit Milkyway(const Milkyway& orig) = delete;
     virtual ~Milkyway() = default;
 
-    std::list<std::shared_ptr<Poly>> getBounds();
+    // compatibility, created on request from the store, prefer getStore
+    std::span<const std::shared_ptr<Poly>> getBounds();
+    // the polylines use the intensity as value, same order as getBounds
+    const PolylineStore& getStore();
+    // the items are the polylines of the store
+    const SkyIndex& getIndex();
+    static RaDec galacticCenter();
+    // compatibility, allocates
     std::shared_ptr<RaDec> getGalacticCenter();
+    // read the json format, used for the catalog compiler
+    static std::vector<std::shared_ptr<Poly>> readBounds(const std::string& file);
 protected:
-    void readFeature(JsonObject* feature, JsonHelper& jsonHelper, std::list<std::shared_ptr<Poly>>& polys);
-
-    std::list<std::shared_ptr<Poly>> readBounds();
+    static void readFeature(JsonObject* feature, JsonHelper& jsonHelper, std::vector<std::shared_ptr<Poly>>& polys);
+    bool loadCatalog();
+    void load();
 private:
     // see https://en.wikipedia.org/wiki/Milky_Way
     static constexpr auto gaCentRa = 102.761121;
     static constexpr auto gaCentDec = -29.007825;
     static constexpr auto milkywayDataFile = "mw.json";
     std::shared_ptr<FileLoader> m_fileLoader;
-    std::list<std::shared_ptr<Poly>> m_bounds;
+    bool m_loaded{false};
+    std::vector<std::shared_ptr<Poly>> m_bounds;
+    PolylineStore m_store;
+    SkyIndex m_index;
+    std::shared_ptr<CatalogFile> m_catalog;
 };
 
@@ -28,6 +28,7 @@
 #include "Math.hpp"
 #include "FileLoader.hpp"
 #include "Module.hpp"
+#include "Compositor.hpp"
 
 std::string
 Module::getName()
@@ -51,8 +52,22 @@ Module::setPrimaryColor(const Gdk::RGBA& primColor)
 void
 Module::getPrimaryColor(const Cairo::RefPtr<Cairo::Context>& ctx)
 {
-    auto primColor = getPrimaryColor();
-    ctx->set_source_rgb(primColor.get_red(), primColor.get_green(), primColor.get_blue());
+    setSource(ctx, getPrimaryColor());
+}
+
+void
+Module::setSource(const Cairo::RefPtr<Cairo::Context>& ctx, const Gdk::RGBA& color, double alpha)
+{
+    ctx->set_source_rgba(color.get_red(), color.get_green(), color.get_blue(), alpha);
+}
+
+void
+Module::display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin)
+{
+    auto error = prepareDisplay(starWin)(ctx);
+    if (!error.empty()) {
+        starWin->showMessage(error, Gtk::MessageType::MESSAGE_ERROR);
+    }
 }
 
 
@@ -102,6 +117,7 @@ Module::setupParam(const Glib::RefPtr<Gtk::Builder>& builder
     builder->get_widget(colorId, m_color);
     m_color->set_rgba(getPrimaryColor());
     m_color->signal_color_set().connect([this,starWin] {
+        auto lock = starWin->lockPaint();
         setPrimaryColor(m_color->get_rgba());
         starWin->update();
     });
@@ -109,6 +125,7 @@ Module::setupParam(const Glib::RefPtr<Gtk::Builder>& builder
     builder->get_widget(fontId, m_font);
     m_font->set_font_name(getFont().to_string());
     m_font->signal_font_set().connect([this,starWin] {
+        auto lock = starWin->lockPaint();
         Pango::FontDescription fontDesc{m_font->get_font_name()};
         setFont(fontDesc);
         starWin->update();
@@ -118,6 +135,7 @@ Module::setupParam(const Glib::RefPtr<Gtk::Builder>& builder
     fillPos(m_pos);
     m_pos->set_active_id(getPosition());
     m_pos->signal_changed().connect([this,starWin] {
+        auto lock = starWin->lockPaint();
         setPosition(m_pos->get_active_id());
         starWin->update();
     });
@@ -155,20 +173,23 @@ Module::saveParam(bool save)
 std::shared_ptr<PyClass>
 Module::checkPyClass(StarWin* starWin, const char* className)
 {
+    auto pyClass = getPyClass();
 #   ifdef USE_PYTHON
-    if (!m_pyClass || m_pyClass->isUpdated()) {
+    if (!pyClass || pyClass->isUpdated()) {
         m_fileLoader = starWin->getFileLoader();
         auto infoScript = m_pyWrapper->load(m_fileLoader, className, getPyScriptName());
         if (infoScript) {
             if (infoScript->hasFailed()) {
                 std::cout << "Module::checkPyClass has failed err " <<infoScript->getError() << std::endl;
-                if (m_pyClass) {
-                    m_pyClass->setSourceModified();    // keep old version, but adjust modified so we don't popup again
+                if (pyClass) {
+                    pyClass->setSourceModified();    // keep old version, but adjust modified so we don't popup again
                 }
                 starWin->showMessage(infoScript->getError(), Gtk::MessageType::MESSAGE_ERROR);
             }
             else {
+                std::lock_guard<std::mutex> lock(m_pyClassMutex);
                 m_pyClass = infoScript;
+                pyClass = infoScript;
             }
         }
         else {
@@ -176,6 +197,13 @@ Module::checkPyClass(StarWin* starWin, const char* className)
         }
     }
 #   endif
+    return pyClass;
+}
+
+std::shared_ptr<PyClass>
+Module::getPyClass()
+{
+    std::lock_guard<std::mutex> lock(m_pyClassMutex);
     return m_pyClass;
 }
 
@@ -230,17 +258,77 @@ Module::fileChanged(const Glib::RefPtr<Gio::File>& file, const Glib::RefPtr<Gio:
     }
 }
 
+int
+Module::measure(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin)
+{
+    const size_t layoutKey = getLayoutKey(starWin);
+    if (!m_measured
+     || layoutKey != m_layoutKey) {
+        m_measuredHeight = getHeight(ctx, starWin);
+        m_layoutKey = layoutKey;
+        m_measured = true;
+    }
+    return m_measuredHeight;
+}
+
+int
+Module::getMeasuredHeight() const
+{
+    return m_measuredHeight;
+}
+
+size_t
+Module::getLayoutKey(StarWin* starWin)
+{
+    return std::hash<std::string>{}(getFont().to_string().raw());
+}
+
+void
+Module::invalidateLayout()
+{
+    m_measured = false;
+}
+
+size_t
+Module::getDisplayKey(StarWin* starWin)
+{
+    size_t key = getContentKey(starWin);
+    if (key == Compositor::UNCACHED) {
+        return key;
+    }
+    key = Compositor::combine(key, getLayoutKey(starWin));
+    key = Compositor::combine(key, std::hash<std::string>{}(getPrimaryColor().to_string().raw()));
+    return key == Compositor::UNCACHED ? 1u : key;
+}
+
+size_t
+Module::getContentKey(StarWin* starWin)
+{
+    return Compositor::UNCACHED;
+}
+
+uint32_t
+Module::getUpdateSeconds()
+{
+    return 0u;
+}
+
 void
 Module::edit(StarWin* starWin)
 {
 #   ifdef USE_PYTHON
-    auto localScriptFile = m_pyClass->getLocalPyFile();
+    auto pyClass = getPyClass();
+    if (!pyClass) {
+        std::cout << "Module::edit the script of " << m_name << " is not loaded" << std::endl;
+        return;
+    }
+    auto localScriptFile = pyClass->getLocalPyFile();
     if (!localScriptFile->query_exists()) {
         auto scriptDir = localScriptFile->get_parent();
         if (!scriptDir->query_exists()) {
             scriptDir->make_directory_with_parents();
         }
-        auto globalScriptFile = m_pyClass->getPyFile();
+        auto globalScriptFile = pyClass->getPyFile();
         globalScriptFile->copy(localScriptFile);    // for editing create a local copy
     }
     if (!m_fileMonitor) {
@@ -291,7 +379,11 @@ Glib::ustring
 Module::getEditInfo()
 {
 #   ifdef USE_PYTHON
-    auto localScriptFile = m_pyClass->getLocalPyFile();
+    auto pyClass = getPyClass();
+    if (!pyClass) {
+        return "";
+    }
+    auto localScriptFile = pyClass->getLocalPyFile();
     return Glib::ustring::sprintf("Script (%s)", localScriptFile->query_exists() ? "local" : "global");
 #   endif
     return "";
@@ -19,6 +19,8 @@
 #pragma once
 
 #include <gtkmm.h>
+#include <mutex>
+#include <functional>
 #include <KeyConfig.hpp>
 
 #include "FileLoader.hpp"
@@ -46,12 +48,36 @@ public:
     virtual ~Module() = default;
 
     virtual int getHeight(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin) = 0;
-    virtual void display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin) = 0;
+    // the height of getHeight, that is only called again if the layout key changed
+    int measure(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin);
+    // the height of the last measure
+    int getMeasuredHeight() const;
+    // identifies the inputs of getHeight e.g. the font
+    virtual size_t getLayoutKey(StarWin* starWin);
+    // measure again on next use e.g. after the script changed
+    void invalidateLayout();
+    // draws with the values copied by prepareDisplay, so it may run on a worker
+    //   without reaching the config, the module or the window,
+    //   returns the error to show or a empty string
+    using DisplayFunc = std::function<std::string(const Cairo::RefPtr<Cairo::Context>& ctx)>;
+    // on the (locked) drawing path, copies the style and content the display needs
+    virtual DisplayFunc prepareDisplay(StarWin* starWin) = 0;
+    // prepares and draws, showing a error
+    void display(const Cairo::RefPtr<Cairo::Context>& ctx, StarWin* starWin);
     virtual void setupParam(const Glib::RefPtr<Gtk::Builder>& builder, StarWin* starWin) = 0;
+    // identifies the displayed content, the cached display is reused while this is unchanged,
+    //   0 (Compositor::UNCACHED) displays on each update
+    virtual size_t getContentKey(StarWin* starWin);
+    // the content key including the style (font, color) used by the compositor
+    size_t getDisplayKey(StarWin* starWin);
+    // the seconds the content changes at, aligned to the local time,
+    //   0 if it changes only with the settings
+    virtual uint32_t getUpdateSeconds();
     std::string getName();  // used as config group name
     Gdk::RGBA getPrimaryColor();
     void setPrimaryColor(const Gdk::RGBA& primColor);
     void getPrimaryColor(const Cairo::RefPtr<Cairo::Context>& ctx);
+    static void setSource(const Cairo::RefPtr<Cairo::Context>& ctx, const Gdk::RGBA& color, double alpha = 1.0);
     Glib::ustring getPosition();
     void setPosition(const Glib::ustring& position);
     Pango::FontDescription getFont();
@@ -73,6 +99,8 @@ public:
 protected:
     void fillPos(Gtk::ComboBoxText* pos);
     std::shared_ptr<PyClass> checkPyClass(StarWin* starWin, const char* className);
+    // the script may be replaced while drawing on a worker, take a copy to use it
+    std::shared_ptr<PyClass> getPyClass();
     void setupParam(const Glib::RefPtr<Gtk::Builder>& builder
             , StarWin* starWin
             , const char* colorId
@@ -87,11 +115,15 @@ protected:
     std::shared_ptr<KeyConfig> m_config;
     std::shared_ptr<PyWrapper> m_pyWrapper;
     std::shared_ptr<FileLoader> m_fileLoader;
+    std::mutex m_pyClassMutex;
     std::shared_ptr<PyClass> m_pyClass;
     Glib::RefPtr<Gio::FileMonitor> m_fileMonitor;
     Gtk::ColorButton* m_color;
     Gtk::FontButton* m_font;
     Gtk::ComboBoxText* m_pos;
+    size_t m_layoutKey{};
+    bool m_measured{false};
+    int m_measuredHeight{};
 };
 
 using PtrModule = std::shared_ptr<Module>;
@@ -0,0 +1,185 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <iostream>
+#include <algorithm>
+
+#include "ModuleWorker.hpp"
+
+ModuleWorker::ModuleWorker()
+: m_state{std::make_shared<State>()}
+{
+    m_state->lateDispatcher = &m_lateDispatcher;
+    m_lateDispatcher.connect([this] {
+        m_signalLate.emit();
+    });
+    m_thread = std::thread(&ModuleWorker::run, m_state);
+}
+
+ModuleWorker::~ModuleWorker()
+{
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->stop = true;
+    m_state->jobs.clear();
+    m_state->lateDispatcher = nullptr;
+    m_state->jobCondition.notify_one();
+    const bool idle = m_state->stateCondition.wait_for(lock, STOP_GRACE, [this] {
+        return m_state->running.empty();
+    });
+    lock.unlock();
+    if (!m_thread.joinable()) {
+        return;
+    }
+    if (idle) {
+        m_thread.join();
+    }
+    else {
+        // a script that does not return, the thread keeps the state and the job (only copied values)
+        std::cout << "ModuleWorker::~ModuleWorker module " << m_state->running
+                  << " still drawing, left behind" << std::endl;
+        m_thread.detach();
+    }
+}
+
+void
+ModuleWorker::submit(const std::string& name, size_t key, int width, int height, int padding, DrawFunc&& draw)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->jobs.push_back(Job{name, key, width, height, padding, std::move(draw)});
+    }
+    m_state->jobCondition.notify_one();
+}
+
+bool
+ModuleWorker::wait(std::chrono::milliseconds budget)
+{
+    auto& state = *m_state;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.jobs.empty() || !state.running.empty()) {
+        if (!state.running.empty()
+         && budget != NO_BUDGET) {
+            auto deadline = state.runStart + budget;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                if (!state.runReported) {
+                    state.runReported = true;
+                    ++m_overruns;
+                    std::cout << "ModuleWorker::wait module " << state.running
+                              << " exceeded " << budget.count() << "ms, using the last image" << std::endl;
+                }
+                state.jobs.clear();     // submitted again with the next image
+                return false;
+            }
+            state.stateCondition.wait_until(lock, deadline);
+        }
+        else {
+            state.stateCondition.wait(lock);
+        }
+    }
+    return true;
+}
+
+bool
+ModuleWorker::isBusy(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_state->running == name) {
+        return true;
+    }
+    return std::any_of(m_state->jobs.begin(), m_state->jobs.end(), [&name] (const Job& job) {
+        return job.name == name;
+    });
+}
+
+void
+ModuleWorker::take(std::vector<Result>& results)
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    for (auto& result : m_state->results) {
+        results.push_back(std::move(result));
+    }
+    m_state->results.clear();
+}
+
+uint64_t
+ModuleWorker::getOverruns() const
+{
+    return m_overruns.load();
+}
+
+sigc::signal<void()>
+ModuleWorker::signal_late()
+{
+    return m_signalLate;
+}
+
+void
+ModuleWorker::run(std::shared_ptr<State> state)
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->jobCondition.wait(lock, [&state] {
+                return state->stop || !state->jobs.empty();
+            });
+            if (state->stop) {
+                break;
+            }
+            job = std::move(state->jobs.front());
+            state->jobs.pop_front();
+            state->running = job.name;
+            state->runStart = std::chrono::steady_clock::now();
+            state->runReported = false;
+        }
+        state->stateCondition.notify_all();     // the wait starts the budget
+        Result result{job.name, job.key, {}, {}};
+        try {
+            result.surface = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, job.width, job.height);
+            auto ctx = Cairo::Context::create(result.surface);
+            ctx->translate(job.padding, job.padding);
+            result.error = job.draw(ctx);
+            result.surface->flush();
+        }
+        catch (const std::exception& exc) {
+            std::cout << "ModuleWorker::run error " << exc.what() << std::endl;
+            result.surface.clear();
+        }
+        catch (const Glib::Error& exc) {
+            std::cout << "ModuleWorker::run error " << exc.what() << std::endl;
+            result.surface.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (result.surface) {
+                // a late result of the same module replaces the older
+                std::erase_if(state->results, [&result] (const Result& done) {
+                    return done.name == result.name;
+                });
+                state->results.push_back(std::move(result));
+                if (state->runReported
+                 && state->lateDispatcher) {
+                    state->lateDispatcher->emit();  // the image was finished without it
+                }
+            }
+            state->running.clear();
+        }
+        state->stateCondition.notify_all();
+    }
+}
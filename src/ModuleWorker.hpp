@@ -0,0 +1,110 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <gtkmm.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <functional>
+
+/**
+ * displays the modules on its own thread (for python the only one calling the scripts),
+ *   so they are drawn while the sky is painted.
+ *   Each module gets a budget, if it runs longer the image
+ *   is finished with the last good layer of the module,
+ *   the late result is signaled and used by a following image.
+ *   A module that is queued or drawing is owned by the worker,
+ *   don't use it from other threads until it is no longer busy.
+ *   The modules are identified by name, the draw function displays them
+ *   from values copied when submitted (it must not reach the window or the config).
+ *   The thread keeps its state, so a script that does not return
+ *   is left behind on destruction instead of blocking.
+ */
+class ModuleWorker
+{
+public:
+    ModuleWorker();
+    explicit ModuleWorker(const ModuleWorker& orig) = delete;
+    virtual ~ModuleWorker();
+
+    // returns the error to show or a empty string
+    using DrawFunc = std::function<std::string(const Cairo::RefPtr<Cairo::Context>& ctx)>;
+    struct Result
+    {
+        std::string name;
+        size_t key;
+        Cairo::RefPtr<Cairo::ImageSurface> surface;
+        std::string error;
+    };
+    static constexpr std::chrono::milliseconds NO_BUDGET{std::chrono::milliseconds::max()};
+    static constexpr std::chrono::milliseconds STOP_GRACE{2000};    // a module still drawing on destruction is left after this
+
+    // draw the module into a new surface of width x height, offset by padding
+    void submit(const std::string& name, size_t key, int width, int height, int padding, DrawFunc&& draw);
+    // wait until the submitted modules are drawn or the running one exceeds the budget,
+    //   on a overrun the modules not yet started are dropped and false is returned
+    bool wait(std::chrono::milliseconds budget);
+    bool isBusy(const std::string& name);
+    // moves the finished surfaces into results, the surfaces are owned by the caller
+    void take(std::vector<Result>& results);
+    // the modules that exceeded their budget
+    uint64_t getOverruns() const;
+    // emitted on the main thread when a module that exceeded its budget finished
+    sigc::signal<void()> signal_late();
+
+protected:
+    struct Job
+    {
+        std::string name;
+        size_t key;
+        int width;
+        int height;
+        int padding;
+        DrawFunc draw;
+    };
+    // shared with the thread, that may outlive the worker
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable jobCondition;
+        std::condition_variable stateCondition;     // a job started or finished
+        std::deque<Job> jobs;
+        std::string running;                        // empty if idle
+        std::chrono::steady_clock::time_point runStart;
+        bool runReported{false};
+        std::vector<Result> results;
+        bool stop{false};
+        Glib::Dispatcher* lateDispatcher{nullptr};  // cleared on stop
+    };
+    static void run(std::shared_ptr<State> state);
+
+private:
+    std::shared_ptr<State> m_state;
+    Glib::Dispatcher m_lateDispatcher;
+    sigc::signal<void()> m_signalLate;
+    std::atomic<uint64_t> m_overruns{0u};
+    std::thread m_thread;                   // last, started with all members ready
+};
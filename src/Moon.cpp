@@ -41,7 +41,14 @@ Moon::cosd(double r)
 
 //Low precision geocentric moon position (RA,DEC) from Astronomical Almanac page D22 (2017 ed)
 std::shared_ptr<RaDec>
-Moon::position(const JulianDate& jd) {
+Moon::position(const JulianDate& jd)
+{
+    return std::make_shared<RaDec>(raDec(jd));
+}
+
+RaDec
+Moon::raDec(const JulianDate& jd)
+{
 	double T = jd.toJulianDateE2000centuries();
 	double L = 218.32 + 481267.881*T + 6.29 * sind(135.0 + 477198.87 * T) - 1.27 * sind(259.3 - 413335.36 * T) + 0.66 * sind(235.7 + 890534.22 * T) + 0.21*sind(269.9 + 954397.74 * T) - 0.19*sind(357.5 + 35999.05 * T) - 0.11*sind(186.5 + 966404.03 * T);
 	double B = 5.13 * sind(93.3 + 483202.02 * T) + 0.28 * sind(228.2 + 960400.89 * T) - 0.28 * sind(318.3 + 6003.15 * T) - 0.17 * sind(217.6 - 407332.21 * T);
@@ -57,7 +64,7 @@ Moon::position(const JulianDate& jd) {
 	    ra += Math::TWO_PI;
 	}
 	double dec = std::asin(n);
-	return std::make_shared<RaDec>(ra, dec);
+	return RaDec(ra, dec);
 }
 
 double
@@ -36,6 +36,8 @@ public:
 
 
     //Low precision geocentric moon position (RA,DEC) from Astronomical Almanac page D22 (2017 ed)
+    static RaDec raDec(const JulianDate& jd);
+    // compatibility, allocates
     static std::shared_ptr<RaDec> position(const JulianDate& jd);
 
 
@@ -52,6 +52,7 @@ ParamDlg::ParamDlg(BaseObjectType* cobject
     builder->get_widget("startColor", m_startColor);
     m_startColor->set_rgba(starPaint->getStartColor());
     m_startColor->signal_color_set().connect([this, starPaint] {
+        auto lock = starPaint->lock();
         starPaint->setStartColor(m_startColor->get_rgba());
         m_starWin->update();
     });
@@ -59,6 +60,7 @@ ParamDlg::ParamDlg(BaseObjectType* cobject
     builder->get_widget("stopColor", m_stopColor);
     m_stopColor->set_rgba(starPaint->getStopColor());
     m_stopColor->signal_color_set().connect([this, starPaint] {
+        auto lock = starPaint->lock();
         starPaint->setStopColor(m_stopColor->get_rgba());
         m_starWin->update();
     });
@@ -66,6 +68,7 @@ ParamDlg::ParamDlg(BaseObjectType* cobject
     builder->get_widget("starFont", m_starFont);
     m_starFont->set_font_name(m_starWin->getStarPaint()->getStarFont().to_string());
     m_starFont->signal_font_set().connect([this, starPaint] {
+        auto lock = starPaint->lock();
         Pango::FontDescription starFont{m_starFont->get_font_name()};
         starPaint->setStarFont(starFont);
         m_starWin->update();
@@ -74,6 +77,7 @@ ParamDlg::ParamDlg(BaseObjectType* cobject
     builder->get_widget("showMilkyway", m_showMilkyway);
     m_showMilkyway->set_active(m_starWin->getStarPaint()->isShowMilkyway());
     m_showMilkyway->signal_clicked().connect([this,starPaint] {
+        auto lock = starPaint->lock();
         starPaint->setShowMilkyway(m_showMilkyway->get_active());
         m_starWin->update();
     });
@@ -81,6 +85,7 @@ ParamDlg::ParamDlg(BaseObjectType* cobject
     builder->get_widget("messierVMag", m_messierVMag);
     m_messierVMag->set_value(m_starWin->getStarPaint()->getMessierVMagMin());
     m_messierVMag->signal_value_changed().connect([this,starPaint] {
+        auto lock = starPaint->lock();
         starPaint->setMessierVMagMin(m_messierVMag->get_value());
         m_starWin->update();
     });
@@ -96,6 +101,8 @@ void
 ParamDlg::on_response(int response_id)
 {
     bool save = false;
+    auto starPaint = m_starWin->getStarPaint();
+    auto lock = starPaint->lock();
     if (response_id == Gtk::RESPONSE_OK) {
         m_starWin->setIntervalMinutes(m_updateInterval->get_value_as_int());
         if (m_starWin->getBackgroundAppl()->isDaemon()) {
@@ -108,7 +115,6 @@ ParamDlg::on_response(int response_id)
                 std::cout << "Error parsing select display " << nMonitor << std::endl;
             }
         }
-        auto starPaint = m_starWin->getStarPaint();
         starPaint->setStartColor(m_startColor->get_rgba());
         starPaint->setStopColor(m_stopColor->get_rgba());
         Pango::FontDescription starFont{m_starFont->get_font_name()};
@@ -117,7 +123,7 @@ ParamDlg::on_response(int response_id)
         starPaint->setMessierVMagMin(m_messierVMag->get_value());
         save = true;
     }
-    for (auto& mod : m_starWin->getStarPaint()->getModules()) {
+    for (auto& mod : starPaint->getModules()) {
         mod->saveParam(save);
     }
 }
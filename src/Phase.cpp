@@ -48,3 +48,8 @@ Phase::isWanning() const
     return i >= Math::PI;
 }
 
+double
+Phase::getAngle() const
+{
+    return i;
+}
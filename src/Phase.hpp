@@ -38,6 +38,8 @@ public:
 
     // true waning (growing), false waxing (shrinking)
     bool isWanning() const;
+    // as given 0..2pi
+    double getAngle() const;
 
 private:
     double i;		// values 0..pi..2pi, full -> new -> full
@@ -0,0 +1,483 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "PixelRenderer.hpp"
+#include "Math.hpp"
+
+PixelGradient::PixelGradient(double cx, double cy, double r0, double r1)
+: RenderGradient()
+{
+    m_gradient.cx = cx;
+    m_gradient.cy = cy;
+    m_gradient.r0 = r0;
+    m_gradient.r1 = r1;
+}
+
+void
+PixelGradient::addColorStop(double pos, RenderColor& rgba)
+{
+    auto color = RasterPaint::premultiply(rgba.getRed(), rgba.getGreen(), rgba.getBlue(), rgba.getAlpha());
+    auto iter = std::upper_bound(m_gradient.stops.begin(), m_gradient.stops.end(), pos
+                               , [] (double p, const auto& stop) {
+        return p < stop.first;
+    });
+    m_gradient.stops.insert(iter, std::pair(pos, color));
+}
+
+void
+PixelGradient::addColorStop(double pos, Gdk::RGBA& rgba)
+{
+    RenderColor color(rgba.get_red(), rgba.get_green(), rgba.get_blue(), rgba.get_alpha());
+    addColorStop(pos, color);
+}
+
+std::shared_ptr<RasterGradient>
+PixelGradient::getGradient(double tx, double ty)
+{
+    auto gradient = std::make_shared<RasterGradient>(m_gradient);
+    gradient->cx += tx;
+    gradient->cy += ty;
+    return gradient;
+}
+
+PixelText::PixelText(const Glib::RefPtr<Pango::Layout>& layout, const Pango::FontDescription& fontDesc)
+: m_layout{layout}
+, m_font{fontDesc.to_string()}
+{
+}
+
+void
+PixelText::setText(const Glib::ustring& text)
+{
+    m_layout->set_text(text);
+}
+
+void
+PixelText::getSize(double& width, double& height)
+{
+    int iwidth{}, iheigh{};
+    m_layout->get_pixel_size(iwidth, iheigh);
+    width = static_cast<double>(iwidth);
+    height = static_cast<double>(iheigh);
+}
+
+Glib::RefPtr<Pango::Layout>
+PixelText::getLayout()
+{
+    return m_layout;
+}
+
+Glib::ustring
+PixelText::getKey()
+{
+    return m_font + "\n" + m_layout->get_text();
+}
+
+PixelRenderer::PixelRenderer(const Cairo::RefPtr<Cairo::ImageSurface>& surface, BandPool* pool)
+: m_surface{surface}
+, m_rasterizer{reinterpret_cast<uint32_t*>(surface->get_data())
+              , surface->get_width(), surface->get_height(), surface->get_stride()}
+, m_pool{pool}
+{
+    m_surface->flush();     // we write directly
+    // only used to layout text
+    auto textSurface = Cairo::ImageSurface::create(Cairo::Format::FORMAT_A8, 1, 1);
+    m_textCtx = Cairo::Context::create(textSurface);
+}
+
+PixelRenderer::~PixelRenderer()
+{
+    finish();
+}
+
+void
+PixelRenderer::finish()
+{
+    if (m_rasterizer.getShapeCount() > 0) {
+        m_rasterizer.render(m_pool);
+        m_surface->mark_dirty();
+    }
+}
+
+void
+PixelRenderer::setAtlas(const std::shared_ptr<SpriteAtlas>& atlas)
+{
+    m_atlas = atlas;
+}
+
+std::shared_ptr<RenderGradient>
+PixelRenderer::createRadialGradient(double x0, double y0, double r0, double x1, double y1, double r1)
+{
+    // we only use concentric gradients
+    return std::make_shared<PixelGradient>(x1, y1, r0, r1);
+}
+
+void
+PixelRenderer::setSource(std::shared_ptr<RenderGradient>& grad)
+{
+    auto pixelGradient = std::dynamic_pointer_cast<PixelGradient>(grad);
+    if (pixelGradient) {
+        m_state.paint = RasterPaint{f32x4{}, pixelGradient->getGradient(m_state.tx, m_state.ty)};
+    }
+    else {
+        std::cout << "PixelRenderer::setSource wrong instance given!" << std::endl;
+    }
+}
+
+void
+PixelRenderer::rectangle(double x0, double y0, double width, double height)
+{
+    moveTo(x0, y0);
+    lineTo(x0 + width, y0);
+    lineTo(x0 + width, y0 + height);
+    lineTo(x0, y0 + height);
+    closePath();
+}
+
+void
+PixelRenderer::fill()
+{
+    m_rasterizer.fill(m_state.paint);
+}
+
+void
+PixelRenderer::translate(double x0, double y0)
+{
+    m_state.tx += x0;
+    m_state.ty += y0;
+}
+
+// as cairo arc connects to a current point
+void
+PixelRenderer::circle(double x0, double y0, double r)
+{
+    const double px = x0 + m_state.tx;
+    const double py = y0 + m_state.ty;
+    int segments{8};
+    if (r > CIRCLE_TOLERANCE) {
+        segments = std::max(segments, static_cast<int>(std::ceil(Math::PI / std::acos(1.0 - CIRCLE_TOLERANCE / r))));
+    }
+    if (m_rasterizer.hasPath()) {
+        m_rasterizer.lineTo(px + r, py);
+    }
+    else {
+        m_rasterizer.moveTo(px + r, py);
+    }
+    for (int i = 1; i <= segments; ++i) {
+        const double a = Math::TWO_PI * static_cast<double>(i) / static_cast<double>(segments);
+        m_rasterizer.lineTo(px + r * std::cos(a), py + r * std::sin(a));
+    }
+    m_curX = px + r;
+    m_curY = py;
+}
+
+void
+PixelRenderer::clip()
+{
+    m_rasterizer.clip();
+    m_state.clip = m_rasterizer.getClip();
+}
+
+void
+PixelRenderer::setSource(RenderColor& rgba)
+{
+    m_state.paint = RasterPaint{RasterPaint::premultiply(rgba.getRed(), rgba.getGreen(), rgba.getBlue(), rgba.getAlpha()), nullptr};
+}
+
+void
+PixelRenderer::setTrueSource(RenderColor& rgba)
+{
+    setSource(rgba);
+}
+
+std::shared_ptr<RenderText>
+PixelRenderer::createText(Pango::FontDescription& fontDesc)
+{
+    auto pangoLayout = Pango::Layout::create(m_textCtx);
+    pangoLayout->set_font_description(fontDesc);
+    return std::make_shared<PixelText>(pangoLayout, fontDesc);
+}
+
+void
+PixelRenderer::moveTo(double x, double y)
+{
+    m_curX = x + m_state.tx;
+    m_curY = y + m_state.ty;
+    m_rasterizer.moveTo(m_curX, m_curY);
+}
+
+void
+PixelRenderer::lineTo(double x, double y)
+{
+    m_curX = x + m_state.tx;
+    m_curY = y + m_state.ty;
+    m_rasterizer.lineTo(m_curX, m_curY);
+}
+
+// the text is rendered once as mask, with the margin for overhanging glyphs
+Cairo::RefPtr<Cairo::ImageSurface>
+PixelRenderer::getTextMask(const std::shared_ptr<PixelText>& text, int width, int height)
+{
+    auto key = text->getKey();
+    auto entry = m_textMasks.find(key);
+    if (entry != m_textMasks.end()) {
+        return entry->second;
+    }
+    auto mask = Cairo::ImageSurface::create(Cairo::Format::FORMAT_A8, width + 2 * TEXT_MARGIN, height + 2 * TEXT_MARGIN);
+    auto ctx = Cairo::Context::create(mask);
+    ctx->move_to(TEXT_MARGIN, TEXT_MARGIN);
+    text->getLayout()->show_in_cairo_context(ctx);
+    mask->flush();
+    m_textMasks.insert(std::pair(key, mask));
+    return mask;
+}
+
+void
+PixelRenderer::mask(const Cairo::RefPtr<Cairo::ImageSurface>& mask, int left, int top, const RasterPaint& paint)
+{
+    m_rasterizer.mask(mask->get_data(), mask->get_width(), mask->get_height(), mask->get_stride(), left, top, paint);
+}
+
+void
+PixelRenderer::showText(std::shared_ptr<RenderText>& text, double x, double y, TextAlign textAlign)
+{
+    auto pixelText = std::dynamic_pointer_cast<PixelText>(text);
+    if (pixelText) {
+        double width;
+        double height;
+        pixelText->getSize(width, height);
+        switch (textAlign) {
+            case TextAlign::LeftTop:
+                break;      // use as is
+            case TextAlign::LeftBottom:
+                y -= height;
+                break;
+            case TextAlign::LeftMid:
+                y -= height / 2.0;
+                break;
+            case TextAlign::RightMid:
+                x -= width;
+                y -= height / 2.0;
+                break;
+        }
+        auto textMask = getTextMask(pixelText, static_cast<int>(width), static_cast<int>(height));
+        mask(textMask
+           , static_cast<int>(std::lround(x + m_state.tx)) - TEXT_MARGIN
+           , static_cast<int>(std::lround(y + m_state.ty)) - TEXT_MARGIN
+           , m_state.paint);
+    }
+    else {
+        std::cout << "PixelRenderer::showText wrong instance given!" << std::endl;
+    }
+}
+
+void
+PixelRenderer::save()
+{
+    m_stack.push_back(m_state);
+}
+
+void
+PixelRenderer::restore()
+{
+    if (!m_stack.empty()) {
+        m_state = m_stack.back();
+        m_stack.pop_back();
+        m_rasterizer.setClip(m_state.clip);
+    }
+}
+
+void
+PixelRenderer::beginNewPath()
+{
+    m_rasterizer.newPath();
+}
+
+void
+PixelRenderer::setLineWidth(double width)
+{
+    m_state.lineWidth = width;
+}
+
+// same argument order as CairoRenderer::curveTo, to give the same shapes
+void
+PixelRenderer::curveTo(double x, double y, double e0, double r0, double e1, double r1)
+{
+    const double x0 = m_curX;
+    const double y0 = m_curY;
+    const double x1 = x + m_state.tx;
+    const double y1 = y + m_state.ty;
+    const double x2 = e1 + m_state.tx;
+    const double y2 = r0 + m_state.ty;
+    const double x3 = e0 + m_state.tx;
+    const double y3 = r1 + m_state.ty;
+    for (int i = 1; i <= CURVE_SEGMENTS; ++i) {
+        const double t = static_cast<double>(i) / static_cast<double>(CURVE_SEGMENTS);
+        const double mt = 1.0 - t;
+        const double a = mt * mt * mt;
+        const double b = 3.0 * mt * mt * t;
+        const double c = 3.0 * mt * t * t;
+        const double d = t * t * t;
+        m_rasterizer.lineTo(a * x0 + b * x1 + c * x2 + d * x3
+                          , a * y0 + b * y1 + c * y2 + d * y3);
+    }
+    m_curX = x3;
+    m_curY = y3;
+}
+
+void
+PixelRenderer::closePath()
+{
+    m_rasterizer.closePath();
+}
+
+void
+PixelRenderer::stroke()
+{
+    m_rasterizer.stroke(m_state.lineWidth, m_state.paint);
+}
+
+void
+PixelRenderer::paint()
+{
+    m_rasterizer.paint(m_state.paint);
+}
+
+void
+PixelRenderer::dot(double x, double y, double r)
+{
+    if (m_atlas && m_atlas->isCached(r)) {
+        int left, top;
+        auto sprite = m_atlas->getDisc(x + m_state.tx, y + m_state.ty, r, left, top);
+        mask(sprite, left, top, m_state.paint);
+        return;
+    }
+    m_rasterizer.newPath();
+    circle(x, y, r);
+    fill();
+}
+
+void
+PixelRenderer::diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop)
+{
+    // the sprite covers fading out a single color (as used for messier)
+    if (m_atlas && m_atlas->isCached(r)
+     && start.getRed() == stop.getRed()
+     && start.getGreen() == stop.getGreen()
+     && start.getBlue() == stop.getBlue()
+     && stop.getAlpha() == 0.0) {
+        int left, top;
+        auto sprite = m_atlas->getDiffuse(x + m_state.tx, y + m_state.ty, r, left, top);
+        mask(sprite, left, top
+           , RasterPaint{RasterPaint::premultiply(start.getRed(), start.getGreen(), start.getBlue(), start.getAlpha()), nullptr});
+        return;
+    }
+    PixelGradient gradient(x + m_state.tx, y + m_state.ty, 0.0, r);
+    gradient.addColorStop(0.0, start);
+    gradient.addColorStop(1.0, stop);
+    m_rasterizer.newPath();
+    rectangle(x - r, y - r, r * 2.0, r * 2.0);
+    m_rasterizer.fill(RasterPaint{f32x4{}, gradient.getGradient(0.0, 0.0)});
+}
+
+// the dots are kept as separate shapes, as each covers only a few pixel
+void
+PixelRenderer::dots(std::span<const double> x, std::span<const double> y, std::span<const double> r)
+{
+    for (size_t i = 0; i < x.size(); ++i) {
+        dot(x[i], y[i], r[i]);
+    }
+}
+
+void
+PixelRenderer::polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets)
+{
+    if (x.empty()) {
+        return;
+    }
+    for (size_t l = 0; l < offsets.size(); ++l) {
+        const size_t end = l + 1 < offsets.size() ? offsets[l + 1] : x.size();
+        for (size_t i = offsets[l]; i < end; ++i) {
+            if (i == offsets[l]) {
+                moveTo(x[i], y[i]);
+            }
+            else {
+                lineTo(x[i], y[i]);
+            }
+        }
+    }
+    stroke();
+}
+
+/**
+ * @param radius
+ * @param phase 0 right .. 1 center .. 2 left
+ */
+void
+PixelRenderer::halfRight(double radius, double phase)
+{
+    double bezierCircApprox = BEZIER_APPROX * radius;
+    double phaseInv = 1.0 - phase;
+    double extend = radius + radius * phaseInv;
+    double radius2 = radius * 2.0;
+    moveTo(radius, 0.0);
+    curveTo(radius + bezierCircApprox * phaseInv, 0.0,
+                extend, radius - bezierCircApprox,
+                extend, radius);
+    curveTo(extend, radius + bezierCircApprox,
+                radius + bezierCircApprox * phaseInv, radius2,
+                radius, radius2);
+    // add fixed part
+    curveTo(radius + bezierCircApprox, radius2,
+                radius2, radius + bezierCircApprox,
+                radius2, radius);
+    curveTo(radius2, radius - bezierCircApprox,
+                radius + bezierCircApprox, 0.0,
+                radius, 0.0);
+    closePath();
+}
+
+void
+PixelRenderer::showPhase(Phase phase, double x, double y, double radius)
+{
+    save();
+    translate(x-radius, y-radius);
+    m_rasterizer.newPath();
+    circle(radius, radius, radius);
+    RenderColor bright(0.6, 0.6, 0.6);
+    RenderColor dark(0.3, 0.3, 0.3);
+    if (phase.isWanning()) {
+        setSource(bright);
+        fill();
+        setSource(dark);
+        halfRight(radius, 2.0 - (2.0 * phase.getPhase()));
+        fill();
+    }
+    else {
+        setSource(dark);
+        fill();
+        setSource(bright);
+        halfRight(radius, 2.0 * phase.getPhase());
+        fill();
+    }
+    restore();
+}
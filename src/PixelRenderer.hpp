@@ -0,0 +1,142 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtkmm.h>
+#include <map>
+#include <vector>
+
+#include "Renderer.hpp"
+#include "Rasterizer.hpp"
+#include "SpriteAtlas.hpp"
+
+class PixelGradient
+: public RenderGradient
+{
+public:
+    PixelGradient(double cx, double cy, double r0, double r1);
+    explicit PixelGradient(const PixelGradient& orig) = delete;
+    virtual ~PixelGradient() = default;
+
+    void addColorStop(double pos, RenderColor& rgba) override;
+    void addColorStop(double pos, Gdk::RGBA& rgba) override;
+    // the gradient moved to pixel coordinates
+    std::shared_ptr<RasterGradient> getGradient(double tx, double ty);
+private:
+    RasterGradient m_gradient;
+};
+
+class PixelText
+: public RenderText
+{
+public:
+    PixelText(const Glib::RefPtr<Pango::Layout>& layout, const Pango::FontDescription& fontDesc);
+    explicit PixelText(const PixelText& orig) = delete;
+    virtual ~PixelText() = default;
+    void setText(const Glib::ustring& text) override;
+    void getSize(double& width, double& height) override;
+    Glib::RefPtr<Pango::Layout> getLayout();
+    // identifies the rendered text
+    Glib::ustring getKey();
+
+private:
+    Glib::RefPtr<Pango::Layout> m_layout;
+    Glib::ustring m_font;
+};
+
+/**
+ * renders into the pixel data of a image surface without cairo drawing,
+ *   intended for the daemon mode that only writes the image.
+ * The primitives are recorded by the Rasterizer and drawn
+ *   on finish, using row bands in parallel if a pool is given.
+ * Text is rendered by pango once into a mask that is blended like the shapes.
+ * Only translations are supported, the gradients are expected concentric.
+ */
+class PixelRenderer
+: public Renderer
+{
+public:
+    // the pool (if any) has to be kept until finish
+    PixelRenderer(const Cairo::RefPtr<Cairo::ImageSurface>& surface, BandPool* pool = nullptr);
+    explicit PixelRenderer(const PixelRenderer& orig) = delete;
+    virtual ~PixelRenderer();
+
+    std::shared_ptr<RenderGradient> createRadialGradient(double x0, double y0, double r0, double x1, double y1, double r1) override;
+    void setSource(std::shared_ptr<RenderGradient>& grad) override;
+    void rectangle(double x0, double y0, double width, double height) override;
+    void fill() override;
+    void translate(double x0, double y0) override;
+    void circle(double x0, double y0, double r) override;
+    void clip() override;
+    void setSource(RenderColor& rgba) override;
+    void setTrueSource(RenderColor& rgba) override;
+
+    std::shared_ptr<RenderText> createText(Pango::FontDescription& fontDesc) override;
+    void moveTo(double x, double y) override;
+    void lineTo(double x, double y) override;
+    void showText(std::shared_ptr<RenderText>& text, double x, double y, TextAlign textAlign) override;
+    void save() override;
+    void restore() override;
+    void beginNewPath() override;
+    void setLineWidth(double width) override;
+    void curveTo(double x, double y, double e0, double r0, double e1, double r1) override;
+    void closePath() override;
+    void stroke() override;
+    void paint() override;
+
+    void dot(double x, double y, double r) override;
+    void diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop) override;
+    void showPhase(Phase phase, double x, double y, double radius) override;
+    void dots(std::span<const double> x, std::span<const double> y, std::span<const double> r) override;
+    void polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets) override;
+    // if set dots are drawn from the pre-rendered sprites,
+    //   the atlas size shall not change until finish
+    void setAtlas(const std::shared_ptr<SpriteAtlas>& atlas);
+    // draws all recorded primitives into the surface, also done on destruction
+    void finish();
+
+    static constexpr auto TEXT_MARGIN{2};   // pixel around the logical text size
+    static constexpr auto CIRCLE_TOLERANCE{0.1};   // pixel the polygon may deviate
+    static constexpr auto CURVE_SEGMENTS{16};
+
+protected:
+    void halfRight(double radius, double phase);
+    void mask(const Cairo::RefPtr<Cairo::ImageSurface>& mask, int left, int top, const RasterPaint& paint);
+    Cairo::RefPtr<Cairo::ImageSurface> getTextMask(const std::shared_ptr<PixelText>& text, int width, int height);
+
+private:
+    struct State
+    {
+        double tx{};
+        double ty{};
+        RasterPaint paint;
+        double lineWidth{2.0};
+        int clip{Rasterizer::NO_CLIP};
+    };
+    Cairo::RefPtr<Cairo::ImageSurface> m_surface;
+    Rasterizer m_rasterizer;
+    BandPool* m_pool;
+    State m_state;
+    std::vector<State> m_stack;
+    double m_curX{};    // pixel coordinates
+    double m_curY{};
+    std::shared_ptr<SpriteAtlas> m_atlas;
+    Cairo::RefPtr<Cairo::Context> m_textCtx;
+    std::map<Glib::ustring, Cairo::RefPtr<Cairo::ImageSurface>> m_textMasks;
+};
@@ -125,8 +125,7 @@ Planet::posToEarth(const JulianDate& jd)
 {
 	auto xyzPlanet = computePlanetPosition(jd);
     //std::cout << getName() << xyzPlanet[0] << "," << xyzPlanet[1] << "," << xyzPlanet[2] << std::endl;
-    Planets planets;
-	auto earth = planets.getEarth();
+    static const auto earth = Planets().getEarth();   // build once
     //Earth earth;
     auto xyzEarth = earth->computePlanetPosition(jd);
     //std::cout << "earth " << xyzEarth[0] << "," << xyzEarth[1] << "," << xyzEarth[2] << std::endl;
@@ -137,12 +136,18 @@ Planet::posToEarth(const JulianDate& jd)
 
 std::shared_ptr<RaDecPlanet>
 Planet::getRaDecPositon(const JulianDate& jd)
+{
+	return std::make_shared<RaDecPlanet>(raDec(jd));
+}
+
+RaDecPlanet
+Planet::raDec(const JulianDate& jd)
 {
 	std::array<double,3> xyzRel = posToEarth(jd);
 	return rectToPolar(xyzRel);
 }
 
-std::shared_ptr<RaDecPlanet>
+RaDecPlanet
 Planet::rectToPolar(const std::array<double,3>& xyz)
 {
     // convert from Cartesian to polar coordinates
@@ -156,7 +161,7 @@ Planet::rectToPolar(const std::array<double,3>& xyz)
 	}
 	// Make dec is in range +/-90deg
 	dec = Math::HALF_PI - dec;
-	return std::make_shared<RaDecPlanet>(ra, dec, r);
+	return RaDecPlanet(ra, dec, r);
 }
 
 std::string
@@ -44,11 +44,13 @@ public:
 
     std::string getName();
 
+    RaDecPlanet raDec(const JulianDate& jd);
+    // compatibility, allocates
     std::shared_ptr<RaDecPlanet> getRaDecPositon(const JulianDate& jd);
 protected:
     std::array<double,3> computePlanetPosition(const JulianDate& jd);
     std::array<double,3> posToEarth(const JulianDate& jd);
-    std::shared_ptr<RaDecPlanet> rectToPolar(const std::array<double,3>& xyz);
+    RaDecPlanet rectToPolar(const std::array<double,3>& xyz);
 
     //https://ssd.jpl.nasa.gov/planets/approx_pos.html
     // at the moment using "short" term values (1850-2050)
@@ -26,7 +26,7 @@ Planets::Planets()
 {
 }
 
-std::vector<PtrPlanet>
+const std::vector<PtrPlanet>&
 Planets::getOtherPlanets()
 {
     if (m_planets.empty()) {
@@ -156,7 +156,7 @@ Planets::getOtherPlanets()
 PtrPlanet
 Planets::find(const char* name)
 {
-    auto planets = getOtherPlanets();
+    const auto& planets = getOtherPlanets();
     for (auto& planet : planets) {
         if (planet->getName() == name) {
             return planet;
@@ -27,7 +27,7 @@ public:
     explicit Planets(const Planets& orig) = delete;
     virtual ~Planets() = default;
     PtrPlanet getEarth();
-    std::vector<PtrPlanet> getOtherPlanets();   // all non earth ones
+    const std::vector<PtrPlanet>& getOtherPlanets();   // all non earth ones
     PtrPlanet find(const char* name);
 
 private:
@@ -63,13 +63,13 @@ Point2D::add(const Point2D& add)
 }
 
 double
-Point2D::getDist()
+Point2D::getDist() const
 {
     return std::sqrt(x*x + y*y);
 }
 
 double
-Point2D::dist(const Point2D& p)
+Point2D::dist(const Point2D& p) const
 {
     auto dx = x - p.x;
     auto dy = y - p.y;
@@ -84,48 +84,72 @@ MagPoint::MagPoint(const Point2D& p, double vMagnitude)
 }
 
 double
-MagPoint::getVmagnitude()
+MagPoint::getVmagnitude() const
 {
     return m_vMagnitude;
 }
 
 
-NamedPoint::NamedPoint(const MagPoint& p, const Glib::ustring& name)
-: m_name{name}
+void
+PointClusters::clear()
 {
-    m_p.push_back(p);
+    m_points.clear();
+    m_names.clear();
+    m_clusters.clear();
+}
+
+void
+PointClusters::add(const MagPoint& p, const Glib::ustring& name, double distance)
+{
+    const auto point = static_cast<uint32_t>(m_points.size());
+    uint32_t cluster{point};
+    for (uint32_t first = 0; first < point; ++first) {
+        if (isFirst(first)
+         && p.dist(m_points[first]) < distance) {
+            cluster = first;
+            break;
+        }
+    }
+    m_points.push_back(p);
+    m_names.push_back(&name);
+    m_clusters.push_back(cluster);
 }
 
-Point2D
-NamedPoint::getPoint() const
+uint32_t
+PointClusters::size() const
 {
-    auto m = getMagPoint();
-    return Point2D(m.getX(), m.getY());
+    return static_cast<uint32_t>(m_points.size());
 }
 
-MagPoint
-NamedPoint::getMagPoint() const
+const MagPoint&
+PointClusters::getPoint(uint32_t point) const
 {
-    return m_p[0];
+    return m_points[point];
 }
 
-std::vector<MagPoint>&
-NamedPoint::getMagPoints()
+uint32_t
+PointClusters::getCluster(uint32_t point) const
 {
-    return m_p;
+    return m_clusters[point];
 }
 
-Glib::ustring
-NamedPoint::getName() const
+bool
+PointClusters::isFirst(uint32_t point) const
 {
-    return m_name;
+    return m_clusters[point] == point;
 }
 
-void NamedPoint::add(const NamedPoint& add)
+const Glib::ustring&
+PointClusters::getName(uint32_t first)
 {
-    if (!m_name.empty()) {
-        m_name += ", ";
+    m_name.clear();
+    for (uint32_t point = first; point < size(); ++point) {
+        if (m_clusters[point] == first) {
+            if (!m_name.empty()) {
+                m_name += ", ";
+            }
+            m_name += *m_names[point];
+        }
     }
-    m_name += add.getName();
-    m_p.push_back(add.getMagPoint());
-}
\ No newline at end of file
+    return m_name;
+}
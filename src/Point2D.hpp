@@ -19,6 +19,7 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include <glibmm.h>
 
 class Point2D
@@ -26,19 +27,20 @@ class Point2D
 public:
     Point2D();
     Point2D(const double _x, const double _y);
-    explicit Point2D(const Point2D& orig) = default;
-    virtual ~Point2D() = default;
+    Point2D(const Point2D& orig) = default;
+    Point2D& operator=(const Point2D& orig) = default;
+    ~Point2D() = default;
 
     double getX() const;
     double getY() const;
     void setX(double x);
     void setY(double y);
     void add(const Point2D& add);
-    double getDist();
-    double dist(const Point2D& p);
+    double getDist() const;
+    double dist(const Point2D& p) const;
 private:
-    double x;
-    double y;
+    double x{};
+    double y{};
 };
 
 class MagPoint
@@ -47,26 +49,38 @@ class MagPoint
 public:
     MagPoint(const Point2D& p, double vMagnitude);
     MagPoint(const MagPoint& p) = default;
-    virtual ~MagPoint() = default;
+    MagPoint& operator=(const MagPoint& p) = default;
+    ~MagPoint() = default;
 
-    double getVmagnitude();
+    double getVmagnitude() const;
 private:
     double m_vMagnitude;
 };
 
-class NamedPoint
+// as messier objects appear in some places close together,
+//   the points closer than a distance are grouped to show the names concatenated.
+//   The storage is kept, so once warmed up adding points does not allocate,
+//   the names are referenced, keep them while the clusters are used.
+class PointClusters
 {
 public:
-    NamedPoint(const MagPoint& p, const Glib::ustring& name);
-    NamedPoint(const NamedPoint& p) = default;
-    virtual ~NamedPoint() = default;
+    PointClusters() = default;
+    explicit PointClusters(const PointClusters& orig) = delete;
+    virtual ~PointClusters() = default;
 
-    Point2D getPoint() const;
-    MagPoint getMagPoint() const;
-    std::vector<MagPoint>& getMagPoints();
-    Glib::ustring getName() const;
-    void add(const NamedPoint& add);
+    void clear();
+    // joins the cluster whose first point is closer than distance
+    void add(const MagPoint& p, const Glib::ustring& name, double distance);
+    uint32_t size() const;
+    const MagPoint& getPoint(uint32_t point) const;
+    // the index of the first point of the cluster
+    uint32_t getCluster(uint32_t point) const;
+    bool isFirst(uint32_t point) const;
+    // the names of the cluster that starts with first, valid until the next call
+    const Glib::ustring& getName(uint32_t first);
 private:
-    std::vector<MagPoint> m_p;
+    std::vector<MagPoint> m_points;
+    std::vector<const Glib::ustring*> m_names;
+    std::vector<uint32_t> m_clusters;
     Glib::ustring m_name;
-};
\ No newline at end of file
+};
@@ -24,12 +24,38 @@ Poly::Poly()
 {
 }
 
-const std::vector<std::shared_ptr<RaDec>>
+std::span<const std::shared_ptr<RaDec>>
 Poly::getPoints()
 {
+    if (m_points.size() != m_vectors.size()) {     // only created on request
+        m_points.clear();
+        m_points.reserve(m_vectors.size());
+        for (size_t i = 0; i < m_vectors.size(); ++i) {
+            m_points.push_back(std::make_shared<RaDec>(m_vectors.toRaDec(i)));
+        }
+    }
     return m_points;
 }
 
+void
+Poly::setQuantized(std::span<const int16_t> x, std::span<const int16_t> y, std::span<const int16_t> z)
+{
+    m_points.clear();
+    m_vectors.setQuantized(x, y, z);
+}
+
+void
+Poly::add(const RaDec& raDec)
+{
+    m_vectors.add(raDec);
+}
+
+const UnitVectors&
+Poly::getUnitVectors()
+{
+    return m_vectors;
+}
+
 void
 Poly::setIntensity(int intensity)
 {
@@ -47,23 +73,25 @@ void
 Poly::read(JsonArray* poly)
 {
     uint32_t coordCount = json_array_get_length(poly);
-    m_points.reserve(coordCount);
+    m_vectors.reserve(coordCount);
     //std::cout << "     " << __FILE__ << "::read coord " << coordCount << std::endl;
-    std::shared_ptr<RaDec> lastRaDec;
+    RaDec lastRaDec;
+    bool hasLast{false};
     for (uint32_t nCoord = 0; nCoord < coordCount; ++nCoord) {
         JsonArray* coord =json_array_get_array_element(poly, nCoord);
         uint32_t coordComp = json_array_get_length(coord);
         if (coordComp == 2) {
             double ra = json_array_get_double_element(coord, 0);
             double dec = json_array_get_double_element(coord, 1);
-            auto raDec = std::make_shared<RaDec>();
-            raDec->setRaDegrees(ra);
-            raDec->setDecDegrees(dec);
+            RaDec raDec;
+            raDec.setRaDegrees(ra);
+            raDec.setDecDegrees(dec);
             // exclude swipes that work on sphere
-            if (!lastRaDec || std::abs(raDec->getRaDegrees() - lastRaDec->getRaDegrees()) < 90.0) {
-                m_points.push_back(raDec);
+            if (!hasLast || std::abs(raDec.getRaDegrees() - lastRaDec.getRaDegrees()) < 90.0) {
+                m_vectors.add(raDec);
             }
             lastRaDec = raDec;
+            hasLast = true;
         }
         else {
             std::cout << "Reading poly unexpected coord count " << coordComp << " intensity " << m_intensity << std::endl;
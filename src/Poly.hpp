@@ -19,11 +19,12 @@
 #pragma once
 
 #include <vector>
-#include <list>
 #include <memory>
+#include <span>
 #include <JsonHelper.hpp>
 
 #include "RaDec.hpp"
+#include "HorizonMatrix.hpp"
 
 class Poly
 {
@@ -32,12 +33,19 @@ public:
     explicit Poly(const Poly& orig) = delete;
     virtual ~Poly() = default;
     void read(JsonArray* poly);
-    const std::vector<std::shared_ptr<RaDec>> getPoints();
+    // use quantized points e.g. from the mapped catalog
+    void setQuantized(std::span<const int16_t> x, std::span<const int16_t> y, std::span<const int16_t> z);
+    void add(const RaDec& raDec);
+    // created on first request, better use getUnitVectors
+    std::span<const std::shared_ptr<RaDec>> getPoints();
+    // same points as getPoints
+    const UnitVectors& getUnitVectors();
     // 1 darkest to 5 brightest
     int getIntensity();
     void setIntensity(int intens);
 private:
     std::vector<std::shared_ptr<RaDec>> m_points;
+    UnitVectors m_vectors;
     int m_intensity;
 };
 
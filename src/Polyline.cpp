@@ -28,17 +28,30 @@ Polyline::Polyline(int width)
 }
 
 void
-Polyline::add(const std::shared_ptr<RaDec>& raDec)
+Polyline::add(const RaDec& raDec)
 {
-    m_points.push_back(raDec);
+    m_vectors.add(raDec);
 }
 
-const std::list<std::shared_ptr<RaDec>>
+std::span<const std::shared_ptr<RaDec>>
 Polyline::getPoints()
 {
+    if (m_points.size() != m_vectors.size()) {
+        m_points.clear();
+        m_points.reserve(m_vectors.size());
+        for (size_t i = 0; i < m_vectors.size(); ++i) {
+            m_points.push_back(std::make_shared<RaDec>(m_vectors.toRaDec(i)));
+        }
+    }
     return m_points;
 }
 
+const UnitVectors&
+Polyline::getUnitVectors()
+{
+    return m_vectors;
+}
+
 int
 Polyline::getWidth()
 {
@@ -18,9 +18,12 @@
 
 #pragma once
 
-#include <list>
+#include <vector>
+#include <span>
 #include <memory>
 
+#include "HorizonMatrix.hpp"
+
 class RaDec;
 
 namespace psc::geom {
@@ -32,12 +35,16 @@ public:
     explicit Polyline(const Polyline& orig) = delete;
     virtual ~Polyline() = default;
 
-    void add(const std::shared_ptr<RaDec>& raDec);
-    const std::list<std::shared_ptr<RaDec>> getPoints();
+    void add(const RaDec& raDec);
+    // created on request, better use getUnitVectors
+    std::span<const std::shared_ptr<RaDec>> getPoints();
     int getWidth();
+    // same points as getPoints
+    const UnitVectors& getUnitVectors();
 
 private:
-    std::list<std::shared_ptr<RaDec>> m_points;
+    std::vector<std::shared_ptr<RaDec>> m_points;
+    UnitVectors m_vectors;
     int m_width;
 };
 
@@ -0,0 +1,72 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PolylineStore.hpp"
+
+void
+PolylineStore::add(const UnitVectors& vectors, int32_t value, uint32_t group)
+{
+    const auto first = static_cast<uint32_t>(m_vertices.size());
+    m_vertices.append(vectors);
+    m_lines.push_back(PolylineInfo{first, static_cast<uint32_t>(vectors.size()), value, group});
+}
+
+void
+PolylineStore::setQuantized(std::span<const int16_t> x, std::span<const int16_t> y, std::span<const int16_t> z
+                          , std::vector<PolylineInfo>&& lines)
+{
+    m_vertices.setQuantized(x, y, z);
+    m_lines = std::move(lines);
+}
+
+void
+PolylineStore::clear()
+{
+    m_vertices.clear();
+    m_lines.clear();
+}
+
+size_t
+PolylineStore::size() const
+{
+    return m_lines.size();
+}
+
+bool
+PolylineStore::empty() const
+{
+    return m_lines.empty();
+}
+
+const PolylineInfo&
+PolylineStore::getLine(size_t idx) const
+{
+    return m_lines[idx];
+}
+
+std::span<const PolylineInfo>
+PolylineStore::getLines() const
+{
+    return m_lines;
+}
+
+const UnitVectors&
+PolylineStore::getVertices() const
+{
+    return m_vertices;
+}
@@ -0,0 +1,63 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+#include "HorizonMatrix.hpp"
+
+// a polyline of the store, refers to the vertices first ... first + count - 1
+struct PolylineInfo
+{
+    uint32_t first;
+    uint32_t count;
+    int32_t value;      // e.g. intensity or width
+    uint32_t group;     // e.g. constellation
+};
+
+/**
+ * all polylines of a layer (milkyway, constellations) packed
+ *   into one vertex array with a table of polylines,
+ *   so drawing can transform them in one sequential pass.
+ */
+class PolylineStore
+{
+public:
+    PolylineStore() = default;
+    explicit PolylineStore(const PolylineStore& orig) = delete;
+    virtual ~PolylineStore() = default;
+
+    // appends a polyline with the given vertices
+    void add(const UnitVectors& vectors, int32_t value, uint32_t group = 0u);
+    // use quantized vertices e.g. from a mapped catalog, the memory has to outlive this
+    void setQuantized(std::span<const int16_t> x, std::span<const int16_t> y, std::span<const int16_t> z
+                    , std::vector<PolylineInfo>&& lines);
+    void clear();
+    size_t size() const;
+    bool empty() const;
+    const PolylineInfo& getLine(size_t idx) const;
+    std::span<const PolylineInfo> getLines() const;
+    const UnitVectors& getVertices() const;
+
+private:
+    UnitVectors m_vertices;
+    std::vector<PolylineInfo> m_lines;
+};
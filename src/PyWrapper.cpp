@@ -36,6 +36,11 @@ PyClass::PyClass(const std::string& obj, const std::string& src)
 
 PyClass::~PyClass()
 {
+    PyGil gil;
+    for (auto& method : m_methods) {
+        Py_DECREF(method.second);
+    }
+    Py_XDECREF(m_pyCtx);
     if (m_pInstance) {
         Py_XDECREF(m_pInstance);  // cleanup instance
     }
@@ -106,10 +111,9 @@ PyClass::setPyError(const Glib::ustring& location)
         auto pyStr = PyObject_Str(pvalue);
         if (pyStr) {
             auto pyUtf8 = PyUnicode_AsUTF8(pyStr);;
-            if (pyUtf8) {
+            if (pyUtf8) {   // owned by pyStr
                 m_error += "\n";
                 m_error += pyUtf8;
-                Py_DECREF(pyUtf8);
             }
             Py_DECREF(pyStr);
         }
@@ -127,6 +131,7 @@ PyClass::setSourceModified()
 bool
 PyClass::load(const std::shared_ptr<FileLoader>& loader)
 {
+    PyGil gil;
     m_failed = false;
     PyErr_Clear();
     // first stop check source
@@ -220,12 +225,45 @@ PyClass::getError()
 }
 
 
+bool
+PyClass::hasMethod(const std::string& method)
+{
+    if (!m_pInstance) {
+        return false;
+    }
+    PyGil gil;      // the methods are cached by getMethod with the gil held
+    if (m_methods.contains(method)) {
+        return true;
+    }
+    return PyObject_HasAttrString(m_pInstance, method.c_str()) != 0;
+}
+
+PyObject*
+PyClass::getMethod(const std::string& method)
+{
+    auto entry = m_methods.find(method);
+    if (entry != m_methods.end()) {
+        return entry->second;
+    }
+    PyObject* pMethod = PyObject_GetAttrString(m_pInstance, method.c_str());
+    if (pMethod) {
+        m_methods.insert(std::pair(method, pMethod));
+    }
+    return pMethod;
+}
+
 PyObject*
 PyClass::ctx2py(const Cairo::RefPtr<Cairo::Context>& ctx)
 {
     cairo_t* c_ctx = ctx->cobj();
-    PyObject* context = PycairoContext_FromContext(c_ctx, &PycairoContext_Type, NULL);
-    return context;
+    if (c_ctx != m_cairoCtx) {  // as we keep a reference the address is not reused while cached
+        Py_XDECREF(m_pyCtx);
+        // the wrapper takes the reference
+        m_pyCtx = PycairoContext_FromContext(cairo_reference(c_ctx), &PycairoContext_Type, nullptr);
+        m_cairoCtx = m_pyCtx ? c_ctx : nullptr;
+    }
+    Py_XINCREF(m_pyCtx);
+    return m_pyCtx;
 }
 
 PyWrapper::PyWrapper()
@@ -252,10 +290,12 @@ PyWrapper::PyWrapper()
     if (import_cairo() < 0) {
        std::cout << "Pycairo not initalized!" << std::endl;
     }
+    m_mainState = PyEval_SaveThread();  // release the lock, each use acquires it with PyGil
 }
 
 PyWrapper::~PyWrapper()
 {
+    PyEval_RestoreThread(m_mainState);
     Py_Finalize(); // Clean up and close the Python Interpreter
 }
 
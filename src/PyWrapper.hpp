@@ -26,10 +26,31 @@
 #include <cstdio>
 #include <cstdarg>
 #include <algorithm>
+#include <array>
+#include <vector>
+#include <map>
 #include <psc_format.hpp>
 
 #include "FileLoader.hpp"
 
+// holds the python interpreter lock for the current thread,
+//   as the modules may be drawn on the render worker
+class PyGil
+{
+public:
+    PyGil()
+    : m_state{PyGILState_Ensure()}
+    {
+    }
+    explicit PyGil(const PyGil& orig) = delete;
+    virtual ~PyGil()
+    {
+        PyGILState_Release(m_state);
+    }
+private:
+    PyGILState_STATE m_state;
+};
+
 class PyClass
 {
 public:
@@ -48,81 +69,96 @@ public:
             std::cout << "PyClass::invokeMethod no instance" << std::endl;
             return ret;
         }
+        PyGil gil;
         m_failed = false;
         PyErr_Clear();
-        static const std::size_t values = sizeof...(ppargs);
-        PyObject* pyArgs = PyTuple_New(values);
-        buildArgsAsPyTuple(pyArgs, 0, ppargs...);
-        PyObject* pValue = PyObject_CallMethod(m_pInstance, method.c_str(), "O", pyArgs);
-        if (pValue)  {
-            ret = PyLong_AsLong(pValue);
-            Py_DECREF(pValue);
+        PyObject* pMethod = getMethod(method);
+        if (pMethod) {
+            // the first is left for the callee, see PY_VECTORCALL_ARGUMENTS_OFFSET
+            std::array<PyObject*, sizeof...(ppargs) + 1u> pyArgs{nullptr, toPy(ppargs)...};
+            if (std::all_of(pyArgs.begin() + 1, pyArgs.end(), [] (PyObject* pyArg) {
+                    return pyArg != nullptr;
+                })) {
+                PyObject* pValue = PyObject_Vectorcall(pMethod, pyArgs.data() + 1
+                                                    , sizeof...(ppargs) | PY_VECTORCALL_ARGUMENTS_OFFSET, nullptr);
+                if (pValue)  {
+                    ret = PyLong_AsLong(pValue);
+                    Py_DECREF(pValue);
+                }
+            }
+            for (auto pyArg : pyArgs) {
+                Py_XDECREF(pyArg);
+            }
         }
         if (PyErr_Occurred()) {
             setPyError(psc::fmt::format("invoke {} on {}", method, m_obj));
         }
         return ret;
     }
+    // allows to use a newer method with a fallback for older local scripts
+    bool hasMethod(const std::string& method);
     Glib::RefPtr<Gio::File> getLocalPyFile();
     Glib::RefPtr<Gio::File> getPyFile();
     bool hasFailed();
     Glib::ustring getError();
     void setSourceModified();
 protected:
+    // the bound method, resolved once, call with the gil held (as it guards m_methods)
+    PyObject* getMethod(const std::string& method);
+    // the wrapper is kept while the same context is used (e.g. for getHeight and draw)
     PyObject* ctx2py(const Cairo::RefPtr<Cairo::Context>& ctx);
     void setPyError(const Glib::ustring& location);
 
-    void
-    buildArgsAsPyTuple(PyObject* pyArgs, int pos)
-    { // finally the end of arguments ...
+    // the arguments as new references
+    PyObject*
+    toPy(const Cairo::RefPtr<Cairo::Context>& ctx)
+    {
+        return ctx2py(ctx);
     }
 
-    void
-    buildArgsAsPyTuple(PyObject* pyArgs, int pos, const Cairo::RefPtr<Cairo::Context>& ctx,  auto&&... ppargs)
+    static PyObject*
+    toPy(const std::string& s)
     {
-        PyObject* pValue = Py_BuildValue("O", ctx2py(ctx));
-        PyTuple_SetItem(pyArgs, pos, pValue);
-        buildArgsAsPyTuple(pyArgs, pos + 1, ppargs...);
+        return PyUnicode_FromString(s.c_str());
     }
 
-    void
-    buildArgsAsPyTuple(PyObject* pyArgs, int pos, const std::string& s, auto&&... ppargs)
+    static PyObject*
+    toPy(double d)
     {
-        auto pValue = PyUnicode_FromString(s.c_str());
-        PyTuple_SetItem(pyArgs, pos, pValue);
-        buildArgsAsPyTuple(pyArgs, pos + 1, ppargs...);
+        return PyFloat_FromDouble(d);
     }
 
-    void
-    buildArgsAsPyTuple(PyObject* pyArgs, int pos, double d, auto&&... ppargs)
+    static PyObject*
+    toPy(long l)
     {
-        auto pValue = PyFloat_FromDouble(d);
-        PyTuple_SetItem(pyArgs, pos, pValue);
-        buildArgsAsPyTuple(pyArgs, pos + 1, ppargs...);
+        return PyLong_FromLong(l);
     }
 
-    void
-    buildArgsAsPyTuple(PyObject* pyArgs, int pos, long l, auto&&... ppargs)
+    static PyObject*
+    toPy(unsigned long ul)
     {
-        auto pValue = PyLong_FromLong(l);
-        PyTuple_SetItem(pyArgs, pos, pValue);
-        buildArgsAsPyTuple(pyArgs, pos + 1, ppargs...);
+        return PyLong_FromUnsignedLong(ul);
     }
 
-    void
-    buildArgsAsPyTuple(PyObject* pyArgs, int pos, unsigned long ul, auto&&... ppargs)
+    static PyObject*
+    toPy(bool b)
     {
-        auto pValue = PyLong_FromUnsignedLong(ul);
-        PyTuple_SetItem(pyArgs, pos, pValue);
-        buildArgsAsPyTuple(pyArgs, pos + 1, ppargs...);
+        PyObject* pValue = b ? Py_True : Py_False;
+        Py_INCREF(pValue);
+        return pValue;
     }
 
-    void
-    buildArgsAsPyTuple(PyObject* pyArgs, int pos, bool b, auto&&... ppargs)
+    static PyObject*
+    toPy(const std::vector<double>& values)
     {
-        auto pValue = b ? Py_True : Py_False;
-        PyTuple_SetItem(pyArgs, pos, pValue);
-        buildArgsAsPyTuple(pyArgs, pos + 1, ppargs...);
+        PyObject* pList = PyList_New(static_cast<Py_ssize_t>(values.size()));
+        if (pList) {
+            for (size_t i = 0; i < values.size(); ++i) {
+                // the list takes the reference
+                PyList_SET_ITEM(pList, static_cast<Py_ssize_t>(i), PyFloat_FromDouble(values[i]));
+            }
+        }
+        return pList;
     }
 
 private:
@@ -135,6 +171,9 @@ private:
     Glib::DateTime m_pySoureModified;
     bool m_failed{false};
     Glib::ustring  m_error;
+    std::map<std::string, PyObject*> m_methods;
+    cairo_t* m_cairoCtx{nullptr};
+    PyObject* m_pyCtx{nullptr};
 };
 
 // this should be keep as singleton
@@ -148,5 +187,6 @@ public:
 
     std::shared_ptr<PyClass> load(const std::shared_ptr<FileLoader>& loader, const std::string& obj, const std::string& src);
 private:
+    PyThreadState* m_mainState{nullptr};
 };
 
@@ -22,6 +22,7 @@
 #include "Math.hpp"
 
 RaDec::RaDec()
+: RaDec(0.0, 0.0)
 {
 }
 
@@ -63,7 +64,7 @@ RaDec::setRaDegrees(double raDeg)
 }
 
 double
-RaDec::getRaDegrees()
+RaDec::getRaDegrees() const
 {
 return Math::toDegrees(ra);
 }
@@ -75,7 +76,7 @@ RaDec::setRaHours(double raHours)
 }
 
 double
-RaDec::getRaHours()
+RaDec::getRaHours() const
 {
     return Math::toHoursRadian(ra);
 }
@@ -93,13 +94,13 @@ RaDec::setDecDegreesPolar(double decDegPolar)
 }
 
 double
-RaDec::getDecDegrees()
+RaDec::getDecDegrees() const
 {
     return Math::toDegrees(dec);
 }
 
 bool
-RaDec::operator==(const RaDec& rhs)
+RaDec::operator==(const RaDec& rhs) const
 {
     return dec == rhs.dec && ra == rhs.ra;
 }
@@ -20,6 +20,7 @@
 
 /**
  * Right Ascension, Declination
+ *   a plain value, prefer passing by value/reference on the drawing path
  *
  * @author RPf
  */
@@ -29,21 +30,22 @@ public:
     RaDec();
     RaDec(double ra, double dec);
     RaDec(const RaDec& orig) = default;
-    virtual ~RaDec() = default;
+    RaDec& operator=(const RaDec& orig) = default;
+    ~RaDec() = default;
 
     void setRaRad(double ra);
     double getRaRad() const;
     void setDecRad(double dec);
     double getDecRad() const;
     void setRaDegrees(double raDeg);
-    double getRaDegrees();
+    double getRaDegrees() const;
     void setRaHours(double raHours);
-    double getRaHours();
+    double getRaHours() const;
     void setDecDegrees(double decDeg);
     void setDecDegreesPolar(double decDegPolar);
-    double getDecDegrees();
+    double getDecDegrees() const;
 
-    bool operator==(const RaDec& rhs);
+    bool operator==(const RaDec& rhs) const;
 
 private:
     double ra{}; // values in radians
@@ -25,10 +25,11 @@ class RaDecPlanet
 {
 public:
     RaDecPlanet(double ra, double dec, double distanceAU);
-    explicit RaDecPlanet(const RaDecPlanet& orig) = delete;
-    virtual ~RaDecPlanet() = default;
+    RaDecPlanet(const RaDecPlanet& orig) = default;
+    RaDecPlanet& operator=(const RaDecPlanet& orig) = default;
+    ~RaDecPlanet() = default;
 
-    double getDistanceAU();
+    double getDistanceAU() const;
 private:
     double distanceAU{0.0};
 };
\ No newline at end of file
@@ -0,0 +1,622 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "Rasterizer.hpp"
+#include "BandPool.hpp"
+
+f32x4
+RasterPaint::premultiply(double r, double g, double b, double a)
+{
+    a = std::clamp(a, 0.0, 1.0);
+    return f32x4{static_cast<float>(std::clamp(b, 0.0, 1.0) * a * 255.0)
+               , static_cast<float>(std::clamp(g, 0.0, 1.0) * a * 255.0)
+               , static_cast<float>(std::clamp(r, 0.0, 1.0) * a * 255.0)
+               , static_cast<float>(a * 255.0)};
+}
+
+Rasterizer::Bounds
+Rasterizer::Bounds::intersect(const Bounds& other) const
+{
+    return Bounds{std::max(left, other.left)
+                , std::max(top, other.top)
+                , std::min(right, other.right)
+                , std::min(bottom, other.bottom)};
+}
+
+Rasterizer::Rasterizer(uint32_t* data, int width, int height, int stride)
+: m_data{data}
+, m_width{width}
+, m_height{height}
+, m_stride{stride / static_cast<int>(sizeof(uint32_t))}
+{
+}
+
+void
+Rasterizer::moveTo(double x, double y)
+{
+    m_subpaths.emplace_back(static_cast<uint32_t>(m_path.size()), false);
+    m_path.push_back(Point{x, y});
+}
+
+void
+Rasterizer::lineTo(double x, double y)
+{
+    if (m_subpaths.empty()) {
+        moveTo(x, y);
+        return;
+    }
+    m_path.push_back(Point{x, y});
+}
+
+void
+Rasterizer::closePath()
+{
+    if (!m_subpaths.empty()) {
+        m_subpaths.back().second = true;
+        // following lines start at the same point
+        auto start = m_path[m_subpaths.back().first];
+        moveTo(start.x, start.y);
+    }
+}
+
+void
+Rasterizer::newPath()
+{
+    m_path.clear();
+    m_subpaths.clear();
+}
+
+bool
+Rasterizer::hasPath() const
+{
+    return !m_path.empty();
+}
+
+void
+Rasterizer::addEdge(std::vector<Edge>& edges, double x0, double y0, double x1, double y1, Bounds& bounds)
+{
+    if (y0 == y1) {
+        return;     // horizontal edges add no coverage
+    }
+    edges.push_back(Edge{static_cast<float>(x0), static_cast<float>(y0), static_cast<float>(x1), static_cast<float>(y1)});
+    bounds.left = std::min(bounds.left, static_cast<int>(std::floor(std::min(x0, x1))));
+    bounds.right = std::max(bounds.right, static_cast<int>(std::ceil(std::max(x0, x1))) + 1);
+    bounds.top = std::min(bounds.top, static_cast<int>(std::floor(std::min(y0, y1))));
+    bounds.bottom = std::max(bounds.bottom, static_cast<int>(std::ceil(std::max(y0, y1))));
+}
+
+void
+Rasterizer::addSubpathEdges(std::vector<Edge>& edges, size_t first, size_t end, bool close, Bounds& bounds)
+{
+    for (size_t i = first + 1; i < end; ++i) {
+        addEdge(edges, m_path[i - 1].x, m_path[i - 1].y, m_path[i].x, m_path[i].y, bounds);
+    }
+    if (close && end - first > 2) {
+        addEdge(edges, m_path[end - 1].x, m_path[end - 1].y, m_path[first].x, m_path[first].y, bounds);
+    }
+}
+
+void
+Rasterizer::fill(const RasterPaint& paint)
+{
+    Bounds bounds{EMPTY_BOUNDS};
+    const auto firstEdge = static_cast<uint32_t>(m_edges.size());
+    for (size_t s = 0; s < m_subpaths.size(); ++s) {
+        const size_t end = s + 1 < m_subpaths.size() ? m_subpaths[s + 1].first : m_path.size();
+        addSubpathEdges(m_edges, m_subpaths[s].first, end, true, bounds);   // fill closes implicitly
+    }
+    newPath();
+    if (m_clip != NO_CLIP) {
+        bounds = bounds.intersect(m_clips[m_clip].bounds);
+    }
+    bounds = bounds.intersect(Bounds{0, 0, m_width, m_height});
+    if (bounds.isEmpty()) {
+        m_edges.resize(firstEdge);
+        return;
+    }
+    m_shapes.push_back(Shape{firstEdge, static_cast<uint32_t>(m_edges.size()) - firstEdge
+                           , bounds, addPaint(paint), m_clip, nullptr, 0, 0, 0});
+}
+
+void
+Rasterizer::paint(const RasterPaint& paint)
+{
+    Bounds bounds{EMPTY_BOUNDS};
+    const auto firstEdge = static_cast<uint32_t>(m_edges.size());
+    const auto w = static_cast<double>(m_width);
+    const auto h = static_cast<double>(m_height);
+    addEdge(m_edges, w, 0.0, w, h, bounds);
+    addEdge(m_edges, 0.0, h, 0.0, 0.0, bounds);
+    if (m_clip != NO_CLIP) {
+        bounds = bounds.intersect(m_clips[m_clip].bounds);
+    }
+    bounds = bounds.intersect(Bounds{0, 0, m_width, m_height});
+    if (bounds.isEmpty()) {
+        m_edges.resize(firstEdge);
+        return;
+    }
+    m_shapes.push_back(Shape{firstEdge, 2u, bounds, addPaint(paint), m_clip, nullptr, 0, 0, 0});
+}
+
+// each segment becomes a quad and the joins miters (or bevels) of the same orientation, so they combine,
+//   as the cairo defaults (miter limit 10, butt caps)
+void
+Rasterizer::addStrokeEdges(std::vector<Edge>& edges, double width, Bounds& bounds)
+{
+    const double hw = width / 2.0;
+    // the outer corner between the segments p0-p1 and p1-p2
+    auto join = [&] (const Point& p0, const Point& p1, const Point& p2) {
+        const double dx0 = p1.x - p0.x;
+        const double dy0 = p1.y - p0.y;
+        const double dx1 = p2.x - p1.x;
+        const double dy1 = p2.y - p1.y;
+        const double len0 = std::sqrt(dx0 * dx0 + dy0 * dy0);
+        const double len1 = std::sqrt(dx1 * dx1 + dy1 * dy1);
+        const double cross = dx0 * dy1 - dy0 * dx1;
+        if (len0 <= 0.0 || len1 <= 0.0 || cross == 0.0) {
+            return;     // straight on (a reversal has no outer side to fill)
+        }
+        // unit normals on the outer side
+        const double side = cross > 0.0 ? 1.0 : -1.0;
+        const double ux0 = dy0 / len0 * side;
+        const double uy0 = -dx0 / len0 * side;
+        const double ux1 = dy1 / len1 * side;
+        const double uy1 = -dx1 / len1 * side;
+        const double ax = p1.x + ux0 * hw;
+        const double ay = p1.y + uy0 * hw;
+        const double bx = p1.x + ux1 * hw;
+        const double by = p1.y + uy1 * hw;
+        const double sx = ux0 + ux1;
+        const double sy = uy0 + uy1;
+        const double sum = std::sqrt(sx * sx + sy * sy);    // 2 sin(angle / 2) of the segments
+        // keep the orientation of the quads (negative signed area)
+        const bool reverse = (ax - p1.x) * (by - p1.y) - (ay - p1.y) * (bx - p1.x) > 0.0;
+        if (sum > 0.0 && 2.0 / sum <= MITER_LIMIT) {
+            const double scale = hw / (1.0 + ux0 * ux1 + uy0 * uy1);
+            const double mx = p1.x + sx * scale;
+            const double my = p1.y + sy * scale;
+            if (reverse) {
+                addEdge(edges, p1.x, p1.y, bx, by, bounds);
+                addEdge(edges, bx, by, mx, my, bounds);
+                addEdge(edges, mx, my, ax, ay, bounds);
+                addEdge(edges, ax, ay, p1.x, p1.y, bounds);
+            }
+            else {
+                addEdge(edges, p1.x, p1.y, ax, ay, bounds);
+                addEdge(edges, ax, ay, mx, my, bounds);
+                addEdge(edges, mx, my, bx, by, bounds);
+                addEdge(edges, bx, by, p1.x, p1.y, bounds);
+            }
+        }
+        else if (reverse) {
+            addEdge(edges, p1.x, p1.y, bx, by, bounds);
+            addEdge(edges, bx, by, ax, ay, bounds);
+            addEdge(edges, ax, ay, p1.x, p1.y, bounds);
+        }
+        else {
+            addEdge(edges, p1.x, p1.y, ax, ay, bounds);
+            addEdge(edges, ax, ay, bx, by, bounds);
+            addEdge(edges, bx, by, p1.x, p1.y, bounds);
+        }
+    };
+    for (size_t s = 0; s < m_subpaths.size(); ++s) {
+        const size_t first = m_subpaths[s].first;
+        const size_t end = s + 1 < m_subpaths.size() ? m_subpaths[s + 1].first : m_path.size();
+        const size_t count = end - first;
+        const bool closed = m_subpaths[s].second;
+        const size_t segments = closed ? count : count - 1;
+        for (size_t i = 0; i < segments && count > 1; ++i) {
+            const auto& p0 = m_path[first + i];
+            const auto& p1 = m_path[first + (i + 1) % count];
+            const double dx = p1.x - p0.x;
+            const double dy = p1.y - p0.y;
+            const double len = std::sqrt(dx * dx + dy * dy);
+            if (len <= 0.0) {
+                continue;
+            }
+            const double nx = -dy / len * hw;
+            const double ny = dx / len * hw;
+            addEdge(edges, p0.x + nx, p0.y + ny, p1.x + nx, p1.y + ny, bounds);
+            addEdge(edges, p1.x + nx, p1.y + ny, p1.x - nx, p1.y - ny, bounds);
+            addEdge(edges, p1.x - nx, p1.y - ny, p0.x - nx, p0.y - ny, bounds);
+            addEdge(edges, p0.x - nx, p0.y - ny, p0.x + nx, p0.y + ny, bounds);
+            if (i + 1 < segments || closed) {
+                join(p0, p1, m_path[first + (i + 2) % count]);
+            }
+        }
+    }
+}
+
+void
+Rasterizer::stroke(double width, const RasterPaint& paint)
+{
+    Bounds bounds{EMPTY_BOUNDS};
+    const auto firstEdge = static_cast<uint32_t>(m_edges.size());
+    addStrokeEdges(m_edges, width, bounds);
+    newPath();
+    if (m_clip != NO_CLIP) {
+        bounds = bounds.intersect(m_clips[m_clip].bounds);
+    }
+    bounds = bounds.intersect(Bounds{0, 0, m_width, m_height});
+    if (bounds.isEmpty()) {
+        m_edges.resize(firstEdge);
+        return;
+    }
+    m_shapes.push_back(Shape{firstEdge, static_cast<uint32_t>(m_edges.size()) - firstEdge
+                           , bounds, addPaint(paint), m_clip, nullptr, 0, 0, 0});
+}
+
+void
+Rasterizer::clip()
+{
+    Bounds bounds{EMPTY_BOUNDS};
+    const auto firstEdge = static_cast<uint32_t>(m_clipEdges.size());
+    for (size_t s = 0; s < m_subpaths.size(); ++s) {
+        const size_t end = s + 1 < m_subpaths.size() ? m_subpaths[s + 1].first : m_path.size();
+        addSubpathEdges(m_clipEdges, m_subpaths[s].first, end, true, bounds);
+    }
+    newPath();
+    if (m_clip != NO_CLIP) {
+        bounds = bounds.intersect(m_clips[m_clip].bounds);
+    }
+    bounds = bounds.intersect(Bounds{0, 0, m_width, m_height});
+    m_clips.push_back(Clip{firstEdge, static_cast<uint32_t>(m_clipEdges.size()) - firstEdge, bounds, m_clip});
+    m_clip = static_cast<int>(m_clips.size()) - 1;
+}
+
+int
+Rasterizer::getClip() const
+{
+    return m_clip;
+}
+
+void
+Rasterizer::setClip(int clip)
+{
+    m_clip = clip;
+}
+
+void
+Rasterizer::mask(const uint8_t* alpha, int width, int height, int stride, int left, int top, const RasterPaint& paint)
+{
+    Bounds bounds{left, top, left + width, top + height};
+    if (m_clip != NO_CLIP) {
+        bounds = bounds.intersect(m_clips[m_clip].bounds);
+    }
+    bounds = bounds.intersect(Bounds{0, 0, m_width, m_height});
+    if (bounds.isEmpty()) {
+        return;
+    }
+    m_shapes.push_back(Shape{0u, 0u, bounds, addPaint(paint), m_clip, alpha, stride, left, top});
+}
+
+uint32_t
+Rasterizer::addPaint(const RasterPaint& paint)
+{
+    if (!m_paints.empty()) {    // reuse if drawing continues with the same paint
+        const auto& last = m_paints.back();
+        if (last.gradient == paint.gradient
+         && last.color[0] == paint.color[0]
+         && last.color[1] == paint.color[1]
+         && last.color[2] == paint.color[2]
+         && last.color[3] == paint.color[3]) {
+            return static_cast<uint32_t>(m_paints.size()) - 1u;
+        }
+    }
+    m_paints.push_back(paint);
+    return static_cast<uint32_t>(m_paints.size()) - 1u;
+}
+
+size_t
+Rasterizer::getShapeCount() const
+{
+    return m_shapes.size();
+}
+
+void
+Rasterizer::render(BandPool* pool)
+{
+    if (m_shapes.empty()) {
+        return;
+    }
+    // a band shall have some rows to be worth the setup
+    const uint32_t threads = pool
+                           ? std::clamp(pool->getThreads(), 1u, static_cast<uint32_t>(std::max(1, m_height / 32)))
+                           : 1u;
+    std::vector<Band> bands(threads);
+    for (uint32_t t = 0; t < threads; ++t) {
+        bands[t].top = static_cast<int>(static_cast<int64_t>(m_height) * t / threads);
+        bands[t].bottom = static_cast<int>(static_cast<int64_t>(m_height) * (t + 1) / threads);
+    }
+    if (threads == 1) {
+        renderBand(bands[0]);
+    }
+    else {
+        pool->run(threads, [this, &bands] (uint32_t band) {
+            renderBand(bands[band]);
+        });
+    }
+    m_shapes.clear();
+    m_edges.clear();
+    m_paints.clear();
+}
+
+void
+Rasterizer::renderBand(Band& band)
+{
+    const Bounds bandBounds{0, band.top, m_width, band.bottom};
+    band.clipMasks.resize(m_clips.size());
+    std::vector<float> coverage;
+    for (auto& shape : m_shapes) {
+        const auto bounds = shape.bounds.intersect(bandBounds);
+        if (bounds.isEmpty()) {
+            continue;
+        }
+        const float* clipMask = shape.clip != NO_CLIP ? getClipMask(shape.clip, band) : nullptr;
+        const auto& paint = m_paints[shape.paint];
+        const int w = bounds.right - bounds.left;
+        if (shape.mask) {
+            coverage.resize(static_cast<size_t>(w));
+            for (int y = bounds.top; y < bounds.bottom; ++y) {
+                const uint8_t* alpha = shape.mask + (y - shape.maskTop) * shape.maskStride + (bounds.left - shape.maskLeft);
+                for (int x = 0; x < w; ++x) {
+                    coverage[x] = static_cast<float>(alpha[x]) * (1.0f / 255.0f);
+                }
+                const float* clipRow = clipMask ? clipMask + static_cast<size_t>(y - band.top) * m_width : nullptr;
+                compose(m_data + static_cast<size_t>(y) * m_stride, bounds.left, bounds.right, y, coverage.data(), clipRow, paint);
+            }
+        }
+        else {
+            accumulate(&m_edges[shape.firstEdge], shape.edgeCount, bounds, band.acc);
+            for (int y = bounds.top; y < bounds.bottom; ++y) {
+                float* row = band.acc.data() + static_cast<size_t>(y - bounds.top) * (w + 2);
+                float sum{};
+                for (int x = 0; x < w; ++x) {
+                    sum += row[x];
+                    row[x] = std::min(1.0f, std::abs(sum));
+                }
+                const float* clipRow = clipMask ? clipMask + static_cast<size_t>(y - band.top) * m_width : nullptr;
+                compose(m_data + static_cast<size_t>(y) * m_stride, bounds.left, bounds.right, y, row, clipRow, paint);
+            }
+        }
+    }
+}
+
+// the mask is computed on first use in a band
+const float*
+Rasterizer::getClipMask(int clip, Band& band)
+{
+    auto& mask = band.clipMasks[clip];
+    if (!mask.empty()) {
+        return mask.data();
+    }
+    const int h = band.bottom - band.top;
+    mask.assign(static_cast<size_t>(m_width) * h, 0.0f);
+    const auto& clipRec = m_clips[clip];
+    const auto bounds = clipRec.bounds.intersect(Bounds{0, band.top, m_width, band.bottom});
+    if (bounds.isEmpty()) {
+        return mask.data();
+    }
+    const float* parent = clipRec.parent != NO_CLIP ? getClipMask(clipRec.parent, band) : nullptr;
+    const int w = bounds.right - bounds.left;
+    std::vector<float> acc;
+    accumulate(&m_clipEdges[clipRec.firstEdge], clipRec.edgeCount, bounds, acc);
+    for (int y = bounds.top; y < bounds.bottom; ++y) {
+        const float* row = acc.data() + static_cast<size_t>(y - bounds.top) * (w + 2);
+        float* dst = mask.data() + static_cast<size_t>(y - band.top) * m_width;
+        const float* par = parent ? parent + static_cast<size_t>(y - band.top) * m_width : nullptr;
+        float sum{};
+        for (int x = 0; x < w; ++x) {
+            sum += row[x];
+            float c = std::min(1.0f, std::abs(sum));
+            dst[bounds.left + x] = par ? c * par[bounds.left + x] : c;
+        }
+    }
+    return mask.data();
+}
+
+void
+Rasterizer::accumulate(const Edge* edges, size_t count, const Bounds& window, std::vector<float>& acc)
+{
+    const int w = window.right - window.left;
+    const int h = window.bottom - window.top;
+    acc.assign(static_cast<size_t>(w + 2) * h, 0.0f);
+    const float left = static_cast<float>(window.left);
+    const float top = static_cast<float>(window.top);
+    for (size_t i = 0; i < count; ++i) {
+        const auto& e = edges[i];
+        line(e.x0 - left, e.y0 - top, e.x1 - left, e.y1 - top, w, h, acc.data());
+    }
+}
+
+// the parts left/right of the window are clamped to the border,
+//   as vertical lines they keep their contribution to the winding
+void
+Rasterizer::line(float x0, float y0, float x1, float y1, int w, int h, float* acc)
+{
+    const float fw = static_cast<float>(w);
+    for (float border : {0.0f, fw}) {
+        if ((x0 < border && x1 > border)
+         || (x0 > border && x1 < border)) {
+            const float ym = y0 + (border - x0) * (y1 - y0) / (x1 - x0);
+            line(x0, y0, border, ym, w, h, acc);
+            line(border, ym, x1, y1, w, h, acc);
+            return;
+        }
+    }
+    rasterLine(std::clamp(x0, 0.0f, fw), y0, std::clamp(x1, 0.0f, fw), y1, w, h, acc);
+}
+
+void
+Rasterizer::rasterLine(float x0, float y0, float x1, float y1, int w, int h, float* acc)
+{
+    if (y0 == y1) {
+        return;
+    }
+    float dir = 1.0f;
+    if (y0 > y1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        dir = -1.0f;
+    }
+    const float fh = static_cast<float>(h);
+    if (y1 <= 0.0f || y0 >= fh) {
+        return;
+    }
+    const float dxdy = (x1 - x0) / (y1 - y0);
+    float x = x0;
+    if (y0 < 0.0f) {
+        x -= y0 * dxdy;
+        y0 = 0.0f;
+    }
+    y1 = std::min(y1, fh);
+    const int yEnd = static_cast<int>(std::ceil(y1));
+    const size_t stride = static_cast<size_t>(w + 2);
+    for (int y = static_cast<int>(y0); y < yEnd; ++y) {
+        float* row = acc + y * stride;
+        const float dy = std::min(static_cast<float>(y + 1), y1) - std::max(static_cast<float>(y), y0);
+        const float xnext = std::clamp(x + dxdy * dy, 0.0f, static_cast<float>(w));
+        const float d = dy * dir;
+        const float xa = std::min(x, xnext);
+        const float xb = std::max(x, xnext);
+        const float xaFloor = std::floor(xa);
+        const int xai = static_cast<int>(xaFloor);
+        const float xbCeil = std::ceil(xb);
+        const int xbi = static_cast<int>(xbCeil);
+        if (xbi <= xai + 1) {
+            const float xmf = 0.5f * (x + xnext) - xaFloor;
+            row[xai] += d - d * xmf;
+            row[xai + 1] += d * xmf;
+        }
+        else {
+            const float s = 1.0f / (xb - xa);
+            const float xaf = xa - xaFloor;
+            const float a0 = 0.5f * s * (1.0f - xaf) * (1.0f - xaf);
+            const float xbf = xb - xbCeil + 1.0f;
+            const float am = 0.5f * s * xbf * xbf;
+            row[xai] += d * a0;
+            if (xbi == xai + 2) {
+                row[xai + 1] += d * (1.0f - a0 - am);
+            }
+            else {
+                const float a1 = s * (1.5f - xaf);
+                row[xai + 1] += d * (a1 - a0);
+                for (int xi = xai + 2; xi < xbi - 1; ++xi) {
+                    row[xi] += d * s;
+                }
+                const float a2 = a1 + static_cast<float>(xbi - xai - 3) * s;
+                row[xbi - 1] += d * (1.0f - a2 - am);
+            }
+            row[xbi] += d * am;
+        }
+        x = xnext;
+    }
+}
+
+f32x4
+Rasterizer::gradientColor(const RasterGradient& gradient, double x, double y)
+{
+    const auto& stops = gradient.stops;
+    if (stops.empty()) {
+        return f32x4{};
+    }
+    const double dx = x - gradient.cx;
+    const double dy = y - gradient.cy;
+    const double range = gradient.r1 - gradient.r0;
+    double t = range > 0.0 ? (std::sqrt(dx * dx + dy * dy) - gradient.r0) / range : 1.0;
+    if (t <= stops.front().first) {
+        return stops.front().second;
+    }
+    for (size_t i = 1; i < stops.size(); ++i) {
+        if (t <= stops[i].first) {
+            const double span = stops[i].first - stops[i - 1].first;
+            const float f = span > 0.0 ? static_cast<float>((t - stops[i - 1].first) / span) : 1.0f;
+            return stops[i - 1].second + (stops[i].second - stops[i - 1].second) * f;
+        }
+    }
+    return stops.back().second;
+}
+
+[[gnu::always_inline]] static inline f32x4
+unpack(uint32_t p)
+{
+    return f32x4{static_cast<float>(p & 0xffu)
+               , static_cast<float>((p >> 8) & 0xffu)
+               , static_cast<float>((p >> 16) & 0xffu)
+               , static_cast<float>(p >> 24)};
+}
+
+[[gnu::always_inline]] static inline uint32_t
+pack(f32x4 c)
+{
+    c += 0.5f;
+    return static_cast<uint32_t>(std::min(c[0], 255.0f))
+        | (static_cast<uint32_t>(std::min(c[1], 255.0f)) << 8)
+        | (static_cast<uint32_t>(std::min(c[2], 255.0f)) << 16)
+        | (static_cast<uint32_t>(std::min(c[3], 255.0f)) << 24);
+}
+
+// source over, the channels of a pixel are processed as one vector
+void
+Rasterizer::compose(uint32_t* row, int left, int right, int y, const float* coverage, const float* clipRow, const RasterPaint& paint)
+{
+    if (paint.gradient) {
+        const double cy = static_cast<double>(y) + 0.5;
+        for (int x = left; x < right; ++x) {
+            float c = coverage[x - left];
+            if (clipRow) {
+                c *= clipRow[x];
+            }
+            if (c <= 0.0f) {
+                continue;
+            }
+            const f32x4 src = gradientColor(*paint.gradient, static_cast<double>(x) + 0.5, cy) * c;
+            row[x] = pack(src + unpack(row[x]) * (1.0f - src[3] * (1.0f / 255.0f)));
+        }
+        return;
+    }
+    const f32x4 src = paint.color;
+    const bool opaque = src[3] >= 255.0f;
+    const uint32_t packed = pack(src);
+    for (int x = left; x < right; ++x) {
+        float c = coverage[x - left];
+        if (clipRow) {
+            c *= clipRow[x];
+        }
+        if (c <= 0.0f) {
+            continue;
+        }
+        if (opaque && c >= 1.0f) {
+            // the inner span is a plain fill
+            int end = x + 1;
+            while (end < right
+                && coverage[end - left] >= 1.0f
+                && (!clipRow || clipRow[end] >= 1.0f)) {
+                ++end;
+            }
+            std::fill(row + x, row + end, packed);
+            x = end - 1;
+            continue;
+        }
+        const f32x4 s = src * c;
+        row[x] = pack(s + unpack(row[x]) * (1.0f - s[3] * (1.0f / 255.0f)));
+    }
+}
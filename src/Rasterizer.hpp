@@ -0,0 +1,162 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <utility>
+
+class BandPool;
+
+// the lanes are the channels in the order of the shifts of a ARGB32 pixel (b, g, r, a)
+typedef float f32x4 __attribute__((vector_size(16)));
+
+// concentric radial gradient as used for the sky and diffuse dots, extends the end colors
+struct RasterGradient
+{
+    double cx{};
+    double cy{};
+    double r0{};
+    double r1{};
+    std::vector<std::pair<double, f32x4>> stops;   // ordered by position
+};
+
+struct RasterPaint
+{
+    f32x4 color{};      // premultiplied 0..255, used if there is no gradient
+    std::shared_ptr<const RasterGradient> gradient;
+
+    static f32x4 premultiply(double r, double g, double b, double a);
+};
+
+/**
+ * anti-aliased scanline rasterizer for ARGB32 (premultiplied) images,
+ *   the coverage is accumulated from the signed area of the edges (as font-rs).
+ * The shapes are recorded and rasterized on render,
+ *   which splits the image into row bands that are processed in parallel
+ *   by the threads of a BandPool.
+ * Shapes of the same winding direction are combined (the coverage is clamped),
+ *   so this works as non-zero rule for the shapes we use (no self intersection).
+ */
+class Rasterizer
+{
+public:
+    Rasterizer(uint32_t* data, int width, int height, int stride);
+    explicit Rasterizer(const Rasterizer& orig) = delete;
+    virtual ~Rasterizer() = default;
+
+    static constexpr int NO_CLIP{-1};
+    static constexpr auto MITER_LIMIT{10.0};    // as cairo, sharper joins are beveled
+
+    // the path in pixel coordinates
+    void moveTo(double x, double y);
+    void lineTo(double x, double y);
+    void closePath();
+    void newPath();
+    bool hasPath() const;
+    // these use and clear the path
+    void fill(const RasterPaint& paint);
+    void stroke(double width, const RasterPaint& paint);
+    // fill the image (inside the clip), keeps the path
+    void paint(const RasterPaint& paint);
+    // intersects the clip with the path
+    void clip();
+    int getClip() const;
+    void setClip(int clip);
+    // the alpha data has to be kept until render
+    void mask(const uint8_t* alpha, int width, int height, int stride, int left, int top, const RasterPaint& paint);
+    // draws the recorded shapes, with a pool the bands are drawn in parallel
+    void render(BandPool* pool = nullptr);
+    size_t getShapeCount() const;
+
+protected:
+    struct Edge
+    {
+        float x0, y0, x1, y1;
+    };
+    struct Bounds
+    {
+        int left, top, right, bottom;   // right, bottom exclusive
+        bool isEmpty() const
+        {
+            return left >= right || top >= bottom;
+        }
+        Bounds intersect(const Bounds& other) const;
+    };
+    static constexpr Bounds EMPTY_BOUNDS{INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+    struct Shape
+    {
+        uint32_t firstEdge;
+        uint32_t edgeCount;
+        Bounds bounds;
+        uint32_t paint;
+        int clip;
+        const uint8_t* mask;
+        int maskStride;
+        int maskLeft;
+        int maskTop;
+    };
+    struct Clip
+    {
+        uint32_t firstEdge;
+        uint32_t edgeCount;
+        Bounds bounds;  // includes parent
+        int parent;
+    };
+    // per thread buffers
+    struct Band
+    {
+        int top;
+        int bottom;
+        std::vector<float> acc;
+        std::vector<std::vector<float>> clipMasks;  // full width for the rows of the band
+    };
+
+    void addSubpathEdges(std::vector<Edge>& edges, size_t first, size_t end, bool close, Bounds& bounds);
+    void addStrokeEdges(std::vector<Edge>& edges, double width, Bounds& bounds);
+    void addEdge(std::vector<Edge>& edges, double x0, double y0, double x1, double y1, Bounds& bounds);
+    uint32_t addPaint(const RasterPaint& paint);
+    void renderBand(Band& band);
+    const float* getClipMask(int clip, Band& band);
+    static void accumulate(const Edge* edges, size_t count, const Bounds& window, std::vector<float>& acc);
+    static void line(float x0, float y0, float x1, float y1, int w, int h, float* acc);
+    static void rasterLine(float x0, float y0, float x1, float y1, int w, int h, float* acc);
+    // coverage is indexed from left, clipRow from 0 (if given)
+    static void compose(uint32_t* row, int left, int right, int y, const float* coverage, const float* clipRow, const RasterPaint& paint);
+    static f32x4 gradientColor(const RasterGradient& gradient, double x, double y);
+
+private:
+    uint32_t* m_data;
+    int m_width;
+    int m_height;
+    int m_stride;       // in pixel
+    struct Point
+    {
+        double x, y;
+    };
+    std::vector<Point> m_path;
+    std::vector<std::pair<uint32_t, bool>> m_subpaths;  // first point, closed
+    std::vector<Edge> m_edges;
+    std::vector<Shape> m_shapes;
+    std::vector<RasterPaint> m_paints;
+    std::vector<Edge> m_clipEdges;
+    std::vector<Clip> m_clips;
+    int m_clip{NO_CLIP};
+};
@@ -0,0 +1,568 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "RecordingRenderer.hpp"
+
+RecordingGradient::RecordingGradient(double x0, double y0, double r0, double x1, double y1, double r1)
+: RenderGradient()
+, m_x0{x0}
+, m_y0{y0}
+, m_r0{r0}
+, m_x1{x1}
+, m_y1{y1}
+, m_r1{r1}
+{
+}
+
+void
+RecordingGradient::addColorStop(double pos, RenderColor& rgba)
+{
+    m_stops.emplace_back(pos, rgba);
+}
+
+void
+RecordingGradient::addColorStop(double pos, Gdk::RGBA& rgba)
+{
+    m_stops.emplace_back(pos, RenderColor(rgba.get_red(), rgba.get_green(), rgba.get_blue(), rgba.get_alpha()));
+}
+
+std::shared_ptr<RenderGradient>
+RecordingGradient::create(Renderer* target)
+{
+    auto gradient = target->createRadialGradient(m_x0, m_y0, m_r0, m_x1, m_y1, m_r1);
+    for (auto& stop : m_stops) {
+        gradient->addColorStop(stop.first, stop.second);
+    }
+    return gradient;
+}
+
+RecordingText::RecordingText(const Glib::RefPtr<Pango::Layout>& layout, uint32_t font)
+: m_layout{layout}
+, m_font{font}
+{
+}
+
+void
+RecordingText::setText(const Glib::ustring& text)
+{
+    m_layout->set_text(text);
+}
+
+void
+RecordingText::getSize(double& width, double& height)
+{
+    int iwidth{}, iheigh{};
+    m_layout->get_pixel_size(iwidth, iheigh);
+    width = static_cast<double>(iwidth);
+    height = static_cast<double>(iheigh);
+}
+
+Glib::ustring
+RecordingText::getText()
+{
+    return m_layout->get_text();
+}
+
+uint32_t
+RecordingText::getFont()
+{
+    return m_font;
+}
+
+RecordingRenderer::RecordingRenderer()
+{
+    // only used to measure text
+    auto textSurface = Cairo::ImageSurface::create(Cairo::Format::FORMAT_A8, 1, 1);
+    m_textCtx = Cairo::Context::create(textSurface);
+}
+
+uint32_t
+RecordingRenderer::add(Op op, std::initializer_list<double> args, double top, double bottom)
+{
+    m_commands.push_back(Command{op, static_cast<uint32_t>(m_args.size()), static_cast<uint32_t>(args.size()), top, bottom, NO_END});
+    m_args.insert(m_args.end(), args);
+    return static_cast<uint32_t>(m_commands.size()) - 1u;
+}
+
+void
+RecordingRenderer::extendPath(double y0, double y1)
+{
+    if (m_pathStart == NO_END) {
+        m_pathStart = static_cast<uint32_t>(m_commands.size()) - 1u;
+    }
+    m_pathTop = std::min(m_pathTop, std::min(y0, y1) + m_state.ty);
+    m_pathBottom = std::max(m_pathBottom, std::max(y0, y1) + m_state.ty);
+}
+
+void
+RecordingRenderer::endPath(uint32_t end)
+{
+    if (m_pathStart != NO_END) {
+        for (uint32_t i = m_pathStart; i < end; ++i) {
+            m_commands[i].end = end;
+        }
+    }
+    m_pathStart = NO_END;
+    m_pathTop = INFINITY;
+    m_pathBottom = -INFINITY;
+}
+
+bool
+RecordingRenderer::intersects(const Command& command, double top, double bottom)
+{
+    return command.bottom >= top && command.top <= bottom;
+}
+
+std::shared_ptr<RenderGradient>
+RecordingRenderer::createRadialGradient(double x0, double y0, double r0, double x1, double y1, double r1)
+{
+    auto gradient = std::make_shared<RecordingGradient>(x0, y0, r0, x1, y1, r1);
+    m_gradients.push_back(gradient);
+    return gradient;
+}
+
+void
+RecordingRenderer::setSource(std::shared_ptr<RenderGradient>& grad)
+{
+    auto iter = std::find(m_gradients.begin(), m_gradients.end(), grad);
+    if (iter != m_gradients.end()) {
+        add(Op::SetGradient, {static_cast<double>(iter - m_gradients.begin())});
+    }
+    else {
+        std::cout << "RecordingRenderer::setSource wrong instance given!" << std::endl;
+    }
+}
+
+void
+RecordingRenderer::rectangle(double x0, double y0, double width, double height)
+{
+    add(Op::Rectangle, {x0, y0, width, height});
+    extendPath(y0, y0 + height);
+}
+
+void
+RecordingRenderer::fill()
+{
+    auto end = add(Op::Fill, {}, m_pathTop - EXTENT_MARGIN, m_pathBottom + EXTENT_MARGIN);
+    endPath(end);
+}
+
+void
+RecordingRenderer::translate(double x0, double y0)
+{
+    add(Op::Translate, {x0, y0});
+    m_state.tx += x0;
+    m_state.ty += y0;
+}
+
+void
+RecordingRenderer::circle(double x0, double y0, double r)
+{
+    add(Op::Circle, {x0, y0, r});
+    extendPath(y0 - r, y0 + r);
+}
+
+void
+RecordingRenderer::clip()
+{
+    auto end = add(Op::Clip, {});   // applies to all bands
+    endPath(end);
+}
+
+void
+RecordingRenderer::setSource(RenderColor& rgba)
+{
+    add(Op::SetColor, {rgba.getRed(), rgba.getGreen(), rgba.getBlue(), rgba.getAlpha()});
+}
+
+void
+RecordingRenderer::setTrueSource(RenderColor& rgba)
+{
+    add(Op::SetTrueColor, {rgba.getRed(), rgba.getGreen(), rgba.getBlue(), rgba.getAlpha()});
+}
+
+std::shared_ptr<RenderText>
+RecordingRenderer::createText(Pango::FontDescription& fontDesc)
+{
+    auto pangoLayout = Pango::Layout::create(m_textCtx);
+    pangoLayout->set_font_description(fontDesc);
+    m_fonts.push_back(fontDesc);
+    return std::make_shared<RecordingText>(pangoLayout, static_cast<uint32_t>(m_fonts.size()) - 1u);
+}
+
+void
+RecordingRenderer::moveTo(double x, double y)
+{
+    add(Op::MoveTo, {x, y});
+    extendPath(y, y);
+}
+
+void
+RecordingRenderer::lineTo(double x, double y)
+{
+    add(Op::LineTo, {x, y});
+    extendPath(y, y);
+}
+
+void
+RecordingRenderer::showText(std::shared_ptr<RenderText>& text, double x, double y, TextAlign textAlign)
+{
+    auto recordingText = std::dynamic_pointer_cast<RecordingText>(text);
+    if (recordingText) {
+        double width, height;
+        recordingText->getSize(width, height);
+        double top = y;     // as aligned by the renderers
+        switch (textAlign) {
+            case TextAlign::LeftTop:
+                break;
+            case TextAlign::LeftBottom:
+                top -= height;
+                break;
+            case TextAlign::LeftMid:
+            case TextAlign::RightMid:
+                top -= height / 2.0;
+                break;
+        }
+        m_texts.push_back(recordingText->getText());
+        add(Op::ShowText, {x, y, static_cast<double>(textAlign)
+                         , static_cast<double>(recordingText->getFont())
+                         , static_cast<double>(m_texts.size() - 1u)}
+          , top + m_state.ty - EXTENT_MARGIN, top + height + m_state.ty + EXTENT_MARGIN);
+    }
+    else {
+        std::cout << "RecordingRenderer::showText wrong instance given!" << std::endl;
+    }
+}
+
+void
+RecordingRenderer::save()
+{
+    add(Op::Save, {});
+    m_stack.push_back(m_state);
+}
+
+void
+RecordingRenderer::restore()
+{
+    add(Op::Restore, {});
+    if (!m_stack.empty()) {
+        m_state = m_stack.back();
+        m_stack.pop_back();
+    }
+}
+
+// the pending path is dropped
+void
+RecordingRenderer::beginNewPath()
+{
+    m_pathStart = NO_END;
+    m_pathTop = INFINITY;
+    m_pathBottom = -INFINITY;
+}
+
+void
+RecordingRenderer::setLineWidth(double width)
+{
+    add(Op::SetLineWidth, {width});
+    m_state.lineWidth = width;
+}
+
+void
+RecordingRenderer::curveTo(double x, double y, double e0, double r0, double e1, double r1)
+{
+    add(Op::CurveTo, {x, y, e0, r0, e1, r1});
+    extendPath(std::min(y, std::min(r0, r1)), std::max(y, std::max(r0, r1)));    // the control points contain the curve
+}
+
+void
+RecordingRenderer::closePath()
+{
+    add(Op::ClosePath, {});
+}
+
+void
+RecordingRenderer::stroke()
+{
+    const double extend = m_state.lineWidth / 2.0 * MITER_LIMIT + EXTENT_MARGIN;
+    auto end = add(Op::Stroke, {}, m_pathTop - extend, m_pathBottom + extend);
+    endPath(end);
+}
+
+void
+RecordingRenderer::paint()
+{
+    add(Op::Paint, {});
+}
+
+void
+RecordingRenderer::dot(double x, double y, double r)
+{
+    add(Op::Dot, {x, y, r}, y - r + m_state.ty - EXTENT_MARGIN, y + r + m_state.ty + EXTENT_MARGIN);
+}
+
+void
+RecordingRenderer::diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop)
+{
+    add(Op::DiffuseDot, {x, y, r
+                       , start.getRed(), start.getGreen(), start.getBlue(), start.getAlpha()
+                       , stop.getRed(), stop.getGreen(), stop.getBlue(), stop.getAlpha()}
+      , y - r + m_state.ty - EXTENT_MARGIN, y + r + m_state.ty + EXTENT_MARGIN);
+}
+
+void
+RecordingRenderer::showPhase(Phase phase, double x, double y, double radius)
+{
+    add(Op::ShowPhase, {phase.getAngle(), x, y, radius}
+      , y - radius + m_state.ty - EXTENT_MARGIN, y + radius + m_state.ty + EXTENT_MARGIN);
+}
+
+// args are ty, count, x..., y..., r...
+void
+RecordingRenderer::dots(std::span<const double> x, std::span<const double> y, std::span<const double> r)
+{
+    if (x.empty()) {
+        return;
+    }
+    auto cmd = add(Op::Dots, {m_state.ty, static_cast<double>(x.size())});
+    m_args.insert(m_args.end(), x.begin(), x.end());
+    m_args.insert(m_args.end(), y.begin(), y.end());
+    m_args.insert(m_args.end(), r.begin(), r.end());
+    m_commands[cmd].count = static_cast<uint32_t>(m_args.size() - m_commands[cmd].arg);
+}
+
+// args are ty, extend, point count, line count, x..., y..., offsets...
+void
+RecordingRenderer::polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets)
+{
+    if (x.empty()) {
+        return;
+    }
+    auto cmd = add(Op::Polylines, {m_state.ty, m_state.lineWidth / 2.0 * MITER_LIMIT + EXTENT_MARGIN
+                                 , static_cast<double>(x.size()), static_cast<double>(offsets.size())});
+    m_args.insert(m_args.end(), x.begin(), x.end());
+    m_args.insert(m_args.end(), y.begin(), y.end());
+    m_args.insert(m_args.end(), offsets.begin(), offsets.end());
+    m_commands[cmd].count = static_cast<uint32_t>(m_args.size() - m_commands[cmd].arg);
+}
+
+size_t
+RecordingRenderer::getOperationCount() const
+{
+    return m_commands.size();
+}
+
+void
+RecordingRenderer::replay(Renderer* target, double top, double bottom)
+{
+    std::vector<std::shared_ptr<RenderGradient>> gradients(m_gradients.size());
+    std::vector<std::shared_ptr<RenderText>> texts(m_fonts.size());
+    DotBatch dotBatch;
+    PolylineBatch lineBatch;
+    for (auto& cmd : m_commands) {
+        const double* a = m_args.data() + cmd.arg;
+        if (cmd.end != NO_END
+         && !intersects(m_commands[cmd.end], top, bottom)) {
+            continue;   // path of a operation outside
+        }
+        switch (cmd.op) {
+        case Op::Save:
+            target->save();
+            break;
+        case Op::Restore:
+            target->restore();
+            break;
+        case Op::Translate:
+            target->translate(a[0], a[1]);
+            break;
+        case Op::SetColor: {
+            RenderColor color(a[0], a[1], a[2], a[3]);
+            target->setSource(color);
+            break;
+        }
+        case Op::SetTrueColor: {
+            RenderColor color(a[0], a[1], a[2], a[3]);
+            target->setTrueSource(color);
+            break;
+        }
+        case Op::SetGradient: {
+            auto& gradient = gradients[static_cast<size_t>(a[0])];
+            if (!gradient) {
+                gradient = m_gradients[static_cast<size_t>(a[0])]->create(target);
+            }
+            target->setSource(gradient);
+            break;
+        }
+        case Op::SetLineWidth:
+            target->setLineWidth(a[0]);
+            break;
+        case Op::MoveTo:
+            if (cmd.end != NO_END) {
+                target->moveTo(a[0], a[1]);
+            }
+            break;
+        case Op::LineTo:
+            if (cmd.end != NO_END) {
+                target->lineTo(a[0], a[1]);
+            }
+            break;
+        case Op::CurveTo:
+            if (cmd.end != NO_END) {
+                target->curveTo(a[0], a[1], a[2], a[3], a[4], a[5]);
+            }
+            break;
+        case Op::Circle:
+            if (cmd.end != NO_END) {
+                target->circle(a[0], a[1], a[2]);
+            }
+            break;
+        case Op::Rectangle:
+            if (cmd.end != NO_END) {
+                target->rectangle(a[0], a[1], a[2], a[3]);
+            }
+            break;
+        case Op::ClosePath:
+            if (cmd.end != NO_END) {
+                target->closePath();
+            }
+            break;
+        case Op::Fill:
+            if (intersects(cmd, top, bottom)) {
+                target->fill();
+            }
+            break;
+        case Op::Stroke:
+            if (intersects(cmd, top, bottom)) {
+                target->stroke();
+            }
+            break;
+        case Op::Clip:
+            target->clip();
+            break;
+        case Op::Paint:
+            target->paint();
+            break;
+        case Op::Dot:
+            if (intersects(cmd, top, bottom)) {
+                target->dot(a[0], a[1], a[2]);
+            }
+            break;
+        case Op::DiffuseDot:
+            if (intersects(cmd, top, bottom)) {
+                RenderColor start(a[3], a[4], a[5], a[6]);
+                RenderColor stop(a[7], a[8], a[9], a[10]);
+                target->diffuseDot(a[0], a[1], a[2], start, stop);
+            }
+            break;
+        case Op::ShowPhase:
+            if (intersects(cmd, top, bottom)) {
+                target->showPhase(Phase(a[0]), a[1], a[2], a[3]);
+            }
+            break;
+        case Op::ShowText:
+            if (intersects(cmd, top, bottom)) {
+                auto& text = texts[static_cast<size_t>(a[3])];
+                if (!text) {
+                    text = target->createText(m_fonts[static_cast<size_t>(a[3])]);
+                }
+                text->setText(m_texts[static_cast<size_t>(a[4])]);
+                target->showText(text, a[0], a[1], static_cast<TextAlign>(static_cast<int>(a[2])));
+            }
+            break;
+        case Op::Dots: {
+            const double ty = a[0];
+            const auto count = static_cast<size_t>(a[1]);
+            const double* x = a + 2;
+            const double* y = x + count;
+            const double* r = y + count;
+            dotBatch.clear();
+            for (size_t i = 0; i < count; ++i) {
+                if (y[i] + ty + r[i] + EXTENT_MARGIN >= top
+                 && y[i] + ty - r[i] - EXTENT_MARGIN <= bottom) {
+                    dotBatch.add(x[i], y[i], r[i]);
+                }
+            }
+            if (!dotBatch.empty()) {
+                target->dots(dotBatch.getX(), dotBatch.getY(), dotBatch.getRadius());
+            }
+            break;
+        }
+        case Op::Polylines: {
+            const double ty = a[0];
+            const double extend = a[1];
+            const auto count = static_cast<size_t>(a[2]);
+            const auto lines = static_cast<size_t>(a[3]);
+            const double* x = a + 4;
+            const double* y = x + count;
+            const double* offsets = y + count;
+            lineBatch.clear();
+            for (size_t l = 0; l < lines; ++l) {
+                const auto first = static_cast<size_t>(offsets[l]);
+                const size_t end = l + 1 < lines ? static_cast<size_t>(offsets[l + 1]) : count;
+                if (end <= first) {
+                    continue;
+                }
+                auto minmax = std::minmax_element(y + first, y + end);
+                if (*minmax.second + ty + extend >= top
+                 && *minmax.first + ty - extend <= bottom) {
+                    lineBatch.begin();
+                    for (size_t i = first; i < end; ++i) {
+                        lineBatch.add(x[i], y[i]);
+                    }
+                }
+            }
+            if (!lineBatch.empty()) {
+                target->polylines(lineBatch.getX(), lineBatch.getY(), lineBatch.getOffsets());
+            }
+            break;
+        }
+        }
+    }
+}
+
+void
+RecordingRenderer::renderBands(const Cairo::RefPtr<Cairo::ImageSurface>& image, BandPool& pool, std::vector<std::shared_ptr<SpriteAtlas>>& atlases)
+{
+    const int height = image->get_height();
+    const uint32_t bands = std::clamp(pool.getThreads(), 1u, static_cast<uint32_t>(std::max(1, height / MIN_BAND_ROWS)));
+    while (atlases.size() < bands) {
+        atlases.push_back(std::make_shared<SpriteAtlas>());
+    }
+    for (auto& atlas : atlases) {
+        atlas->setSize(image->get_width(), height);
+    }
+    image->flush();
+    // each band gets its own surface on the rows of the image, so the threads share no cairo state
+    auto drawBand = [&] (uint32_t band) {
+        const int top = static_cast<int>(static_cast<int64_t>(height) * band / bands);
+        const int bottom = static_cast<int>(static_cast<int64_t>(height) * (band + 1) / bands);
+        auto bandSurface = Cairo::ImageSurface::create(image->get_data() + static_cast<size_t>(top) * image->get_stride()
+                                                     , image->get_format(), image->get_width(), bottom - top, image->get_stride());
+        auto ctx = Cairo::Context::create(bandSurface);
+        ctx->translate(0.0, static_cast<double>(-top));
+        CairoRenderer renderer(ctx);
+        renderer.setAtlas(atlases[band]);
+        replay(&renderer, static_cast<double>(top), static_cast<double>(bottom));
+        bandSurface->flush();
+    };
+    pool.run(bands, drawBand);
+    image->mark_dirty();
+}
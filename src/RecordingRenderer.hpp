@@ -0,0 +1,178 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtkmm.h>
+#include <vector>
+#include <limits>
+
+#include "Renderer.hpp"
+#include "SpriteAtlas.hpp"
+#include "BandPool.hpp"
+
+class RecordingGradient
+: public RenderGradient
+{
+public:
+    RecordingGradient(double x0, double y0, double r0, double x1, double y1, double r1);
+    explicit RecordingGradient(const RecordingGradient& orig) = delete;
+    virtual ~RecordingGradient() = default;
+
+    void addColorStop(double pos, RenderColor& rgba) override;
+    void addColorStop(double pos, Gdk::RGBA& rgba) override;
+    std::shared_ptr<RenderGradient> create(Renderer* target);
+private:
+    double m_x0, m_y0, m_r0, m_x1, m_y1, m_r1;
+    std::vector<std::pair<double, RenderColor>> m_stops;
+};
+
+class RecordingText
+: public RenderText
+{
+public:
+    RecordingText(const Glib::RefPtr<Pango::Layout>& layout, uint32_t font);
+    explicit RecordingText(const RecordingText& orig) = delete;
+    virtual ~RecordingText() = default;
+    void setText(const Glib::ustring& text) override;
+    void getSize(double& width, double& height) override;
+    Glib::ustring getText();
+    uint32_t getFont();
+private:
+    Glib::RefPtr<Pango::Layout> m_layout;
+    uint32_t m_font;
+};
+
+/**
+ * keeps the drawing operations with their vertical extent (in pixel),
+ *   to replay them for horizontal bands of the image.
+ * Each band only gets the primitives that intersect its rows
+ *   (dots and polylines are filtered individually),
+ *   the state changes (source, translate, clip...) are replayed for all.
+ */
+class RecordingRenderer
+: public Renderer
+{
+public:
+    RecordingRenderer();
+    explicit RecordingRenderer(const RecordingRenderer& orig) = delete;
+    virtual ~RecordingRenderer() = default;
+
+    std::shared_ptr<RenderGradient> createRadialGradient(double x0, double y0, double r0, double x1, double y1, double r1) override;
+    void setSource(std::shared_ptr<RenderGradient>& grad) override;
+    void rectangle(double x0, double y0, double width, double height) override;
+    void fill() override;
+    void translate(double x0, double y0) override;
+    void circle(double x0, double y0, double r) override;
+    void clip() override;
+    void setSource(RenderColor& rgba) override;
+    void setTrueSource(RenderColor& rgba) override;
+
+    std::shared_ptr<RenderText> createText(Pango::FontDescription& fontDesc) override;
+    void moveTo(double x, double y) override;
+    void lineTo(double x, double y) override;
+    void showText(std::shared_ptr<RenderText>& text, double x, double y, TextAlign textAlign) override;
+    void save() override;
+    void restore() override;
+    void beginNewPath() override;
+    void setLineWidth(double width) override;
+    void curveTo(double x, double y, double e0, double r0, double e1, double r1) override;
+    void closePath() override;
+    void stroke() override;
+    void paint() override;
+
+    void dot(double x, double y, double r) override;
+    void diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop) override;
+    void showPhase(Phase phase, double x, double y, double radius) override;
+    void dots(std::span<const double> x, std::span<const double> y, std::span<const double> r) override;
+    void polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets) override;
+
+    // draw the operations that intersect the pixel rows top..bottom
+    void replay(Renderer* target, double top, double bottom);
+    // split the image into horizontal bands, each is drawn by a thread of the pool.
+    //   As the cairomm references are not thread safe each band uses its own atlas
+    //   (kept by the caller to reuse the sprites, added as required)
+    void renderBands(const Cairo::RefPtr<Cairo::ImageSurface>& image, BandPool& pool, std::vector<std::shared_ptr<SpriteAtlas>>& atlases);
+    size_t getOperationCount() const;
+
+    static constexpr auto EXTENT_MARGIN{2.0};   // pixel for anti-aliasing
+    static constexpr auto MIN_BAND_ROWS{64};
+    static constexpr auto MITER_LIMIT{10.0};    // cairo default, a stroke corner may reach lineWidth/2 * this
+
+protected:
+    enum class Op : uint8_t
+    {
+          Save
+        , Restore
+        , Translate
+        , SetColor
+        , SetTrueColor
+        , SetGradient
+        , SetLineWidth
+        , MoveTo
+        , LineTo
+        , CurveTo
+        , Circle
+        , Rectangle
+        , ClosePath
+        , Fill
+        , Stroke
+        , Clip
+        , Paint
+        , Dot
+        , DiffuseDot
+        , ShowPhase
+        , ShowText
+        , Dots
+        , Polylines
+    };
+    static constexpr uint32_t NO_END{std::numeric_limits<uint32_t>::max()};
+    struct Command
+    {
+        Op op;
+        uint32_t arg;       // first in m_args
+        uint32_t count;     // of m_args
+        double top;         // extent in pixel
+        double bottom;
+        uint32_t end;       // for path operations the command that uses the path
+    };
+    uint32_t add(Op op, std::initializer_list<double> args, double top = -INFINITY, double bottom = INFINITY);
+    void extendPath(double y0, double y1);
+    // the path operations are drawn with the operation using them
+    void endPath(uint32_t end);
+    static bool intersects(const Command& command, double top, double bottom);
+
+private:
+    struct State
+    {
+        double tx{};
+        double ty{};
+        double lineWidth{2.0};
+    };
+    std::vector<Command> m_commands;
+    std::vector<double> m_args;
+    std::vector<std::shared_ptr<RecordingGradient>> m_gradients;
+    std::vector<Pango::FontDescription> m_fonts;
+    std::vector<Glib::ustring> m_texts;
+    State m_state;
+    std::vector<State> m_stack;
+    uint32_t m_pathStart{NO_END};
+    double m_pathTop{INFINITY};
+    double m_pathBottom{-INFINITY};
+    Cairo::RefPtr<Cairo::Context> m_textCtx;
+};
@@ -0,0 +1,178 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <algorithm>
+#ifdef __linux
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "RenderAhead.hpp"
+#include "StarPaint.hpp"
+#include "JulianDate.hpp"
+#include "Layout.hpp"
+
+RenderAhead::RenderAhead(StarPaint* starPaint, uint32_t capacity)
+: m_starPaint{starPaint}
+, m_capacity{std::max(capacity, 1u)}
+{
+    m_thread = std::thread(&RenderAhead::run, this);
+}
+
+RenderAhead::~RenderAhead()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void
+RenderAhead::schedule(const std::vector<Glib::DateTime>& times, const GeoPosition& pos, int width, int height)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_times = times;
+        if (m_times.size() > m_capacity) {
+            m_times.resize(m_capacity);
+        }
+        m_pos = pos;
+        m_width = width;
+        m_height = height;
+    }
+    m_condition.notify_one();
+}
+
+Cairo::RefPtr<Cairo::ImageSurface>
+RenderAhead::take(size_t key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = std::find_if(m_frames.begin(), m_frames.end(), [key] (const Frame& frame) {
+        return frame.key == key;
+    });
+    if (iter == m_frames.end()) {
+        ++m_misses;
+        return Cairo::RefPtr<Cairo::ImageSurface>();
+    }
+    auto surface = std::move(iter->surface);
+    m_frames.erase(iter);
+    ++m_hits;
+    return surface;
+}
+
+void
+RenderAhead::invalidate()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames.clear();
+    m_times.clear();
+    ++m_generation;
+}
+
+uint32_t
+RenderAhead::getCapacity() const
+{
+    return m_capacity;
+}
+
+uint32_t
+RenderAhead::getHits() const
+{
+    return m_hits;
+}
+
+uint32_t
+RenderAhead::getMisses() const
+{
+    return m_misses;
+}
+
+bool
+RenderAhead::isCached(size_t key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::any_of(m_frames.begin(), m_frames.end(), [key] (const Frame& frame) {
+        return frame.key == key;
+    });
+}
+
+void
+RenderAhead::run()
+{
+#   ifdef __linux
+    struct sched_param param{};
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) != 0) {
+        std::cout << "RenderAhead::run no idle priority" << std::endl;
+    }
+#   endif
+    while (true) {
+        Glib::DateTime time;
+        GeoPosition pos;
+        int width, height;
+        uint32_t generation;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] {
+                return m_stop || !m_times.empty();
+            });
+            if (m_stop) {
+                break;
+            }
+            time = m_times.front();
+            m_times.erase(m_times.begin());
+            pos = m_pos;
+            width = m_width;
+            height = m_height;
+            generation = m_generation;
+        }
+        Frame frame;
+        try {
+            JulianDate jd(time);
+            Layout layout(width, height);
+            {
+                auto paintLock = m_starPaint->lock();   // short, only for the settings
+                m_starPaint->getSkyStyle(m_scratch.style);
+                frame.key = m_starPaint->getSkyKey(jd, pos, layout);
+            }
+            if (isCached(frame.key)) {
+                continue;
+            }
+            frame.surface = m_starPaint->drawSkyLayer(jd, pos, layout, m_scratch);
+        }
+        catch (const std::exception& exc) {
+            std::cout << "RenderAhead::run error " << exc.what() << std::endl;
+            continue;
+        }
+        catch (const Glib::Error& exc) {
+            std::cout << "RenderAhead::run error " << exc.what() << std::endl;
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (generation == m_generation) {
+            m_frames.push_back(std::move(frame));
+            while (m_frames.size() > m_capacity) {
+                m_frames.pop_front();
+            }
+        }
+    }
+}
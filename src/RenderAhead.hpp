@@ -0,0 +1,85 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtkmm.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+#include "GeoPosition.hpp"
+#include "StarPaint.hpp"
+
+/**
+ * draws the sky layer for the coming updates of the daemon
+ *   on a idle priority thread, so the update only has to add the modules.
+ *   The modules show live values (e.g. the load),
+ *   so they are still drawn on update.
+ *   The frames are kept with the sky key,
+ *   on a changed config the frames are dropped with invalidate,
+ *   the position and size are part of the key.
+ *   The StarPaint lock is only held to take the settings,
+ *   the drawing uses its own scratch, so the foreground update
+ *   never waits for this low priority thread.
+ */
+class RenderAhead
+{
+public:
+    RenderAhead(StarPaint* starPaint, uint32_t capacity);
+    explicit RenderAhead(const RenderAhead& orig) = delete;
+    virtual ~RenderAhead();
+
+    // draw the sky for the given times, replaces the previous plan
+    void schedule(const std::vector<Glib::DateTime>& times, const GeoPosition& pos, int width, int height);
+    // remove the sky for the key, empty if not ready (use with the StarPaint lock)
+    Cairo::RefPtr<Cairo::ImageSurface> take(size_t key);
+    void invalidate();
+    uint32_t getCapacity() const;
+    // updates that found their frame / had to draw it
+    uint32_t getHits() const;
+    uint32_t getMisses() const;
+
+protected:
+    void run();
+    bool isCached(size_t key);
+
+private:
+    struct Frame
+    {
+        size_t key;
+        Cairo::RefPtr<Cairo::ImageSurface> surface;
+    };
+    StarPaint* m_starPaint;
+    SkyScratch m_scratch;                   // used by the thread only
+    const uint32_t m_capacity;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<Glib::DateTime> m_times;    // the plan, next first
+    GeoPosition m_pos;
+    int m_width{};
+    int m_height{};
+    uint32_t m_generation{};                // frames drawn for a older generation are dropped
+    std::deque<Frame> m_frames;             // oldest first
+    bool m_stop{false};
+    uint32_t m_hits{};
+    uint32_t m_misses{};
+    std::thread m_thread;
+};
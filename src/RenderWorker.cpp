@@ -0,0 +1,116 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+
+#include "RenderWorker.hpp"
+#include "Layout.hpp"
+
+RenderWorker::RenderWorker(const PtrStarPaint& starPaint)
+: m_starPaint{starPaint}
+{
+    m_frameDispatcher.connect([this] {
+        m_signalFrame.emit();
+    });
+    m_thread = std::thread(&RenderWorker::run, this);
+}
+
+RenderWorker::~RenderWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_stop = true;
+    }
+    m_requestCondition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void
+RenderWorker::request(const Glib::DateTime& utc, const GeoPosition& pos, int width, int height)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        if (m_pending) {
+            ++m_coalesced;
+        }
+        m_pending = Request{utc, pos, width, height};
+    }
+    m_requestCondition.notify_one();
+}
+
+const Cairo::RefPtr<Cairo::ImageSurface>&
+RenderWorker::getFrame()
+{
+    return m_frames.getFront();
+}
+
+sigc::signal<void()>
+RenderWorker::signal_frame()
+{
+    return m_signalFrame;
+}
+
+uint32_t
+RenderWorker::getCoalesced() const
+{
+    return m_coalesced.load();
+}
+
+void
+RenderWorker::run()
+{
+    while (true) {
+        Request request{};
+        {
+            std::unique_lock<std::mutex> lock(m_requestMutex);
+            m_requestCondition.wait(lock, [this] {
+                return m_stop || m_pending.has_value();
+            });
+            if (m_stop) {
+                break;
+            }
+            request = std::move(m_pending.value());
+            m_pending.reset();
+        }
+        auto& image = m_frames.getBack();
+        if (!image
+         || image->get_width() != request.width
+         || image->get_height() != request.height) {
+            image = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, request.width, request.height);
+        }
+        try {
+            auto paintLock = m_starPaint->lock();
+            Layout layout(request.width, request.height);
+            auto ctx = Cairo::Context::create(image);
+            m_starPaint->drawImage(ctx, request.utc, request.pos, layout);
+        }
+        catch (const std::exception& exc) {
+            std::cout << "RenderWorker::run error " << exc.what() << std::endl;
+            continue;
+        }
+        catch (const Glib::Error& exc) {
+            std::cout << "RenderWorker::run error " << exc.what() << std::endl;
+            continue;
+        }
+        image->flush();
+        m_frames.publish();
+        m_frameDispatcher.emit();
+    }
+}
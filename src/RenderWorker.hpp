@@ -0,0 +1,75 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtkmm.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <optional>
+
+#include "GeoPosition.hpp"
+#include "StarPaint.hpp"
+#include "TripleBuffer.hpp"
+
+/**
+ * draws the images on its own thread, so the main loop stays responsive.
+ *   Requests arriving while a image is drawn are combined,
+ *   only the newest gets drawn.
+ *   The finished images are handed over with a triple buffer.
+ */
+class RenderWorker
+{
+public:
+    RenderWorker(const PtrStarPaint& starPaint);
+    explicit RenderWorker(const RenderWorker& orig) = delete;
+    virtual ~RenderWorker();
+
+    // replaces a request that was not yet started
+    void request(const Glib::DateTime& utc, const GeoPosition& pos, int width, int height);
+    // the newest finished image, may be empty, use from main thread only
+    const Cairo::RefPtr<Cairo::ImageSurface>& getFrame();
+    // emitted on the main thread if a image was finished
+    sigc::signal<void()> signal_frame();
+    // requests that were replaced by a newer one
+    uint32_t getCoalesced() const;
+
+protected:
+    void run();
+
+private:
+    struct Request
+    {
+        Glib::DateTime utc;
+        GeoPosition pos;
+        int width;
+        int height;
+    };
+    PtrStarPaint m_starPaint;
+    std::mutex m_requestMutex;
+    std::condition_variable m_requestCondition;
+    std::optional<Request> m_pending;
+    bool m_stop{false};
+    std::atomic<uint32_t> m_coalesced{0u};
+    TripleBuffer<Cairo::RefPtr<Cairo::ImageSurface>> m_frames;
+    Glib::Dispatcher m_frameDispatcher;
+    sigc::signal<void()> m_signalFrame;
+    std::thread m_thread;                   // last, started with all members ready
+};
@@ -22,6 +22,30 @@
 #include "Renderer.hpp"
 #include "Math.hpp"
 
+void
+Renderer::dots(std::span<const double> x, std::span<const double> y, std::span<const double> r)
+{
+    for (size_t i = 0; i < x.size(); ++i) {
+        dot(x[i], y[i], r[i]);
+    }
+}
+
+void
+Renderer::polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets)
+{
+    for (size_t l = 0; l < offsets.size(); ++l) {
+        const size_t end = l + 1 < offsets.size() ? offsets[l + 1] : x.size();
+        for (size_t i = offsets[l]; i < end; ++i) {
+            if (i == offsets[l]) {
+                moveTo(x[i], y[i]);
+            }
+            else {
+                lineTo(x[i], y[i]);
+            }
+        }
+        stroke();
+    }
+}
 
 CairoGradient::CairoGradient(Cairo::RefPtr<Cairo::Gradient> gradient)
 : RenderGradient()
@@ -75,7 +99,7 @@ CairoText::getLayout()
     return m_layout;
 }
 
-CairoRenderer::CairoRenderer(Cairo::RefPtr<Cairo::Context>& ctx)
+CairoRenderer::CairoRenderer(const Cairo::RefPtr<Cairo::Context>& ctx)
 : m_ctx{ctx}
 {
 
@@ -243,9 +267,28 @@ CairoRenderer::paint()
     m_ctx->paint();
 }
 
+void
+CairoRenderer::setAtlas(const std::shared_ptr<SpriteAtlas>& atlas)
+{
+    m_atlas = atlas;
+}
+
+// blit the disc with the current source
+void
+CairoRenderer::spriteDot(double x, double y, double r)
+{
+    int left, top;
+    auto sprite = m_atlas->getDisc(x, y, r, left, top);
+    m_ctx->mask(sprite, static_cast<double>(left), static_cast<double>(top));
+}
+
 void
 CairoRenderer::dot(double x, double y, double r)
 {
+    if (m_atlas && m_atlas->isCached(r)) {
+        spriteDot(x, y, r);
+        return;
+    }
     circle(x, y, r);
     fill();
 }
@@ -253,6 +296,20 @@ CairoRenderer::dot(double x, double y, double r)
 void
 CairoRenderer::diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop)
 {
+    // the sprite covers fading out a single color (as used for messier)
+    if (m_atlas && m_atlas->isCached(r)
+     && start.getRed() == stop.getRed()
+     && start.getGreen() == stop.getGreen()
+     && start.getBlue() == stop.getBlue()
+     && stop.getAlpha() == 0.0) {
+        int left, top;
+        auto sprite = m_atlas->getDiffuse(x, y, r, left, top);
+        auto source = m_ctx->get_source();
+        m_ctx->set_source_rgba(start.getRed(), start.getGreen(), start.getBlue(), start.getAlpha());
+        m_ctx->mask(sprite, static_cast<double>(left), static_cast<double>(top));
+        m_ctx->set_source(source);
+        return;
+    }
     save();
     translate(x-r, y-r);
     auto gradient = createRadialGradient(r, r, 0.0, r, r, r); // the queue word here is concentric
@@ -265,6 +322,54 @@ CairoRenderer::diffuseDot(double x, double y, double r, RenderColor& start, Rend
     restore();
 }
 
+// one path for all dots, filled once
+void
+CairoRenderer::dots(std::span<const double> x, std::span<const double> y, std::span<const double> r)
+{
+    if (x.empty()) {
+        return;
+    }
+    if (m_atlas) {
+        for (size_t i = 0; i < x.size(); ++i) {
+            if (m_atlas->isCached(r[i])) {
+                spriteDot(x[i], y[i], r[i]);
+            }
+            else {
+                m_ctx->begin_new_sub_path();
+                m_ctx->arc(x[i], y[i], r[i], 0.0, Math::TWO_PI);
+            }
+        }
+        m_ctx->fill();  // the large ones if any
+        return;
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+        m_ctx->begin_new_sub_path();    // no connection from the previous arc
+        m_ctx->arc(x[i], y[i], r[i], 0.0, Math::TWO_PI);
+    }
+    m_ctx->fill();
+}
+
+// one path for all lines, stroked once
+void
+CairoRenderer::polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets)
+{
+    if (x.empty()) {
+        return;
+    }
+    for (size_t l = 0; l < offsets.size(); ++l) {
+        const size_t end = l + 1 < offsets.size() ? offsets[l + 1] : x.size();
+        for (size_t i = offsets[l]; i < end; ++i) {
+            if (i == offsets[l]) {
+                m_ctx->move_to(x[i], y[i]);
+            }
+            else {
+                m_ctx->line_to(x[i], y[i]);
+            }
+        }
+    }
+    m_ctx->stroke();
+}
+
 /**
  * @param radius
  * @param phase 0 right .. 1 center .. 2 left
@@ -19,8 +19,11 @@
 #pragma once
 
 #include <gtkmm.h>
+#include <vector>
+#include <span>
 
 #include "Phase.hpp"
+#include "SpriteAtlas.hpp"
 
 enum class TextAlign
 {
@@ -66,6 +69,87 @@ private:
 };
 
 
+// collects dots of one style to draw them with a single call
+class DotBatch
+{
+public:
+    void clear()
+    {
+        m_x.clear();
+        m_y.clear();
+        m_r.clear();
+    }
+    void add(double x, double y, double r)
+    {
+        m_x.push_back(x);
+        m_y.push_back(y);
+        m_r.push_back(r);
+    }
+    bool empty() const
+    {
+        return m_x.empty();
+    }
+    std::span<const double> getX() const
+    {
+        return m_x;
+    }
+    std::span<const double> getY() const
+    {
+        return m_y;
+    }
+    std::span<const double> getRadius() const
+    {
+        return m_r;
+    }
+private:
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_r;
+};
+
+// collects polylines of one style to draw them with a single call
+class PolylineBatch
+{
+public:
+    void clear()
+    {
+        m_x.clear();
+        m_y.clear();
+        m_offsets.clear();
+    }
+    // the following points belong to a new line
+    void begin()
+    {
+        m_offsets.push_back(static_cast<uint32_t>(m_x.size()));
+    }
+    void add(double x, double y)
+    {
+        m_x.push_back(x);
+        m_y.push_back(y);
+    }
+    bool empty() const
+    {
+        return m_x.empty();
+    }
+    std::span<const double> getX() const
+    {
+        return m_x;
+    }
+    std::span<const double> getY() const
+    {
+        return m_y;
+    }
+    // the first point of each line
+    std::span<const uint32_t> getOffsets() const
+    {
+        return m_offsets;
+    }
+private:
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<uint32_t> m_offsets;
+};
+
 class RenderGradient
 {
 public:
@@ -121,6 +205,11 @@ public:
     virtual void dot(double x, double y, double r) = 0;
     virtual void diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop) = 0;
     virtual void showPhase(Phase phase, double x, double y, double radius) = 0;
+    // batched primitives use the current source and line width,
+    //   the default uses the single calls, override to save the per call overhead
+    virtual void dots(std::span<const double> x, std::span<const double> y, std::span<const double> r);
+    // the offsets give the first point of each line, a line ends with the next offset
+    virtual void polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets);
 
     // https://stackoverflow.com/questions/1734745/how-to-create-circle-with-b%c3%a9zier-curves#27863181
     // for mathematicians this is a approximation for all other people it is a circle segment
@@ -168,7 +257,7 @@ class CairoRenderer
 : public Renderer
 {
 public:
-    CairoRenderer(Cairo::RefPtr<Cairo::Context>& ctx);
+    CairoRenderer(const Cairo::RefPtr<Cairo::Context>& ctx);
     explicit CairoRenderer(const CairoRenderer& orig) = delete;
     virtual ~CairoRenderer() = default;
 
@@ -198,11 +287,17 @@ public:
     void dot(double x, double y, double r) override;
     void diffuseDot(double x, double y, double r, RenderColor& start, RenderColor& stop) override;
     void showPhase(Phase phase, double x, double y, double radius) override;
+    void dots(std::span<const double> x, std::span<const double> y, std::span<const double> r) override;
+    void polylines(std::span<const double> x, std::span<const double> y, std::span<const uint32_t> offsets) override;
+    // if set dots are drawn from the pre-rendered sprites
+    void setAtlas(const std::shared_ptr<SpriteAtlas>& atlas);
 
 protected:
     void halfRight(double radius, double phase);
+    void spriteDot(double x, double y, double r);
 
 private:
     Cairo::RefPtr<Cairo::Context> m_ctx;
+    std::shared_ptr<SpriteAtlas> m_atlas;
 };
 
@@ -0,0 +1,177 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <array>
+
+#include "SkyIndex.hpp"
+#include "HorizonMatrix.hpp"
+#include "RaDec.hpp"
+#include "Math.hpp"
+
+static constexpr uint32_t BAND_COUNT{static_cast<uint32_t>(180.0 / SkyIndex::BAND_DEGREES)};
+
+static uint32_t
+getBand(double dec)
+{
+    auto band = static_cast<int32_t>(std::floor((Math::toDegrees(dec) + 90.0) / SkyIndex::BAND_DEGREES));
+    return static_cast<uint32_t>(std::clamp(band, 0, static_cast<int32_t>(BAND_COUNT) - 1));
+}
+
+// cells of a band, to get roughly the same area
+static uint32_t
+getBandCells(uint32_t band)
+{
+    const double decCenter = Math::toRadians((static_cast<double>(band) + 0.5) * SkyIndex::BAND_DEGREES - 90.0);
+    const double cells = std::round((360.0 / SkyIndex::BAND_DEGREES) * std::cos(decCenter));
+    return std::max(1u, static_cast<uint32_t>(cells));
+}
+
+// first cell of each band and the total at the end
+static const std::array<uint32_t, BAND_COUNT + 1>&
+getBandOffsets()
+{
+    static const std::array<uint32_t, BAND_COUNT + 1> offsets = [] {
+        std::array<uint32_t, BAND_COUNT + 1> offs{};
+        for (uint32_t b = 0; b < BAND_COUNT; ++b) {
+            offs[b + 1] = offs[b] + getBandCells(b);
+        }
+        return offs;
+    }();
+    return offsets;
+}
+
+static void
+toVector(double ra, double dec, double& x, double& y, double& z)
+{
+    const double cosDec = std::cos(dec);
+    x = cosDec * std::cos(ra);
+    y = cosDec * std::sin(ra);
+    z = std::sin(dec);
+}
+
+SkyIndex::SkyIndex()
+{
+    constexpr uint32_t SAMPLES{8u};
+    m_cells.resize(getCellCount());
+    for (uint32_t band = 0; band < BAND_COUNT; ++band) {
+        const uint32_t cells = getBandCells(band);
+        const double dec0 = Math::toRadians(static_cast<double>(band) * BAND_DEGREES - 90.0);
+        const double dec1 = Math::toRadians(static_cast<double>(band + 1) * BAND_DEGREES - 90.0);
+        const double raStep = Math::TWO_PI / static_cast<double>(cells);
+        for (uint32_t c = 0; c < cells; ++c) {
+            auto& cell = m_cells[getBandOffsets()[band] + c];
+            double decCenter = (dec0 + dec1) / 2.0;
+            if (cells == 1u) {      // caps are centered at the pole
+                decCenter = dec0 < 0.0 ? -Math::HALF_PI : Math::HALF_PI;
+            }
+            toVector((static_cast<double>(c) + 0.5) * raStep, decCenter, cell.x, cell.y, cell.z);
+            // sample the boundary for the largest distance
+            double minDot{1.0};
+            for (uint32_t s = 0; s <= SAMPLES; ++s) {
+                const double t = static_cast<double>(s) / static_cast<double>(SAMPLES);
+                const double ra = (static_cast<double>(c) + t) * raStep;
+                const double dec = dec0 + t * (dec1 - dec0);
+                for (auto [bra, bdec] : {std::pair(ra, dec0), std::pair(ra, dec1)
+                                       , std::pair(c * raStep, dec), std::pair((c + 1) * raStep, dec)}) {
+                    double x, y, z;
+                    toVector(bra, bdec, x, y, z);
+                    minDot = std::min(minDot, x * cell.x + y * cell.y + z * cell.z);
+                }
+            }
+            // some extra for the sampling
+            cell.radius = std::acos(std::clamp(minDot, -1.0, 1.0)) * 1.05;
+        }
+    }
+}
+
+uint32_t
+SkyIndex::getCellCount()
+{
+    return getBandOffsets()[BAND_COUNT];
+}
+
+uint32_t
+SkyIndex::getCell(double ra, double dec)
+{
+    const uint32_t band = getBand(dec);
+    const uint32_t cells = getBandCells(band);
+    double raNorm = std::fmod(ra, Math::TWO_PI);
+    if (raNorm < 0.0) {
+        raNorm += Math::TWO_PI;
+    }
+    auto cell = static_cast<uint32_t>(raNorm / Math::TWO_PI * static_cast<double>(cells));
+    return getBandOffsets()[band] + std::min(cell, cells - 1u);
+}
+
+void
+SkyIndex::add(uint32_t item, const UnitVectors& vectors)
+{
+    add(item, vectors, 0u, vectors.size());
+}
+
+void
+SkyIndex::add(uint32_t item, const UnitVectors& vectors, size_t first, size_t count)
+{
+    m_itemCount = std::max(m_itemCount, item + 1u);
+    for (size_t i = first; i < first + count; ++i) {
+        auto raDec = vectors.toRaDec(i);
+        auto& items = m_cells[getCell(raDec.getRaRad(), raDec.getDecRad())].items;
+        if (items.empty() || items.back() != item) {     // points of a item are mostly close
+            items.push_back(item);
+        }
+    }
+}
+
+void
+SkyIndex::clear()
+{
+    for (auto& cell : m_cells) {
+        cell.items.clear();
+    }
+    m_itemCount = 0u;
+}
+
+bool
+SkyIndex::isCellVisible(uint32_t cell, const HorizonMatrix& horizon, double margin) const
+{
+    const auto& c = m_cells[cell];
+    const double reach = c.radius + margin;
+    if (reach >= Math::HALF_PI) {
+        return true;
+    }
+    double x, y, z;
+    horizon.toHorizon(c.x, c.y, c.z, x, y, z);
+    // the center may be below the horizon by reach
+    return z >= -std::sin(reach);
+}
+
+void
+SkyIndex::query(const HorizonMatrix& horizon, double margin, std::vector<uint8_t>& visible) const
+{
+    visible.assign(m_itemCount, 0u);
+    for (uint32_t c = 0; c < m_cells.size(); ++c) {
+        if (!m_cells[c].items.empty()
+         && isCellVisible(c, horizon, margin)) {
+            for (auto item : m_cells[c].items) {
+                visible[item] = 1u;
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+class HorizonMatrix;
+class UnitVectors;
+
+/**
+ * spatial index of the sky, the cells are bands of declination,
+ *   divided by right ascension into parts of roughly the same area.
+ * Items (e.g. polylines) are registered for each cell they touch,
+ *   so a query for the visible hemisphere gives only items
+ *   that may be above the horizon.
+ */
+class SkyIndex
+{
+public:
+    SkyIndex();
+    explicit SkyIndex(const SkyIndex& orig) = delete;
+    virtual ~SkyIndex() = default;
+
+    static constexpr double BAND_DEGREES{10.0};
+
+    static uint32_t getCellCount();
+    // radians
+    static uint32_t getCell(double ra, double dec);
+
+    // register item for the cells of all points
+    void add(uint32_t item, const UnitVectors& vectors);
+    void add(uint32_t item, const UnitVectors& vectors, size_t first, size_t count);
+    void clear();
+    // marks the items that touch a cell within 90° + margin (radians) of the zenith,
+    //   visible is resized to the item count
+    void query(const HorizonMatrix& horizon, double margin, std::vector<uint8_t>& visible) const;
+    bool isCellVisible(uint32_t cell, const HorizonMatrix& horizon, double margin) const;
+
+private:
+    struct Cell
+    {
+        double x;       // center as unit vector
+        double y;
+        double z;
+        double radius;  // angular radius covering the cell
+        std::vector<uint32_t> items;
+    };
+    std::vector<Cell> m_cells;
+    uint32_t m_itemCount{};
+};
@@ -0,0 +1,130 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "SpriteAtlas.hpp"
+#include "Math.hpp"
+
+void
+SpriteAtlas::setSize(int width, int height)
+{
+    if (m_width != width
+     || m_height != height) {
+        m_width = width;
+        m_height = height;
+        m_discs.clear();
+        m_diffuse.clear();
+    }
+}
+
+bool
+SpriteAtlas::isCached(double r) const
+{
+    return r > 0.0 && r <= MAX_RADIUS;
+}
+
+// the sprite center is at this pixel (+ sub-pixel offset)
+int
+SpriteAtlas::getOrigin(double r)
+{
+    return static_cast<int>(std::ceil(r)) + 1;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface>
+SpriteAtlas::getDisc(double x, double y, double r, int& left, int& top)
+{
+    return get(m_discs, false, x, y, r, left, top);
+}
+
+Cairo::RefPtr<Cairo::ImageSurface>
+SpriteAtlas::getDiffuse(double x, double y, double r, int& left, int& top)
+{
+    return get(m_diffuse, true, x, y, r, left, top);
+}
+
+Cairo::RefPtr<Cairo::ImageSurface>
+SpriteAtlas::get(Sprites& sprites, bool diffuse, double x, double y, double r, int& left, int& top)
+{
+    if (sprites.empty()) {
+        sprites.resize(RADIUS_COUNT * SUBPIXEL_STEPS * SUBPIXEL_STEPS);
+    }
+    const auto radiusIdx = std::clamp(static_cast<int>(std::lround(r * RADIUS_STEPS)), 1, RADIUS_COUNT - 1);
+    const auto qr = static_cast<double>(radiusIdx) / static_cast<double>(RADIUS_STEPS);
+    auto ix = static_cast<int>(std::floor(x));
+    auto iy = static_cast<int>(std::floor(y));
+    auto sx = static_cast<int>(std::lround((x - ix) * SUBPIXEL_STEPS));
+    auto sy = static_cast<int>(std::lround((y - iy) * SUBPIXEL_STEPS));
+    if (sx >= SUBPIXEL_STEPS) {
+        sx = 0;
+        ++ix;
+    }
+    if (sy >= SUBPIXEL_STEPS) {
+        sy = 0;
+        ++iy;
+    }
+    auto& sprite = sprites[(radiusIdx * SUBPIXEL_STEPS + sy) * SUBPIXEL_STEPS + sx];
+    if (!sprite) {
+        sprite = render(diffuse, qr
+                      , static_cast<double>(sx) / static_cast<double>(SUBPIXEL_STEPS)
+                      , static_cast<double>(sy) / static_cast<double>(SUBPIXEL_STEPS));
+    }
+    const auto origin = getOrigin(qr);
+    left = ix - origin;
+    top = iy - origin;
+    return sprite;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface>
+SpriteAtlas::render(bool diffuse, double r, double offsX, double offsY)
+{
+    const auto origin = getOrigin(r);
+    const auto size = 2 * origin + 1;
+    auto surface = Cairo::ImageSurface::create(Cairo::Format::FORMAT_A8, size, size);
+    auto ctx = Cairo::Context::create(surface);
+    const auto cx = static_cast<double>(origin) + offsX;
+    const auto cy = static_cast<double>(origin) + offsY;
+    if (diffuse) {
+        auto gradient = Cairo::RadialGradient::create(cx, cy, 0.0, cx, cy, r);
+        gradient->add_color_stop_rgba(0.0, 0.0, 0.0, 0.0, 1.0);
+        gradient->add_color_stop_rgba(1.0, 0.0, 0.0, 0.0, 0.0);
+        ctx->set_source(gradient);
+        ctx->rectangle(cx - r, cy - r, r * 2.0, r * 2.0);
+    }
+    else {
+        ctx->set_source_rgba(0.0, 0.0, 0.0, 1.0);
+        ctx->arc(cx, cy, r, 0.0, Math::TWO_PI);
+    }
+    ctx->fill();
+    surface->flush();
+    return surface;
+}
+
+size_t
+SpriteAtlas::getSpriteCount() const
+{
+    size_t count{};
+    for (auto& sprite : m_discs) {
+        count += sprite ? 1u : 0u;
+    }
+    for (auto& sprite : m_diffuse) {
+        count += sprite ? 1u : 0u;
+    }
+    return count;
+}
@@ -0,0 +1,62 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtkmm.h>
+#include <vector>
+
+/**
+ * pre-rendered anti-aliased discs for the stars and diffuse discs (messier),
+ *   as alpha masks at quantized radii and sub-pixel offsets.
+ *   A sprite is rendered on first use and kept until the size changes,
+ *   so drawing a star is a masked blit instead of rasterizing a path.
+ */
+class SpriteAtlas
+{
+public:
+    SpriteAtlas() = default;
+    explicit SpriteAtlas(const SpriteAtlas& orig) = delete;
+    virtual ~SpriteAtlas() = default;
+
+    static constexpr auto RADIUS_STEPS{4};  // per pixel
+    static constexpr auto SUBPIXEL_STEPS{4};
+    static constexpr auto MAX_RADIUS{32.0}; // pixel, larger are not cached
+
+    // the sprites are dropped if the size changed
+    void setSize(int width, int height);
+    bool isCached(double r) const;
+    // the mask for a disc at x,y, left, top give the position to blit
+    Cairo::RefPtr<Cairo::ImageSurface> getDisc(double x, double y, double r, int& left, int& top);
+    // the mask for a disc fading from alpha 1 at the center to 0 at r
+    Cairo::RefPtr<Cairo::ImageSurface> getDiffuse(double x, double y, double r, int& left, int& top);
+    size_t getSpriteCount() const;
+
+protected:
+    using Sprites = std::vector<Cairo::RefPtr<Cairo::ImageSurface>>;
+    Cairo::RefPtr<Cairo::ImageSurface> get(Sprites& sprites, bool diffuse, double x, double y, double r, int& left, int& top);
+    static Cairo::RefPtr<Cairo::ImageSurface> render(bool diffuse, double r, double offsX, double offsY);
+    static int getOrigin(double r);
+
+private:
+    static constexpr auto RADIUS_COUNT{static_cast<int>(MAX_RADIUS) * RADIUS_STEPS + 1};
+    Sprites m_discs;
+    Sprites m_diffuse;
+    int m_width{};
+    int m_height{};
+};
@@ -34,6 +34,10 @@ StarDraw::StarDraw(BaseObjectType* cobject
 , m_starWin{starWin}
 {
     m_starPaint = m_starWin->getStarPaint();
+    m_renderWorker = std::make_shared<RenderWorker>(m_starPaint);
+    m_renderWorker->signal_frame().connect([this] {
+        queue_draw();
+    });
 	add_events(Gdk::EventMask::BUTTON_PRESS_MASK);
 }
 
@@ -57,30 +61,22 @@ StarDraw::update(Glib::DateTime now, GeoPosition& pos)
               << std::endl;
 #   endif
     m_displayTimeUtc = now;
-    int width = get_allocated_width();
-    int height = get_allocated_height();
-    if (!m_image
-      || m_image->get_width() != width
-      || m_image->get_height() != height) {
-        m_image = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, width, height);
-    }
-    Layout layout(width, height);
-    auto ctx = Cairo::Context::create(m_image);
-    m_starPaint->drawImage(ctx, now, pos, layout);
-    //std::cout << "draw " << w << " h " << h << "\n";
-    queue_draw();
+    m_requestedWidth = get_allocated_width();
+    m_requestedHeight = get_allocated_height();
+    // drawn on the worker, queue_draw follows when finished
+    m_renderWorker->request(now, pos, m_requestedWidth, m_requestedHeight);
 }
 
 bool
 StarDraw::on_draw(const Cairo::RefPtr<Cairo::Context>& ctx)
 {
-    if (!m_image
-      || m_image->get_width() != get_allocated_width()
-      || m_image->get_height() != get_allocated_height()) {
-        update();
+    if (m_requestedWidth != get_allocated_width()
+     || m_requestedHeight != get_allocated_height()) {
+        update();   // show the previous image until the resized is ready
     }
-    if (m_image) {
-        ctx->set_source(m_image, 0, 0);
+    auto& image = m_renderWorker->getFrame();
+    if (image) {
+        ctx->set_source(image, 0, 0);
         ctx->paint();
     }
     return true;
@@ -24,6 +24,7 @@
 #include "GeoPosition.hpp"
 #include "JulianDate.hpp"
 #include "StarPaint.hpp"
+#include "RenderWorker.hpp"
 
 class StarWin;
 class StarMountOp;
@@ -50,7 +51,9 @@ protected:
     Gtk::Menu *build_popup();
 
 private:
-    Cairo::RefPtr<Cairo::ImageSurface> m_image;
+    std::shared_ptr<RenderWorker> m_renderWorker;
+    int m_requestedWidth{};
+    int m_requestedHeight{};
     Glib::DateTime m_displayTimeUtc;
     StarWin* m_starWin;
     PtrStarPaint m_starPaint;
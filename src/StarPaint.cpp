@@ -16,6 +16,11 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <charconv>
 
 #include "HipparcosFormat.hpp"
 #include "ConstellationFormat.hpp"
@@ -33,6 +38,13 @@
 #include "CalendarModule.hpp"
 #include "StarWin.hpp"
 #include "Renderer.hpp"
+#include "PixelRenderer.hpp"
+#include "RecordingRenderer.hpp"
+#include "RenderAhead.hpp"
+#include "ModuleWorker.hpp"
+#include "HorizonMatrix.hpp"
+#include "StarTiles.hpp"
+#include "CatalogFile.hpp"
 
 #include "StarPaint.hpp"
 
@@ -45,58 +57,115 @@ StarPaint::StarPaint(StarWin* starWin)
     m_constlFormat = std::make_shared<ConstellationFormat>(m_fileLoader);
     m_milkyway = std::make_shared<Milkyway>(m_fileLoader);
     m_messier =  std::make_shared<MessierLoader>(m_fileLoader);
+    m_planets = std::make_shared<Planets>();
+    m_planets->getOtherPlanets();   // created before the drawing may use them on other threads
     m_modules = createModules();
+    m_loadedDispatcher.connect(sigc::mem_fun(*this, &StarPaint::on_loaded));
+    m_loader = std::thread(&StarPaint::loadCatalogs, this);
+    if (m_starWin->isDaemon()
+     && getRenderAheadFrames() > 0u) {
+        m_renderAhead = std::make_shared<RenderAhead>(this, getRenderAheadFrames());
+    }
+    if (getModuleBudget() > 0u) {
+        m_moduleWorker = std::make_shared<ModuleWorker>();
+        m_moduleWorker->signal_late().connect([this] {
+            m_signalModuleLate.emit();
+        });
+    }
 }
 
+StarPaint::~StarPaint()
+{
+    m_renderAhead.reset();      // stop drawing before anything gets released
+    m_moduleWorker.reset();
+    if (m_loader.joinable()) {
+        m_loader.join();
+    }
+}
 
-// as messier objects appear in some places close together, show names concatenated
-std::vector<NamedPoint>
-StarPaint::cluster(const std::vector<NamedPoint>& points, double distance)
+// the loaders are only accessed from the main thread after their bit was set
+void
+StarPaint::loadCatalogs()
 {
-    std::vector<NamedPoint> ret;
-    ret.reserve(points.size());
-    for (auto& p : points) {
-        bool found{false};
-        for (auto& r : ret) {
-            auto dist = p.getPoint().dist(r.getPoint());
-            if (dist < distance) {
-                r.add(p);
-                found = true;
-                break;
-            }
+    auto load = [this] (Catalog catalog, const char* name, const std::function<void()>& fun) {
+#       ifdef DEBUG
+        auto start = std::chrono::steady_clock::now();
+#       endif
+        try {
+            fun();
+        }
+        catch (const std::exception& exc) {
+            std::cout << "Error loading " << name << " " << exc.what() << std::endl;
         }
-        if (!found) {
-            ret.push_back(p);
+        catch (const Glib::Error& exc) {
+            std::cout << "Error loading " << name << " " << exc.what() << std::endl;
+        }
+#       ifdef DEBUG
+        auto end = std::chrono::steady_clock::now();
+        std::cout << "Loaded " << name << " "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+#       endif
+        m_loaded.fetch_or(static_cast<uint32_t>(catalog), std::memory_order_release);
+        m_loadedDispatcher.emit();
+    };
+    // what makes the most difference first
+    load(Catalog::Stars, "stars", [this] {
+        m_starFormat->getUnitVectors();
+    });
+    load(Catalog::Constellations, "constellations", [this] {
+        m_constlFormat->getConstellations();
+    });
+    load(Catalog::Milkyway, "milkyway", [this] {
+        m_milkyway->getStore();
+    });
+    load(Catalog::Messier, "messier", [this] {
+        m_messier->getMessiers();
+    });
+}
+
+bool
+StarPaint::isLoaded(Catalog catalog) const
+{
+    return (m_loaded.load(std::memory_order_acquire) & static_cast<uint32_t>(catalog)) != 0u;
+}
+
+sigc::signal<void(StarPaint::Catalog)>
+StarPaint::signal_loaded()
+{
+    return m_signalLoaded;
+}
+
+sigc::signal<void()>
+StarPaint::signal_moduleLate()
+{
+    return m_signalModuleLate;
+}
+
+// the dispatcher may coalesce emits, so check what is new
+void
+StarPaint::on_loaded()
+{
+    const uint32_t loaded = m_loaded.load(std::memory_order_acquire);
+    for (auto catalog : {Catalog::Stars, Catalog::Constellations, Catalog::Milkyway, Catalog::Messier}) {
+        const auto bit = static_cast<uint32_t>(catalog);
+        if ((loaded & bit) != 0u
+         && (m_loadedSignaled & bit) == 0u) {
+            m_loadedSignaled |= bit;
+            m_signalLoaded.emit(catalog);
         }
     }
-    return ret;
 }
 
+
 void
-StarPaint::draw_messier(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout)
+StarPaint::draw_messier(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch)
 {
     renderer->save();
-    auto starDesc = getStarFont();
+    auto starDesc = scratch.style.starFont;
     auto text = renderer->createText(starDesc);
     //double width, height;
     auto messiers = m_messier->getMessiers();
-    const auto messierVMagMin = getMessierVMagMin();
-    std::vector<NamedPoint> points;
-    points.reserve(128);
-	for (auto& messier : messiers) {
-#       ifdef DEBUG
-        std::cout << "StarPaint::draw_messier " << messier->getIdent() << std::endl;
-#       endif
-        if (messier->getVmagnitude() < messierVMagMin) {
-            auto raDec = messier->getRaDec();
-            auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-            if (azAlt->isVisible()) {
-                auto p = azAlt->toScreen(layout);
-                MagPoint magP(p, messier->getVmagnitude());
-                points.emplace_back(std::move(NamedPoint(magP, messier->getName())));
-            }
-        }
-	}
+    const auto messierVMagMin = scratch.style.messierVMagMin;
     const auto messierRadius{layout.getMin() / MESSIER_FACTOR};
     const auto clusterRadius{layout.getMin() / CLUSTER_FACTOR};
 #   ifdef DEBUG
@@ -105,49 +174,74 @@ StarPaint::draw_messier(Renderer* renderer, const JulianDate& jd, GeoPosition& g
               << " height " <<  layout.getHeight()
               << " dist " <<  clusterRadius << std::endl;
 #   endif
-    auto clusters = cluster(points, clusterRadius);
-#   ifdef DEBUG
-    std::cout << "StarPaint::draw_messier clusters " << clusters.size() << std::endl;
-#   endif
-    for (auto& cluster : clusters) {
+    auto& clusters = scratch.messierClusters;
+    clusters.clear();
+	for (auto& messier : messiers) {
+#       ifdef DEBUG
+        std::cout << "StarPaint::draw_messier " << messier->getIdent() << std::endl;
+#       endif
+        if (messier->getVmagnitude() < messierVMagMin) {
+            auto azAlt = geoPos.toAzimutAltitude(*messier->getRaDec(), jd);
+            if (azAlt.isVisible()) {
+                auto p = azAlt.toScreen(layout);
+                clusters.add(MagPoint(p, messier->getVmagnitude()), messier->getName(), clusterRadius);
+            }
+        }
+	}
+    for (uint32_t first = 0; first < clusters.size(); ++first) {
+        if (!clusters.isFirst(first)) {
+            continue;
+        }
         double xMax(-layout.getWidth()),yMax(-layout.getHeight());
-        for (auto& point : cluster.getMagPoints()) {
-            auto brightness = Math::mix(TEXT_GRAY_EMPHASIS, TEXT_GRAY_LOW, (point.getVmagnitude() - 4.0) / 3.0);
+        for (uint32_t point = first; point < clusters.size(); ++point) {
+            if (clusters.getCluster(point) != first) {
+                continue;
+            }
+            auto& magP = clusters.getPoint(point);
+            auto brightness = Math::mix(TEXT_GRAY_EMPHASIS, TEXT_GRAY_LOW, (magP.getVmagnitude() - 4.0) / 3.0);
             RenderColor start(brightness, brightness, brightness, 1.0);
             RenderColor stop(brightness, brightness, brightness, 0.0);
-            renderer->diffuseDot(point.getX(), point.getY(), messierRadius, start, stop);
-            xMax = std::max(xMax, point.getX() + messierRadius);
-            yMax = std::max(yMax, point.getY());
+            renderer->diffuseDot(magP.getX(), magP.getY(), messierRadius, start, stop);
+            xMax = std::max(xMax, magP.getX() + messierRadius);
+            yMax = std::max(yMax, magP.getY());
         }
         RenderColor textColor(TEXT_GRAY_MID, TEXT_GRAY_MID, TEXT_GRAY_MID);
         renderer->setSource(textColor);
-        text->setText(cluster.getName());
+        text->setText(clusters.getName(first));
         renderer->showText(text, xMax, yMax, TextAlign::LeftTop);
     }
     renderer->restore();
 }
 
 void
-StarPaint::draw_planets(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout)
+StarPaint::draw_planets(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch)
 {
-    auto starDesc = getStarFont();
+    auto starDesc = scratch.style.starFont;
     auto text = renderer->createText(starDesc);
-    Planets planets;
     const auto planetRadius{layout.getMin() / PLANET_FACTOR};
     RenderColor grayEmph(TEXT_GRAY_EMPHASIS, TEXT_GRAY_EMPHASIS, TEXT_GRAY_EMPHASIS);
     RenderColor grayText(TEXT_GRAY_MID, TEXT_GRAY_MID, TEXT_GRAY_MID);
-	for (auto& planet : planets.getOtherPlanets()) {
+	for (auto& planet : m_planets->getOtherPlanets()) {
 #       ifdef DEBUG
         std::cout << "StarPaint::draw_planets " << planet->getName() << std::endl;
 #       endif
-	    auto raDec = planet->getRaDecPositon(jd);
+	    auto raDec = planet->raDec(jd);
 	    auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-	    if (azAlt->isVisible()) {
-            auto p = azAlt->toScreen(layout);
+	    if (azAlt.isVisible()) {
+            auto p = azAlt.toScreen(layout);
             renderer->setSource(grayEmph);
             renderer->dot(p.getX(), p.getY(), planetRadius);
             renderer->setSource(grayText);
-            text->setText(Glib::ustring::sprintf("%s %.1fAU", planet->getName(), raDec->getDistanceAU()));
+            // as "%s %.1fAU" but reusing the label
+            auto& label = scratch.label;
+            label = planet->getName();
+            std::array<char, 32> distance;
+            auto end = std::to_chars(distance.data(), distance.data() + distance.size()
+                                    , raDec.getDistanceAU(), std::chars_format::fixed, 1).ptr;
+            label += ' ';
+            label.append(distance.data(), static_cast<size_t>(end - distance.data()));
+            label += "AU";
+            text->setText(label);
             renderer->showText(text, p.getX() + planetRadius, p.getY(), TextAlign::LeftTop);
 	    }
 	}
@@ -156,12 +250,12 @@ StarPaint::draw_planets(Renderer* renderer, const JulianDate& jd, GeoPosition& g
 void
 StarPaint::draw_sun(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout)
 {
-    auto raDec = Sun::position(jd);
-    //std::cout << "Sun ra " << raDec->getRaDegrees() << " dec " << raDec->getDecDegrees() << std::endl;
+    auto raDec = Sun::raDec(jd);
+    //std::cout << "Sun ra " << raDec.getRaDegrees() << " dec " << raDec.getDecDegrees() << std::endl;
     auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-    //std::cout << "Sun az " << azAlt->getAzimutDegrees() << " az " << azAlt->getAltitudeDegrees() << std::endl;
-    if (azAlt->isVisible()) {
-        auto p = azAlt->toScreen(layout);
+    //std::cout << "Sun az " << azAlt.getAzimutDegrees() << " az " << azAlt.getAltitudeDegrees() << std::endl;
+    if (azAlt.isVisible()) {
+        auto p = azAlt.toScreen(layout);
         RenderColor sunColor(TEXT_GRAY_EMPHASIS, TEXT_GRAY_EMPHASIS, TEXT_GRAY_LOW);
         renderer->setTrueSource(sunColor);
         renderer->dot(p.getX(), p.getY(), getSunMoonRadius(layout));
@@ -171,78 +265,68 @@ StarPaint::draw_sun(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPo
 void
 StarPaint::draw_moon(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout)
 {
-    auto raDec = Moon::position(jd);
+    auto raDec = Moon::raDec(jd);
     auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-    if (azAlt->isVisible()) {
+    if (azAlt.isVisible()) {
         Moon moon;
-        auto p = azAlt->toScreen(layout);
+        auto p = azAlt.toScreen(layout);
         renderer->showPhase(moon.getPhase(jd), p.getX(), p.getY(), getSunMoonRadius(layout));
     }
 }
 
 
 void
-StarPaint::draw_milkyway(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout)
+StarPaint::draw_milkyway(Renderer* renderer, const HorizonMatrix& horizon, const Layout& layout, SkyScratch& scratch)
 {
     double lineWidth = getLineWidth(layout);
     renderer->setLineWidth(lineWidth);
-    for (auto poly : m_milkyway->getBounds()) {
-        //renderer->beginNewPath(); this is important if we decide to only partly draw the shapes
-        std::list<std::shared_ptr<AzimutAltitude>> azAlts;  // saving intermediate saves us recalculation
+    const auto& store = m_milkyway->getStore();
+    const auto& vertices = store.getVertices();
+    m_milkyway->getIndex().query(horizon, Math::toRadians(scratch.style.horizonMargin), scratch.visibleItems);
+    for (auto& entry : scratch.lineBatches) {
+        entry.second.clear();
+    }
+    for (uint32_t item = 0; item < store.size(); ++item) {
+        if (!scratch.visibleItems[item]) {
+            continue;
+        }
+        const auto& line = store.getLine(item);
+        toScreen(horizon, vertices, line.first, line.count, layout, scratch);
         bool anyVisible = false;
-        for (auto raDec : poly->getPoints()) {
-            auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-            azAlts.push_back(azAlt);
-            anyVisible |= azAlt->isVisible();
+        for (size_t i = 0; i < line.count; ++i) {
+            anyVisible |= scratch.screenZ[i] >= 0.0;
         }
-        uint32_t skipped{};
         if (anyVisible) {       // do not draw if outside
-            int intens = poly->getIntensity();
-            double dintens = 0.1 + (double)intens / 20.0;
-            RenderColor milkyColor(dintens, dintens, 0.25 + dintens);
-            renderer->setTrueSource(milkyColor);
-            bool move = true;
-            //std::cout << "Starting poly" << std::endl;
-            for (auto azAlt : azAlts) {
-                //if (azAlt->isVisible()) { // stop drawing beyond horizont, with some additional to allow closing
-                    auto p = azAlt->toScreen(layout);
-                    if (move) {
-                        //std::cout << "  move " << p.getX() << " y " << p.getY() << std::endl;
-                        renderer->moveTo(p.getX(), p.getY());
-                        move = false;
-                    }
-                    else {
-                        //std::cout << "  line " << p.getX() << " y " << p.getY() << std::endl;
-                        renderer->lineTo(p.getX(), p.getY());
-                    }
-                //}
-                //else {
-                //    move = true;
-                //    ++skipped;
-                //}
+            // the intensity is the style, so collect the lines for each
+            auto& batch = scratch.lineBatches[line.value];
+            batch.begin();
+            for (size_t i = 0; i < line.count; ++i) {
+                // drawing beyond horizont is required to allow closing
+                batch.add(scratch.screenX[i], scratch.screenY[i]);
             }
         }
-        else {
-            skipped = static_cast<uint32_t>(azAlts.size());
-        }
-        //if (skipped > 0) {
-        //    std::cout << __FILE__ << "::draw_milkyway"
-        //              << " intens " << intens
-        //              << " skipped " << skipped << "/" << azAlts.size() << std::endl;
-        //}
         // the given data wraps nicely onto a sphere,
         //   but here we have a disc view (world),
         //    so we stick to some abstraction
         //ctx->close_path();
         //ctx->fill();
-        renderer->stroke();
     }
-    auto raDec = m_milkyway->getGalacticCenter();
-    auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-    if (azAlt->isVisible()) {
+    for (auto& entry : scratch.lineBatches) {
+        if (!entry.second.empty()) {
+            int intens = entry.first;
+            double dintens = 0.1 + (double)intens / 20.0;
+            RenderColor milkyColor(dintens, dintens, 0.25 + dintens);
+            renderer->setTrueSource(milkyColor);
+            renderer->polylines(entry.second.getX(), entry.second.getY(), entry.second.getOffsets());
+        }
+    }
+    auto raDec = Milkyway::galacticCenter();
+    double x, y, z;
+    horizon.toScreen(raDec, layout, x, y, z);
+    if (z >= 0.0) {
         RenderColor centColor(TEXT_GRAY, TEXT_GRAY, TEXT_GRAY);
         renderer->setSource(centColor);
-        auto p = azAlt->toScreen(layout);
+        Point2D p(x, y);
         auto w = static_cast<double>(layout.getMin()) / (SUNMOON_FACTOR / 2.0);
         renderer->setLineWidth(getLineWidth(layout));
         renderer->moveTo(p.getX()-w,p.getY());
@@ -250,7 +334,7 @@ StarPaint::draw_milkyway(Renderer* renderer, const JulianDate& jd, GeoPosition&
         renderer->moveTo(p.getX(),p.getY()-w);
         renderer->lineTo(p.getX(),p.getY()+w);
         renderer->stroke();
-        auto starDesc = getStarFont();
+        auto starDesc = scratch.style.starFont;
         auto text = renderer->createText(starDesc);
         text->setText("Gal.cent.");
         renderer->showText(text, p.getX()+w, p.getY(), TextAlign::LeftTop);
@@ -258,22 +342,87 @@ StarPaint::draw_milkyway(Renderer* renderer, const JulianDate& jd, GeoPosition&
 }
 
 void
-StarPaint::draw_stars(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout)
+StarPaint::toScreen(const HorizonMatrix& horizon, const UnitVectors& vectors, const Layout& layout, SkyScratch& scratch)
+{
+    toScreen(horizon, vectors, 0u, vectors.size(), layout, scratch);
+}
+
+void
+StarPaint::toScreen(const HorizonMatrix& horizon, const UnitVectors& vectors, size_t first, size_t count, const Layout& layout, SkyScratch& scratch)
+{
+    if (scratch.screenX.size() < count) {
+        scratch.screenX.resize(count);
+        scratch.screenY.resize(count);
+        scratch.screenZ.resize(count);
+    }
+    horizon.toScreen(vectors, first, count, layout, scratch.screenX, scratch.screenY, scratch.screenZ);
+}
+
+// up to FAINT_STAR_VMAG (this includes all of the bundled stars) the radius is unchanged,
+//   only the fainter stars of a larger catalog use the flux
+double
+StarPaint::getStarRadius(double vmag, const Layout& layout)
+{
+    auto minStarRadius = static_cast<double>(layout.getMin()) / MIN_STAR_FACTOR;
+    if (vmag <= FAINT_STAR_VMAG) {
+        auto maxStarRadius = static_cast<double>(layout.getMin()) / MAX_STAR_FACTOR;
+        return Math::mix(maxStarRadius, minStarRadius, ((vmag - 3.0) / 2.0));
+    }
+    // fainter stars shrink with the flux, the area is proportional to 10^(-0.4 mag)
+    return minStarRadius * std::pow(10.0, -0.2 * (vmag - FAINT_STAR_VMAG));
+}
+
+// the magnitude where getStarRadius gets below MIN_VISIBLE_STAR_RADIUS
+double
+StarPaint::getLimitingMagnitude(const Layout& layout)
+{
+    auto minStarRadius = static_cast<double>(layout.getMin()) / MIN_STAR_FACTOR;
+    return FAINT_STAR_VMAG + 5.0 * std::log10(minStarRadius / MIN_VISIBLE_STAR_RADIUS);
+}
+
+// only tiles above the horizon and brighter than the limit are projected
+void
+StarPaint::draw_stars(Renderer* renderer, const HorizonMatrix& horizon, const Layout& layout, SkyScratch& scratch)
 {
     RenderColor starColor(TEXT_GRAY_EMPHASIS, TEXT_GRAY_EMPHASIS, TEXT_GRAY_EMPHASIS);
     renderer->setSource(starColor);
-    auto minStarRadius = static_cast<double>(layout.getMin()) / MIN_STAR_FACTOR;
-    auto maxStarRadius = static_cast<double>(layout.getMin()) / MAX_STAR_FACTOR;
-    for (auto s : m_starFormat->getStars()) {
-        auto raDec = s->getRaDec();
-        auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-        if (azAlt->isVisible()) {
-            auto p = azAlt->toScreen(layout);
-            auto rs = Math::mix(maxStarRadius, minStarRadius, ((s->getVmagnitude() - 3.0) / 2.0));
-            //std::cout << "x " << p.getX() << " y " << p.getY() << " rs " << rs << "\n";
-            renderer->dot(p.getX(), p.getY(), rs);
+    const auto limitVmag = getLimitingMagnitude(layout);
+    const auto limit = CatalogFile::quantizeMagnitude(limitVmag);
+    // the radius is interpolated from a table, as pow for each star gets costly with large catalogs
+    auto& starRadius = scratch.starRadius;
+    const auto steps = static_cast<size_t>(std::ceil((std::max(limitVmag, 0.0) - STAR_RADIUS_VMAG_MIN) / STAR_RADIUS_STEP)) + 2u;
+    starRadius.resize(steps);
+    for (size_t step = 0; step < steps; ++step) {
+        starRadius[step] = getStarRadius(STAR_RADIUS_VMAG_MIN + static_cast<double>(step) * STAR_RADIUS_STEP, layout);
+    }
+    const auto& vectors = m_starFormat->getUnitVectors();
+    const auto vmag = m_starFormat->getVmagnitude();
+    scratch.starBatch.clear();
+    for (auto& tile : m_starFormat->getTiles()) {
+        if (tile.minVmag > limit
+         || !StarTiles::isVisible(tile, horizon)) {
+            continue;
+        }
+        // as the tile is sorted by magnitude we may stop at the limit
+        auto end = std::upper_bound(vmag.begin() + tile.first, vmag.begin() + tile.first + tile.count, limit);
+        const size_t count = static_cast<size_t>(end - (vmag.begin() + tile.first));
+        toScreen(horizon, vectors, tile.first, count, layout, scratch);
+        for (size_t i = 0; i < count; ++i) {
+            if (scratch.screenZ[i] >= 0.0) {     // above horizon
+                auto pos = std::max((CatalogFile::toMagnitude(vmag[tile.first + i]) - STAR_RADIUS_VMAG_MIN) / STAR_RADIUS_STEP, 0.0);
+                auto step = std::min(static_cast<size_t>(pos), steps - 2u);
+                auto rs = Math::mix(starRadius[step], starRadius[step + 1u], pos - static_cast<double>(step));
+                //std::cout << "x " << scratch.screenX[i] << " y " << scratch.screenY[i] << " rs " << rs << "\n";
+                scratch.starBatch.add(scratch.screenX[i], scratch.screenY[i], rs);
+            }
         }
     }
+    renderer->dots(scratch.starBatch.getX(), scratch.starBatch.getY(), scratch.starBatch.getRadius());
+#   ifdef DEBUG
+    std::cout << "StarPaint::draw_stars limit " << limitVmag
+              << " tiles " << m_starFormat->getTiles().size()
+              << " stars " << vectors.size() << std::endl;
+#   endif
 }
 
 double
@@ -297,75 +446,96 @@ StarPaint::getSunMoonRadius(const Layout& layout)
 }
 
 void
-StarPaint::draw_constl(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout)
+StarPaint::draw_constl(Renderer* renderer, const HorizonMatrix& horizon, const Layout& layout, SkyScratch& scratch)
 {
-    auto starDesc = getStarFont();
+    auto starDesc = scratch.style.starFont;
     auto text = renderer->createText(starDesc);
     //double width, height;
     //text->setText("M");
     //text->getSize(width, height);
     auto lineWidth = getLineWidth(layout);
-    for (auto c : m_constlFormat->getConstellations()) {
-        Point2D sum;
-        bool anyVisible = false;
-        auto polylines = c->getPolylines();
-#       ifdef DEBUG
-        std::cout << "Constl " << c->getName() << std::endl;
-#       endif
-        uint32_t count{};
-        for (auto l : polylines) {
-            int prio = l->getWidth();
-            auto gray = Math::mix(TEXT_GRAY_EMPHASIS, TEXT_GRAY_LOW, (prio - 1) / 3.0);
-            RenderColor grayColor(gray, gray, gray);
-            renderer->setSource(grayColor);
-            renderer->setLineWidth((prio <= 1) ? lineWidth * 1.5 : lineWidth);
+    auto constellations = m_constlFormat->getConstellations();
+    const auto& store = m_constlFormat->getStore();
+    const auto& vertices = store.getVertices();
+    m_constlFormat->getIndex().query(horizon, Math::toRadians(scratch.style.horizonMargin), scratch.visibleItems);
+    for (auto& entry : scratch.lineBatches) {
+        entry.second.clear();
+    }
+    scratch.labels.clear();
+    Point2D sum;
+    uint32_t count{};
+    for (uint32_t item = 0; item < store.size(); ++item) {
+        const auto& line = store.getLine(item);
+        if (scratch.visibleItems[item]) {
+            toScreen(horizon, vertices, line.first, line.count, layout, scratch);
             bool visible = false;
-            for (auto raDec : l->getPoints()) {
-                auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-                if (azAlt->isVisible()) {
+            for (size_t i = 0; i < line.count; ++i) {
+                if (scratch.screenZ[i] >= 0.0) {
                     visible = true;
                 }
             }
             if (visible) {
-                anyVisible = true;
-                bool first{true};
-                for (auto raDec : l->getPoints()) {
-                    auto azAlt = geoPos.toAzimutAltitude(raDec, jd);
-                    auto p = azAlt->toScreen(layout);
+                // the priority is the style, so collect the lines for each
+                auto& batch = scratch.lineBatches[line.value];
+                batch.begin();
+                for (size_t i = 0; i < line.count; ++i) {
+                    Point2D p(scratch.screenX[i], scratch.screenY[i]);
                     sum.add(p);
                     ++count;
-                    if (first) {
-                        renderer->moveTo(p.getX(), p.getY());
-                        first = false;
-                    }
-                    else {
-                        renderer->lineTo(p.getX(), p.getY());
-                    }
+                    batch.add(p.getX(), p.getY());
                 }
-                renderer->stroke();
             }
         }
-        if (anyVisible) {
-            RenderColor gray(TEXT_GRAY, TEXT_GRAY, TEXT_GRAY);
-            renderer->setSource(gray);
-            double avgX = sum.getX() / (double)count;
-            double avgY = sum.getY() / (double)count;
-            text->setText(c->getName());
-            renderer->showText(text, avgX, avgY, TextAlign::LeftTop);
+        // the lines of a constellation are adjacent, name it after the last
+        const bool lastOfGroup = item + 1u >= store.size()
+                              || store.getLine(item + 1u).group != line.group;
+        if (lastOfGroup && count > 0u) {
+            scratch.labels.emplace_back(line.group, Point2D(sum.getX() / (double)count, sum.getY() / (double)count));
+        }
+        if (lastOfGroup) {
+            sum = Point2D();
+            count = 0u;
         }
     }
+    for (auto& entry : scratch.lineBatches) {
+        if (!entry.second.empty()) {
+            int prio = entry.first;
+            auto gray = Math::mix(TEXT_GRAY_EMPHASIS, TEXT_GRAY_LOW, (prio - 1) / 3.0);
+            RenderColor grayColor(gray, gray, gray);
+            renderer->setSource(grayColor);
+            renderer->setLineWidth((prio <= 1) ? lineWidth * 1.5 : lineWidth);
+            renderer->polylines(entry.second.getX(), entry.second.getY(), entry.second.getOffsets());
+        }
+    }
+    // the names are shown above the lines
+    RenderColor gray(TEXT_GRAY, TEXT_GRAY, TEXT_GRAY);
+    renderer->setSource(gray);
+    for (auto& label : scratch.labels) {
+        auto& c = constellations[label.first];
+#       ifdef DEBUG
+        std::cout << "Constl " << c->getName() << std::endl;
+#       endif
+        text->setText(c->getName());
+        renderer->showText(text, label.second.getX(), label.second.getY(), TextAlign::LeftTop);
+    }
 }
 
 void
 StarPaint::drawSky(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout)
 {
+    getSkyStyle(m_scratch.style);
+    drawSky(renderer, jd, geoPos, layout, m_scratch);
+}
+
+void
+StarPaint::drawSky(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch)
+{
+    auto& style = scratch.style;
     renderer->save();
     const double r = layout.getMin() / 2.0;
     auto grad = renderer->createRadialGradient((layout.getWidth()/2), (layout.getHeight()/2), r / 3.0, (layout.getWidth()/2), (layout.getHeight()/2), r);
-    auto startColor = getStartColor();
-    auto stopColor = getStopColor();
-    grad->addColorStop(0.0, startColor);
-    grad->addColorStop(1.0, stopColor);
+    grad->addColorStop(0.0, style.startColor);
+    grad->addColorStop(1.0, style.stopColor);
     renderer->setSource(grad);
     renderer->rectangle(layout.getXOffs(), layout.getYOffs(), layout.getWidth(), layout.getHeight());
     renderer->fill();
@@ -373,19 +543,28 @@ StarPaint::drawSky(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos
                       , (layout.getYOffs() + layout.getHeight()/2));
     renderer->circle(0.0, 0.0, r);
     renderer->clip();    // as we draw some lines beyond the horizon
-    if (isShowMilkyway()) {
-        draw_milkyway(renderer, jd, geoPos, layout);
+    HorizonMatrix horizon(geoPos, jd);
+    // draw what is available, there will be a update when loading completes
+    if (style.showMilkyway
+     && isLoaded(Catalog::Milkyway)) {
+        draw_milkyway(renderer, horizon, layout, scratch);
+    }
+    if (isLoaded(Catalog::Constellations)) {
+        draw_constl(renderer, horizon, layout, scratch);
+    }
+    if (isLoaded(Catalog::Stars)) {
+        draw_stars(renderer, horizon, layout, scratch);
     }
-    draw_constl(renderer, jd, geoPos, layout);
-    draw_stars(renderer, jd, geoPos, layout);
     draw_moon(renderer, jd, geoPos, layout);
     draw_sun(renderer, jd, geoPos, layout);
-    draw_planets(renderer, jd, geoPos, layout);
-    draw_messier(renderer, jd, geoPos, layout);
+    draw_planets(renderer, jd, geoPos, layout, scratch);
+    if (isLoaded(Catalog::Messier)) {
+        draw_messier(renderer, jd, geoPos, layout, scratch);
+    }
 
     RenderColor gray(TEXT_GRAY, TEXT_GRAY, TEXT_GRAY);
     renderer->setSource(gray);
-    auto starFont = getStarFont();
+    auto starFont = style.starFont;
     scale(starFont, 1.75);
     auto text = renderer->createText(starFont);
     //double width, height;
@@ -417,56 +596,152 @@ StarPaint::findModules(const char* pos)
     return mods;
 }
 
-void
-StarPaint::drawTop(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules)
+// each module is measured once for a image,
+//   a module busy on the worker keeps the height it had
+int
+StarPaint::measureModules(const Cairo::RefPtr<Cairo::Context>& ctx, const std::vector<PtrModule>& modules, std::vector<int>& heights)
 {
-    Point2D pos(40.0, 20.0);
+    int sumHeight{};
+    heights.clear();
+    heights.reserve(modules.size());
     for (auto& mod : modules) {
-        ctx->save();
-        ctx->translate(pos.getX(), pos.getY());
-        mod->display(ctx, m_starWin);
-        ctx->restore();
-        Point2D p(0.0, mod->getHeight(ctx, m_starWin));
+        if (m_moduleWorker && m_moduleWorker->isBusy(mod->getName())) {
+            heights.push_back(mod->getMeasuredHeight());
+        }
+        else {
+            heights.push_back(mod->measure(ctx, m_starWin));
+        }
+        sumHeight += heights.back();
+    }
+    return sumHeight;
+}
+
+void
+StarPaint::placeModules(const Layout& layout, const std::vector<PtrModule>& modules, const std::vector<int>& heights, Point2D pos)
+{
+    for (size_t i = 0; i < modules.size(); ++i) {
+        auto& mod = modules[i];
+        PlacedModule placed{mod, pos
+                          , layout.getWidth() - static_cast<int>(pos.getX()) + 2 * MODULE_PADDING
+                          , heights[i] + 2 * MODULE_PADDING
+                          , Compositor::UNCACHED
+                          , m_moduleWorker && m_moduleWorker->isBusy(mod->getName())};
+        if (!placed.busy) {
+            placed.key = mod->getDisplayKey(m_starWin);
+        }
+        m_placed.push_back(std::move(placed));
+        Point2D p(0.0, heights[i]);
         pos.add(p);
     }
 }
 
 void
-StarPaint::drawMiddle(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules)
+StarPaint::placeTop(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules)
 {
-    int sumHeight{};
-    for (auto& mod : modules) {
-        sumHeight += mod->getHeight(ctx, m_starWin);
+    measureModules(ctx, modules, m_heights);
+    placeModules(layout, modules, m_heights, Point2D(40.0, 20.0));
+}
+
+void
+StarPaint::placeMiddle(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules)
+{
+    const int sumHeight = measureModules(ctx, modules, m_heights);
+    placeModules(layout, modules, m_heights, Point2D(40.0, (layout.getHeight() - sumHeight) / 2.0));
+}
+
+void
+StarPaint::placeBottom(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules)
+{
+    const int sumHeight = measureModules(ctx, modules, m_heights);
+    placeModules(layout, modules, m_heights, Point2D(40.0, layout.getHeight() - sumHeight - 20.0));
+}
+
+// a module with a late result shows it first (instead of drawing again),
+//   so the update for the late result does not start the module again,
+//   the job only gets the values copied here (under the paint lock)
+bool
+StarPaint::submitModules()
+{
+    bool first{false};
+    for (auto& placed : m_placed) {
+        auto name = placed.module->getName();
+        if (!placed.busy
+         && !m_compositor.hasPrepared(name)
+         && !m_compositor.isCurrent(name, placed.key, placed.width, placed.height)) {
+            first |= !m_compositor.hasLayer(name);
+            m_moduleWorker->submit(name, placed.key, placed.width, placed.height, MODULE_PADDING
+                                 , placed.module->prepareDisplay(m_starWin));
+        }
     }
-    Point2D pos(40.0, (layout.getHeight() - sumHeight) / 2.0);
-    for (auto& mod : modules) {
-        ctx->save();
-        ctx->translate(pos.getX(), pos.getY());
-        mod->display(ctx, m_starWin);
-        ctx->restore();
-        Point2D p(0.0, mod->getHeight(ctx, m_starWin));
-        pos.add(p);
+    return first;
+}
+
+void
+StarPaint::takeModules()
+{
+    m_moduleResults.clear();
+    m_moduleWorker->take(m_moduleResults);
+    for (auto& result : m_moduleResults) {
+        if (!result.error.empty()) {
+            m_starWin->showMessage(result.error, Gtk::MessageType::MESSAGE_ERROR);
+        }
+        m_compositor.prepare(result.name, result.key, std::move(result.surface));
     }
+    m_moduleResults.clear();
 }
 
+// the module gets its own layer, so it is only displayed if the content changed,
+//   if drawn in parallel a module that was not ready shows its last layer
 void
-StarPaint::drawBottom(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules)
+StarPaint::drawModule(const Cairo::RefPtr<Cairo::Context>& ctx, const PlacedModule& placed, bool parallel)
 {
-    int sumHeight{0};
-    for (auto& mod : modules) {
-        sumHeight += mod->getHeight(ctx, m_starWin);
+    const auto& mod = placed.module;
+    const double x = placed.pos.getX() - MODULE_PADDING;
+    const double y = placed.pos.getY() - MODULE_PADDING;
+    if (parallel
+     && (placed.busy
+      || !m_compositor.isCurrent(mod->getName(), placed.key, placed.width, placed.height))) {
+        m_compositor.paintLast(ctx, mod->getName(), x, y);
+        return;
     }
-    Point2D pos(40.0, layout.getHeight() - sumHeight - 20.0);
-    for (auto& mod : modules) {
-        ctx->save();
-        ctx->translate(pos.getX(), pos.getY());
-        mod->display(ctx, m_starWin);
-        ctx->restore();
-        Point2D p(0.0, mod->getHeight(ctx, m_starWin));
-        pos.add(p);
+    m_compositor.paint(ctx, mod->getName(), placed.key
+                     , x, y, placed.width, placed.height
+                     , [&] (const Cairo::RefPtr<Cairo::Context>& moduleCtx) {
+        moduleCtx->translate(MODULE_PADDING, MODULE_PADDING);
+        mod->display(moduleCtx, m_starWin);
+    });
+}
+
+// the sky changes mostly by the rotation of the earth,
+//   other changes e.g. config use invalidate
+size_t
+StarPaint::getSkyKey(const JulianDate& jd, const GeoPosition& geoPos, const Layout& layout)
+{
+    const double r = layout.getMin() / 2.0;
+    auto rotation = static_cast<int64_t>(std::floor(geoPos.localSiderealTime(jd) * r / SKY_PIXEL_THRESHOLD));
+    size_t key = std::hash<int64_t>{}(rotation);
+    key = Compositor::combine(key, std::hash<double>{}(geoPos.getLatDegrees()));
+    key = Compositor::combine(key, std::hash<double>{}(geoPos.getLonDegrees()));
+    key = Compositor::combine(key, m_loaded.load());
+    key = Compositor::combine(key, static_cast<size_t>(layout.getXOffs()) << 32 | static_cast<size_t>(layout.getYOffs()));
+    return key == Compositor::UNCACHED ? 1u : key;
+}
+
+void
+StarPaint::invalidate()
+{
+    m_invalid.store(true);
+    if (m_renderAhead) {
+        m_renderAhead->invalidate();
     }
 }
 
+std::unique_lock<std::mutex>
+StarPaint::lock()
+{
+    return std::unique_lock<std::mutex>(m_drawMutex);
+}
+
 void
 StarPaint::scale(Pango::FontDescription& starFont, double scale)
 {
@@ -511,6 +786,36 @@ StarPaint::setMessierVMagMin(double messierVmagMin)
     m_config->setDouble(MAIN_GRP, MESSIER_VMAGMIN_KEY, messierVmagMin);
 }
 
+double
+StarPaint::getHorizonMargin()
+{
+    return m_config->getDouble(MAIN_GRP, HORIZON_MARGIN_KEY, 2.0);
+}
+
+bool
+StarPaint::isPixelRenderer()
+{
+    return m_config->getBoolean(MAIN_GRP, PIXEL_RENDERER_KEY, false);
+}
+
+uint32_t
+StarPaint::getRenderThreads()
+{
+    return static_cast<uint32_t>(std::max(m_config->getInteger(MAIN_GRP, RENDER_THREADS_KEY, 1), 0));
+}
+
+uint32_t
+StarPaint::getRenderAheadFrames()
+{
+    return static_cast<uint32_t>(std::max(m_config->getInteger(MAIN_GRP, RENDER_AHEAD_KEY, 2), 0));
+}
+
+uint32_t
+StarPaint::getModuleBudget()
+{
+    return static_cast<uint32_t>(std::max(m_config->getInteger(MAIN_GRP, MODULE_BUDGET_KEY, 200), 0));
+}
+
 Pango::FontDescription
 StarPaint::getStarFont()
 {
@@ -578,6 +883,105 @@ StarPaint::getModules()
     return m_modules;
 }
 
+uint32_t
+StarPaint::getModuleCadence()
+{
+    uint32_t cadence{};
+    for (auto& mod : m_modules) {
+        auto seconds = mod->getUpdateSeconds();
+        if (seconds > 0u
+         && !mod->getPosition().empty()
+         && (cadence == 0u || seconds < cadence)) {
+            cadence = seconds;
+        }
+    }
+    return cadence;
+}
+
+void
+StarPaint::paintSky(const Cairo::RefPtr<Cairo::Context>& skyCtx, const JulianDate& jd, GeoPosition& pos, const Layout& layout, SkyScratch& scratch)
+{
+    if (!scratch.spriteAtlas) {
+        scratch.spriteAtlas = std::make_shared<SpriteAtlas>();
+    }
+    scratch.spriteAtlas->setSize(layout.getWidth(), layout.getHeight());
+    auto skySurface = Cairo::RefPtr<Cairo::ImageSurface>::cast_dynamic(skyCtx->get_target());
+    if (scratch.style.renderThreads == 1u) {
+        scratch.bandPool.reset();
+    }
+    else if (!scratch.bandPool
+          || scratch.bandThreads != scratch.style.renderThreads) {
+        scratch.bandPool = std::make_shared<BandPool>(scratch.style.renderThreads);
+        scratch.bandThreads = scratch.style.renderThreads;
+    }
+    if (skySurface && scratch.style.pixelRenderer) {
+        PixelRenderer pixelRenderer(skySurface, scratch.bandPool.get());
+        pixelRenderer.setAtlas(scratch.spriteAtlas);
+        drawSky(&pixelRenderer, jd, pos, layout, scratch);
+        pixelRenderer.finish();
+    }
+    else if (skySurface && scratch.bandPool) {
+        RecordingRenderer recordingRenderer;
+        drawSky(&recordingRenderer, jd, pos, layout, scratch);
+        recordingRenderer.renderBands(skySurface, *scratch.bandPool, scratch.bandAtlases);
+    }
+    else {
+        CairoRenderer cairoRenderer(skyCtx);
+        cairoRenderer.setAtlas(scratch.spriteAtlas);
+        drawSky(&cairoRenderer, jd, pos, layout, scratch);
+    }
+}
+
+void
+StarPaint::getSkyStyle(SkyStyle& style)
+{
+    style.startColor = getStartColor();
+    style.stopColor = getStopColor();
+    style.starFont = getStarFont();
+    style.showMilkyway = isShowMilkyway();
+    style.messierVMagMin = getMessierVMagMin();
+    style.horizonMargin = getHorizonMargin();
+    style.pixelRenderer = isPixelRenderer();
+    style.renderThreads = getRenderThreads();
+}
+
+Cairo::RefPtr<Cairo::ImageSurface>
+StarPaint::drawSkyLayer(const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch)
+{
+    auto surface = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32
+                                             , layout.getXOffs() + layout.getWidth(), layout.getYOffs() + layout.getHeight());
+    auto skyCtx = Cairo::Context::create(surface);
+    paintSky(skyCtx, jd, geoPos, layout, scratch);
+    surface->flush();
+    return surface;
+}
+
+void
+StarPaint::scheduleAhead(const std::vector<Glib::DateTime>& times, const GeoPosition& pos, int width, int height)
+{
+    if (m_renderAhead) {
+        m_renderAhead->schedule(times, pos, width, height);
+    }
+}
+
+std::shared_ptr<RenderAhead>
+StarPaint::getRenderAhead()
+{
+    return m_renderAhead;
+}
+
+std::chrono::milliseconds
+StarPaint::getFirstFrameTime() const
+{
+    return std::chrono::milliseconds(m_firstFrameMs.load());
+}
+
+const Compositor&
+StarPaint::getCompositor()
+{
+    return m_compositor;
+}
+
 void
 StarPaint::drawImage(Cairo::RefPtr<Cairo::Context>& ctx
             , const Glib::DateTime& now
@@ -586,12 +990,65 @@ StarPaint::drawImage(Cairo::RefPtr<Cairo::Context>& ctx
 {
     JulianDate jd(now);
     //std::cout << std::fixed << "jd " << jd.getJulianDate() << std::endl;
-    ctx->save();
-    CairoRenderer cairoRenderer(ctx);
-    drawSky(&cairoRenderer, jd, pos, layout);
-    ctx->restore();
-
-    drawTop(ctx, layout, findModules(Module::POS_TOP));
-    drawMiddle(ctx, layout, findModules(Module::POS_MIDDLE));
-    drawBottom(ctx, layout, findModules(Module::POS_BOTTOM));
+    if (m_invalid.exchange(false)) {
+        m_compositor.invalidate();
+        for (auto& mod : m_modules) {
+            mod->invalidateLayout();
+        }
+    }
+    m_compositor.begin(layout.getXOffs() + layout.getWidth(), layout.getYOffs() + layout.getHeight());
+    m_placed.clear();
+    placeTop(ctx, layout, findModules(Module::POS_TOP));
+    placeMiddle(ctx, layout, findModules(Module::POS_MIDDLE));
+    placeBottom(ctx, layout, findModules(Module::POS_BOTTOM));
+    // the modules are drawn on the worker while the sky is painted
+    const auto budget = getModuleBudget();
+    const bool parallel = m_moduleWorker && budget > 0u;
+    bool waitFirst{false};
+    if (parallel) {
+        takeModules();      // those that finished late for a previous image
+        waitFirst = submitModules();
+    }
+    const auto skyKey = getSkyKey(jd, pos, layout);
+    if (m_renderAhead) {
+        auto sky = m_renderAhead->take(skyKey);
+        if (sky) {
+            m_compositor.prepare(SKY_LAYER, skyKey, std::move(sky));
+        }
+    }
+    m_compositor.paint(ctx, SKY_LAYER, skyKey
+                     , 0.0, 0.0, layout.getXOffs() + layout.getWidth(), layout.getYOffs() + layout.getHeight()
+                     , [&] (const Cairo::RefPtr<Cairo::Context>& skyCtx) {
+        getSkyStyle(m_scratch.style);
+        paintSky(skyCtx, jd, pos, layout, m_scratch);
+    });
+    if (parallel) {
+        // a module without a previous image would be missing, so wait for it
+        m_moduleWorker->wait(waitFirst ? ModuleWorker::NO_BUDGET : std::chrono::milliseconds(budget));
+        takeModules();
+    }
+    for (auto& placed : m_placed) {
+        drawModule(ctx, placed, parallel);
+    }
+    m_compositor.end();
+    if (m_firstFrameMs.load() == 0) {
+        auto elapsed = std::chrono::steady_clock::now() - m_starWin->getBackgroundAppl()->getStarted();
+        m_firstFrameMs.store(std::max<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 1));
+#       ifdef DEBUG
+        std::cout << "First frame after " << m_firstFrameMs.load() << "ms"
+                  << " catalogs 0x" << std::hex << m_loaded.load() << std::dec << std::endl;
+#       endif
+    }
+#   ifdef DEBUG
+    std::cout << "StarPaint::drawImage layers drawn " << m_compositor.getDrawn()
+              << " cached " << m_compositor.getCached() << std::endl;
+    for (auto& mod : m_modules) {
+        std::cout << "  " << mod->getName()
+                  << " hits " << m_compositor.getHits(mod->getName())
+                  << " misses " << m_compositor.getMisses(mod->getName()) << std::endl;
+    }
+    if (m_moduleWorker) {
+        std::cout << "  module overruns " << m_moduleWorker->getOverruns() << std::endl;
+    }
+#   endif
 }
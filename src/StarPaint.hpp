@@ -20,6 +20,11 @@
 
 #include <KeyConfig.hpp>
 #include <gtkmm.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <map>
 
 #include "Layout.hpp"
 #include "GeoPosition.hpp"
@@ -27,20 +32,78 @@
 #include "SysInfo.hpp"
 #include "Milkyway.hpp"
 #include "Module.hpp"
+#include "Compositor.hpp"
+#include "ModuleWorker.hpp"
+#include "Renderer.hpp"
+#include "BandPool.hpp"
 
 class HipparcosFormat;
 class ConstellationFormat;
 class BackgroundApp;
 class MessierLoader;
+class Planets;
 class StarWin;
 class Renderer;
+class HorizonMatrix;
+class UnitVectors;
+class RenderAhead;
+
+// the settings the sky is drawn with, taken at once,
+//   so a drawing on other threads does not read the config
+struct SkyStyle
+{
+    Gdk::RGBA startColor;
+    Gdk::RGBA stopColor;
+    Pango::FontDescription starFont;
+    bool showMilkyway{true};
+    double messierVMagMin{5.0};
+    double horizonMargin{2.0};
+    bool pixelRenderer{false};
+    uint32_t renderThreads{1u};
+};
+
+// the state of a sky drawing, each thread drawing the sky uses its own
+struct SkyScratch
+{
+    SkyStyle style;
+    // screen positions, kept to avoid allocation on each draw
+    std::vector<double> screenX;
+    std::vector<double> screenY;
+    std::vector<double> screenZ;
+    std::vector<uint8_t> visibleItems;
+    // batches by style, cleared for each use
+    DotBatch starBatch;
+    std::vector<double> starRadius;     // by STAR_RADIUS_STEP from STAR_RADIUS_VMAG_MIN
+    std::map<int, PolylineBatch> lineBatches;
+    std::vector<std::pair<uint32_t, Point2D>> labels;
+    PointClusters messierClusters;
+    Glib::ustring label;
+    std::shared_ptr<SpriteAtlas> spriteAtlas;
+    std::vector<std::shared_ptr<SpriteAtlas>> bandAtlases;     // one per band for the parallel drawing
+    std::shared_ptr<BandPool> bandPool;                        // created for bandThreads
+    uint32_t bandThreads{};
+};
 
 class StarPaint
 {
 public:
     StarPaint(StarWin* starWin);
     explicit StarPaint(const StarPaint& orig) = delete;
-    virtual ~StarPaint() = default;
+    virtual ~StarPaint();
+
+    // the catalogs get loaded in background, bits for isLoaded
+    enum class Catalog : uint32_t
+    {
+          Stars = 1u
+        , Constellations = 2u
+        , Milkyway = 4u
+        , Messier = 8u
+    };
+    bool isLoaded(Catalog catalog) const;
+    // emitted on the main thread for each catalog that finished loading
+    sigc::signal<void(Catalog)> signal_loaded();
+    // emitted on the main thread if a module finished after its image, to show it
+    sigc::signal<void()> signal_moduleLate();
 
     static constexpr auto TEXT_GRAY_LOW{0.3};
     static constexpr auto TEXT_GRAY{0.6};
@@ -50,10 +113,17 @@ public:
     static constexpr auto LINE_WIDTH_FACTOR{900.0};
     static constexpr auto MIN_STAR_FACTOR{900.0};
     static constexpr auto MAX_STAR_FACTOR{350.0};
+    static constexpr auto FAINT_STAR_VMAG{5.0};         // the radius reaches MIN_STAR_FACTOR here
+    static constexpr auto MIN_VISIBLE_STAR_RADIUS{0.5}; // pixel, fainter are not drawn
+    static constexpr auto STAR_RADIUS_VMAG_MIN{-2.0};   // the radius table starts here
+    static constexpr auto STAR_RADIUS_STEP{0.1};        // vmag
     static constexpr auto PLANET_FACTOR{300.0};
     static constexpr auto MESSIER_FACTOR{300.0};
     static constexpr auto CLUSTER_FACTOR{75.0};
     static constexpr auto SUNMOON_FACTOR{200.0};
+    static constexpr auto SKY_PIXEL_THRESHOLD{0.5};     // redraw the sky if it moved more than this
+    static constexpr auto MODULE_PADDING{8};            // extra space for the cached modules
+    static constexpr auto SKY_LAYER{"sky"};
 
     static constexpr auto START_COLOR_KEY{"startColor"};
     static constexpr auto STOP_COLOR_KEY{"stopColor"};
@@ -62,6 +132,11 @@ public:
     static constexpr auto MAIN_GRP{"main"};
     static constexpr auto SHOW_MILKYWAY_KEY{"showMilkyway"};
     static constexpr auto MESSIER_VMAGMIN_KEY{"messierVMagMin"};
+    static constexpr auto HORIZON_MARGIN_KEY{"horizonMargin"};     // degrees below horizon still considered for drawing
+    static constexpr auto PIXEL_RENDERER_KEY{"pixelRenderer"};     // draw the sky without cairo, default off
+    static constexpr auto RENDER_THREADS_KEY{"renderThreads"};     // bands drawn in parallel, 0 use cores, 1 off (default)
+    static constexpr auto RENDER_AHEAD_KEY{"renderAhead"};         // daemon updates the sky is drawn ahead for, 0 off
+    static constexpr auto MODULE_BUDGET_KEY{"moduleBudgetMs"};     // modules are drawn beside the sky for at most this, 0 in sequence
 
     std::shared_ptr<KeyConfig> getConfig();
     Pango::FontDescription getStarFont();
@@ -74,10 +149,17 @@ public:
     void setShowMilkyway(bool showMilkyway);
     double getMessierVMagMin();
     void setMessierVMagMin(double showMessier);
+    double getHorizonMargin();
+    bool isPixelRenderer();
+    uint32_t getRenderThreads();
+    uint32_t getRenderAheadFrames();
+    uint32_t getModuleBudget();
     void scale(Pango::FontDescription& starFont, double scale);
     void brighten(Gdk::RGBA& calColor, double factor);
     std::vector<PtrModule> createModules();
     std::vector<PtrModule> getModules();
+    // the shortest update cadence of the shown modules in seconds, 0 none
+    uint32_t getModuleCadence();
     std::shared_ptr<FileLoader> getFileLoader()
     {
         return m_fileLoader;
@@ -87,24 +169,70 @@ public:
             , const Glib::DateTime& now
             , GeoPosition& pos
             , Layout& layout);
+    // draws with the current settings, use with the lock
     void drawSky(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout);
+    void drawSky(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch);
+    // the sky layer as drawn by drawImage with the style of the scratch,
+    //   does not need the lock if the scratch is owned by the caller
+    Cairo::RefPtr<Cairo::ImageSurface> drawSkyLayer(const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch);
+    // take the current settings, use with the lock
+    void getSkyStyle(SkyStyle& style);
+    size_t getSkyKey(const JulianDate& jd, const GeoPosition& geoPos, const Layout& layout);
+    // for the daemon draw the sky of the next updates (utc) in background, if enabled
+    void scheduleAhead(const std::vector<Glib::DateTime>& times, const GeoPosition& pos, int width, int height);
+    std::shared_ptr<RenderAhead> getRenderAhead();
+    // from the start of the program until the first image was drawn, 0 before
+    std::chrono::milliseconds getFirstFrameTime() const;
+    // the layer statistics, hold the lock while reading
+    const Compositor& getCompositor();
+    // the cached layers are redrawn on next drawImage, use on config changes,
+    //   does not need the lock
+    void invalidate();
+    // the drawing may run on the render worker,
+    //   hold this while changing settings from the main thread
+    std::unique_lock<std::mutex> lock();
 
 protected:
-    void draw_planets(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout);
+    void draw_planets(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch);
     void draw_sun(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout);
     void draw_moon(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout);
-    void draw_stars(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout);
-    void draw_constl(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout);
-    void draw_milkyway(Renderer* renderer ,const JulianDate& jd, GeoPosition& geoPos, const Layout& layout);
-    void draw_messier(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout);
-    std::vector<NamedPoint> cluster(const std::vector<NamedPoint>& points, double distance = 20.0);
+    void draw_stars(Renderer* renderer, const HorizonMatrix& horizon, const Layout& layout, SkyScratch& scratch);
+    void draw_constl(Renderer* renderer, const HorizonMatrix& horizon, const Layout& layout, SkyScratch& scratch);
+    void draw_milkyway(Renderer* renderer, const HorizonMatrix& horizon, const Layout& layout, SkyScratch& scratch);
+    // fills screenX... of the scratch for the given vectors
+    void toScreen(const HorizonMatrix& horizon, const UnitVectors& vectors, const Layout& layout, SkyScratch& scratch);
+    void toScreen(const HorizonMatrix& horizon, const UnitVectors& vectors, size_t first, size_t count, const Layout& layout, SkyScratch& scratch);
+    double getStarRadius(double vmag, const Layout& layout);
+    double getLimitingMagnitude(const Layout& layout);
+    void draw_messier(Renderer* renderer, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch);
 
+    // a module as placed for a image, the key is taken once for the image
+    struct PlacedModule
+    {
+        PtrModule module;
+        Point2D pos;
+        int width;      // including the padding
+        int height;
+        size_t key;
+        bool busy;      // still drawing for a previous image, so it is not touched
+    };
     std::vector<PtrModule> findModules(const char* pos);
-    void drawTop(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules);
-    void drawMiddle(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules);
-    void drawBottom(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules);
+    int measureModules(const Cairo::RefPtr<Cairo::Context>& ctx, const std::vector<PtrModule>& modules, std::vector<int>& heights);
+    void placeModules(const Layout& layout, const std::vector<PtrModule>& modules, const std::vector<int>& heights, Point2D pos);
+    void placeTop(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules);
+    void placeMiddle(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules);
+    void placeBottom(const Cairo::RefPtr<Cairo::Context>& ctx, Layout& layout, const std::vector<PtrModule>& modules);
+    // start the modules that need to be drawn on the worker,
+    //   true if one has no previous image
+    bool submitModules();
+    // offer the surfaces the worker finished to the compositor
+    void takeModules();
+    void drawModule(const Cairo::RefPtr<Cairo::Context>& ctx, const PlacedModule& placed, bool parallel);
+    void paintSky(const Cairo::RefPtr<Cairo::Context>& skyCtx, const JulianDate& jd, GeoPosition& geoPos, const Layout& layout, SkyScratch& scratch);
     double getLineWidth(const Layout& layout);
     double getSunMoonRadius(const Layout& layout);
+    void loadCatalogs();    // runs on m_loader thread
+    void on_loaded();
 
 
 private:
@@ -114,8 +242,26 @@ private:
     std::shared_ptr<KeyConfig> m_config;
     std::shared_ptr<Milkyway> m_milkyway;
     std::shared_ptr<MessierLoader> m_messier;
+    std::shared_ptr<Planets> m_planets;
     std::vector<PtrModule> m_modules;
     std::shared_ptr<FileLoader> m_fileLoader;
+    std::thread m_loader;
+    Glib::Dispatcher m_loadedDispatcher;
+    std::atomic<uint32_t> m_loaded{0u};
+    uint32_t m_loadedSignaled{0u};
+    sigc::signal<void(Catalog)> m_signalLoaded;
+    sigc::signal<void()> m_signalModuleLate;
+    std::atomic<int64_t> m_firstFrameMs{0};     // the first image may be drawn on the render worker
+    SkyScratch m_scratch;       // used by drawImage, with the lock
+    Compositor m_compositor;
+    std::mutex m_drawMutex;
+    std::atomic<bool> m_invalid{false};
+    std::shared_ptr<RenderAhead> m_renderAhead;
+    // the modules of the current image, kept to avoid allocation on each draw
+    std::vector<PlacedModule> m_placed;
+    std::vector<int> m_heights;
+    std::vector<ModuleWorker::Result> m_moduleResults;
+    std::shared_ptr<ModuleWorker> m_moduleWorker;
 };
 
 using PtrStarPaint = std::shared_ptr<StarPaint>;
\ No newline at end of file
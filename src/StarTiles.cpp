@@ -0,0 +1,140 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "StarTiles.hpp"
+#include "HorizonMatrix.hpp"
+#include "SkyIndex.hpp"
+#include "Math.hpp"
+
+uint32_t
+StarTiles::getTier(double vmag)
+{
+    auto limit = std::lower_bound(TIER_LIMITS.begin(), TIER_LIMITS.end(), vmag);
+    return static_cast<uint32_t>(limit - TIER_LIMITS.begin());
+}
+
+std::vector<StarTileRecord>
+StarTiles::build(std::vector<CatalogStar>& stars)
+{
+    struct Key
+    {
+        uint32_t tier;
+        uint32_t cell;
+    };
+    std::vector<Key> keys;
+    keys.reserve(stars.size());
+    std::vector<uint32_t> order(stars.size());
+    for (uint32_t i = 0; i < stars.size(); ++i) {
+        keys.push_back(Key{getTier(stars[i].vmag), SkyIndex::getCell(stars[i].ra, stars[i].dec)});
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&] (uint32_t a, uint32_t b) {
+        if (keys[a].tier != keys[b].tier) {
+            return keys[a].tier < keys[b].tier;
+        }
+        if (keys[a].cell != keys[b].cell) {
+            return keys[a].cell < keys[b].cell;
+        }
+        return stars[a].vmag < stars[b].vmag;
+    });
+    std::vector<CatalogStar> sorted;
+    sorted.reserve(stars.size());
+    std::vector<Key> sortedKeys;
+    sortedKeys.reserve(stars.size());
+    for (auto idx : order) {
+        sorted.push_back(stars[idx]);
+        sortedKeys.push_back(keys[idx]);
+    }
+    stars.swap(sorted);
+
+    std::vector<StarTileRecord> tiles;
+    uint32_t first{};
+    while (first < stars.size()) {
+        uint32_t end = first + 1u;
+        while (end < stars.size()
+            && sortedKeys[end].tier == sortedKeys[first].tier
+            && sortedKeys[end].cell == sortedKeys[first].cell) {
+            ++end;
+        }
+        double cx{}, cy{}, cz{};
+        for (uint32_t i = first; i < end; ++i) {
+            const double cosDec = std::cos(stars[i].dec);
+            cx += cosDec * std::cos(stars[i].ra);
+            cy += cosDec * std::sin(stars[i].ra);
+            cz += std::sin(stars[i].dec);
+        }
+        const double len = std::sqrt(cx * cx + cy * cy + cz * cz);
+        double radius{Math::PI};    // in case the stars cancel out
+        if (len > 1.0e-9) {
+            cx /= len;
+            cy /= len;
+            cz /= len;
+            radius = 0.0;
+            for (uint32_t i = first; i < end; ++i) {
+                const double cosDec = std::cos(stars[i].dec);
+                const double dot = cx * cosDec * std::cos(stars[i].ra)
+                                 + cy * cosDec * std::sin(stars[i].ra)
+                                 + cz * std::sin(stars[i].dec);
+                radius = std::max(radius, std::acos(std::clamp(dot, -1.0, 1.0)));
+            }
+            radius += 2.0 / UnitVectors::QUANT_SCALE;   // allow for the quantized center
+        }
+        StarTileRecord tile{};
+        tile.first = first;
+        tile.count = end - first;
+        tile.minVmag = CatalogFile::quantizeMagnitude(stars[first].vmag);
+        tile.maxVmag = CatalogFile::quantizeMagnitude(stars[end - 1u].vmag);
+        tile.x = UnitVectors::quantize(cx);
+        tile.y = UnitVectors::quantize(cy);
+        tile.z = UnitVectors::quantize(cz);
+        tile.radius = static_cast<uint16_t>(std::min(std::ceil(radius * RADIUS_SCALE), 65535.0));
+        tiles.push_back(tile);
+        first = end;
+    }
+    return tiles;
+}
+
+StarTileRecord
+StarTiles::all(uint32_t count)
+{
+    StarTileRecord tile{};
+    tile.count = count;
+    tile.minVmag = INT16_MIN;
+    tile.maxVmag = INT16_MAX;
+    tile.z = static_cast<int16_t>(UnitVectors::QUANT_SCALE);
+    tile.radius = static_cast<uint16_t>(std::ceil(Math::PI * RADIUS_SCALE));
+    return tile;
+}
+
+bool
+StarTiles::isVisible(const StarTileRecord& tile, const HorizonMatrix& horizon)
+{
+    const double radius = static_cast<double>(tile.radius) / RADIUS_SCALE;
+    if (radius >= Math::HALF_PI) {
+        return true;
+    }
+    double x, y, z;
+    horizon.toHorizon(tile.x / UnitVectors::QUANT_SCALE
+                    , tile.y / UnitVectors::QUANT_SCALE
+                    , tile.z / UnitVectors::QUANT_SCALE, x, y, z);
+    // the center altitude may be below the horizon by radius
+    return z >= -std::sin(radius);
+}
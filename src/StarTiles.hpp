@@ -0,0 +1,60 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+
+#include "CatalogFile.hpp"
+
+class HorizonMatrix;
+
+// the values needed to build the tiles
+struct CatalogStar
+{
+    double ra;          // radians
+    double dec;
+    double vmag;
+    int32_t number;
+};
+
+/**
+ * Partition the stars by magnitude tiers and cells of the sky,
+ *   this allows to skip faint tiers for small displays and cells below the horizon.
+ *   The cells are the cells of SkyIndex.
+ */
+class StarTiles
+{
+public:
+    StarTiles() = delete;
+
+    static constexpr std::array<double, 9> TIER_LIMITS{3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0};
+    static constexpr double RADIUS_SCALE{10000.0};
+
+    // sorts stars by tier, cell, magnitude and returns the resulting tiles
+    static std::vector<StarTileRecord> build(std::vector<CatalogStar>& stars);
+    // a tile covering all stars, if the catalog has no tiles
+    static StarTileRecord all(uint32_t count);
+    // true if any part of tile may be above the horizon
+    static bool isVisible(const StarTileRecord& tile, const HorizonMatrix& horizon);
+
+protected:
+    static uint32_t getTier(double vmag);
+};
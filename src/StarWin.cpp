@@ -27,6 +27,10 @@
 #include "StarMountOperation.hpp"
 #include "FileLoader.hpp"
 #include "StarPaint.hpp"
+#include "RenderAhead.hpp"
+#include "Layout.hpp"
+#include "ImageEncoder.hpp"
+#include "ImageOutput.hpp"
 #include "KeyConfig.hpp"
 #include "ParamDlg.hpp"
 #include "TimeDlg.hpp"
@@ -57,6 +61,11 @@ StarWin::StarWin(BaseObjectType* cobject
     setupConfig();
     m_fileLoader = std::make_shared<FileLoader>(backAppl->get_exec_path());
     m_starPaint = std::make_shared<StarPaint>(this);
+    m_starPaint->signal_loaded().connect([this] (StarPaint::Catalog catalog) {
+        refresh();      // the loaded catalogs are part of the sky key, so only the sky is drawn again
+    });
+    m_starPaint->signal_moduleLate().connect(sigc::mem_fun(*this, &StarWin::refresh));
+    m_xfconf.signal_failed().connect(sigc::mem_fun(*this, &StarWin::setBackgroundExec));
     if (m_backAppl->isDaemon()) {
         iconify();
         add_action("preferences", sigc::mem_fun(*this, &StarWin::on_menu_param));
@@ -74,6 +83,7 @@ StarWin::StarWin(BaseObjectType* cobject
         m_appMenu = std::make_shared<AppMenu>();
 #       endif
     }
+    watchScreenSaver();
     updateTimer();
     signal_hide().connect([this] {
         if (m_timer.connected()) {
@@ -105,9 +115,19 @@ StarWin::loadThisConfig(const std::shared_ptr<KeyConfig>& config)
 void
 StarWin::loadConfig()
 {
+    auto lock = lockPaint();
     loadThisConfig(m_config);
 }
 
+std::unique_lock<std::mutex>
+StarWin::lockPaint()
+{
+    if (m_starPaint) {
+        return m_starPaint->lock();
+    }
+    return std::unique_lock<std::mutex>();
+}
+
 void
 StarWin::setupConfig()
 {
@@ -202,38 +222,154 @@ StarWin::getBackgroundAppl()
     return m_backAppl;
 }
 
+// wake when the sky moved visibly or a module changes,
+//   with a threshold of 0 use the interval aligned to the minute
 void
 StarWin::updateTimer()
 {
-    Glib::DateTime dateTime = Glib::DateTime::create_now_local();
-    // aim for next minute change,
-    //  with some extra to prevent a underrun
-    //  (overall there seems rather be a chance to overshoot especially with load)
-    uint32_t intervalMinutes = getIntervalMinutes();
-    auto delay = (intervalMinutes * 60000u + 20u) - static_cast<unsigned int>(dateTime.get_seconds() * 1000.0);
+    int width, height;
+    getImageSize(width, height);
+    // before the window got its size the sky speed is unknown
+    const bool sized = width > 1 && height > 1;
+    const double threshold = sized ? getUpdateThreshold() : 0.0;
+    m_scheduler.setThreshold(threshold);
+    if (threshold > 0.0) {
+        m_scheduler.setMaxDelay(MAX_ADAPTIVE_DELAY);
+        m_scheduler.setCadence(m_starPaint->getModuleCadence());
+    }
+    else {
+        const auto interval = static_cast<uint32_t>(std::max(getIntervalMinutes(), 1)) * 60u;
+        m_scheduler.setMaxDelay(static_cast<double>(interval) + UpdateScheduler::CADENCE_MARGIN);
+        m_scheduler.setCadence(interval);
+    }
+    const double radius = static_cast<double>(Layout(width, height).getMin()) / 2.0;
+    auto toSeconds = [] (const Glib::DateTime& dateTime) {
+        return static_cast<double>(dateTime.to_unix()) + static_cast<double>(dateTime.get_microsecond()) / 1.0e6;
+    };
+    auto now = Glib::DateTime::create_now_utc();
+    const double utcOffset = static_cast<double>(Glib::DateTime::create_now_local().get_utc_offset()) / 1.0e6;   // micro seconds
+    const double delay = m_scheduler.getDelay(toSeconds(now), utcOffset, radius, m_nextReason);
+    m_nextUpdate = now.add_seconds(delay);
     m_timer = Glib::signal_timeout().connect(
             sigc::mem_fun(*this, &StarWin::updatePeriodic)
-            , delay);
+            , static_cast<unsigned int>(delay * 1000.0));
+    if (m_starPaint->getRenderAhead()
+     && !isPaused()) {
+        std::vector<Glib::DateTime> times{m_nextUpdate};
+        UpdateScheduler::Reason reason;
+        while (times.size() < m_starPaint->getRenderAhead()->getCapacity()) {
+            auto last = times.back();
+            times.push_back(last.add_seconds(m_scheduler.getDelay(toSeconds(last), utcOffset, radius, reason)));
+        }
+        m_starPaint->scheduleAhead(times, getGeoPosition(), width, height);
+    }
 }
 
 bool
 StarWin::updatePeriodic()
 {
-    if (!m_updateBlocked) {
+    const bool paused = m_updateBlocked || isPaused();
+    m_scheduler.countWake(m_nextReason, paused);
+    if (!paused) {
         auto now = Glib::DateTime::create_now_utc();
+        // use the time the sky was drawn ahead for, unless the wake is late
+        //   e.g. after a suspend, then the drawn sky is a miss
+        if (m_starPaint->getRenderAhead()
+         && std::abs(static_cast<double>(now.difference(m_nextUpdate))) / 1.0e6 <= AHEAD_TOLERANCE) {   // micro seconds
+            now = m_nextUpdate;
+        }
         auto pos = getGeoPosition();
         update(now, pos);
     }
+#   ifdef DEBUG
+    std::cout << "StarWin::updatePeriodic wakes sky " << m_scheduler.getWakes(UpdateScheduler::Reason::Sky)
+              << " cadence " << m_scheduler.getWakes(UpdateScheduler::Reason::Cadence)
+              << " interval " << m_scheduler.getWakes(UpdateScheduler::Reason::Interval)
+              << " paused " << m_scheduler.getPaused() << std::endl;
+#   endif
     updateTimer();
     return false;
 }
 
+void
+StarWin::getImageSize(int& width, int& height)
+{
+    if (m_backAppl->isDaemon()) {
+        auto screen = Gdk::Screen::get_default();
+        Gdk::Rectangle rect;
+        screen->get_monitor_geometry(getDaemonDisplay(), rect);
+        width = rect.get_width();
+        height = rect.get_height();
+    }
+    else {
+        width = m_drawingArea->get_allocated_width();
+        height = m_drawingArea->get_allocated_height();
+    }
+}
+
+// the screensaver is active while the session is locked or the monitor is blanked
+void
+StarWin::watchScreenSaver()
+{
+    Gio::DBus::Proxy::create_for_bus(Gio::DBus::BusType::BUS_TYPE_SESSION
+        , SCREENSAVER_NAME, SCREENSAVER_PATH, SCREENSAVER_NAME
+        , [this] (Glib::RefPtr<Gio::AsyncResult>& result) {
+        try {
+            m_screenSaver = Gio::DBus::Proxy::create_for_bus_finish(result);
+            m_screenSaver->signal_signal().connect(sigc::mem_fun(*this, &StarWin::on_screensaver_signal));
+            m_screenSaver->call("GetActive", [this] (Glib::RefPtr<Gio::AsyncResult>& callResult) {
+                try {
+                    auto ret = m_screenSaver->call_finish(callResult);
+                    Glib::Variant<bool> active;
+                    ret.get_child(active);
+                    m_screenSaverActive = active.get();
+                }
+                catch (const Glib::Error& exc) {
+                    std::cout << "No screensaver state, updates are not paused " << exc.what() << std::endl;
+                }
+            });
+        }
+        catch (const Glib::Error& exc) {
+            std::cout << "No screensaver, updates are not paused " << exc.what() << std::endl;
+        }
+    });
+}
+
+void
+StarWin::on_screensaver_signal(const Glib::ustring& sender, const Glib::ustring& signal, const Glib::VariantContainerBase& params)
+{
+    if (signal == "ActiveChanged") {
+        Glib::Variant<bool> active;
+        params.get_child(active);
+        m_screenSaverActive = active.get();
+        if (!m_screenSaverActive
+         && !m_updateBlocked) {
+            auto now = Glib::DateTime::create_now_utc();   // show the current state at once
+            auto pos = getGeoPosition();
+            update(now, pos);
+        }
+    }
+}
+
+bool
+StarWin::isPaused()
+{
+    return m_screenSaverActive;
+}
+
+double
+StarWin::getUpdateThreshold()
+{
+    return m_config->getDouble(StarPaint::MAIN_GRP, UPDATE_THRESHOLD_KEY, UPDATE_THRESHOLD_DEFAULT);
+}
+
 void
 StarWin::update()
 {
     if (m_timerUpdate.connected()) {
         m_timerUpdate.disconnect();
     }
+    m_starPaint->invalidate();      // this is used on settings changes, so draw everything
     // delay updating in case of rapid config changes
     m_timerUpdate = Glib::signal_timeout().connect(
         [this] {
@@ -244,6 +380,25 @@ StarWin::update()
         }, 100);
 }
 
+void
+StarWin::refresh()
+{
+    if (m_timerUpdate.connected()) {
+        return;     // a update is pending anyway
+    }
+    m_timerUpdate = Glib::signal_timeout().connect(
+        [this] {
+            if (m_backAppl->isDaemon()) {
+                auto pos = getGeoPosition();
+                update(m_lastUpdate, pos);  // the sky drawn for this is kept
+            }
+            else {
+                m_drawingArea->update();
+            }
+            return false;
+        }, 100);
+}
+
 void
 StarWin::setBackgroundExec(const Glib::RefPtr<Gio::File>& file)
 {
@@ -276,56 +431,11 @@ StarWin::setBackgroundExec(const Glib::RefPtr<Gio::File>& file)
     m_fileLoader->run(cmds, &pid);
 }
 
-// leave this as an option as these are xfce internals.
-//   but maybe your bus tells you how you can jump unto it ...
-void
-StarWin::setBackgroundDbus(const Glib::ustring& dbusChannel, const Glib::ustring& dbusProperty, const Glib::RefPtr<Gio::File>& file)
-{
-    auto dbusProxy= Gio::DBus::Proxy::create_for_bus_sync(Gio::DBus::BusType::BUS_TYPE_SESSION
-        ,  "org.xfce.Xfconf"   // "org.freedesktop.DBus"
-        , "/org/xfce/Xfconf"   // "/org/freedesktop/DBus"
-        , "org.xfce.Xfconf" );  // "org.freedesktop.DBus"
-
-    //= Gio::DBus::Proxy::create_for_bus_sync(
-    //    Gio::DBus::BusType::BUS_TYPE_SESSION
-    //    , dbusChannel
-    //    , dbusProperty
-    //    , "");
-    std::cout << "proxy created" << std::endl;
-    auto cancel = Gio::Cancellable::create();
-    auto call_result = dbusProxy->call_sync("Introspect", cancel);   // 4 dbus "ListNames"
-    Glib::Variant<std::vector<Glib::ustring>> names_variant;
-    call_result.get_child(names_variant);
-
-    // Get the vector of strings.
-    auto names = names_variant.get();
-
-    std::cout << "The names on the message bus are:" << std::endl;
-
-    for (const auto& i : names) {
-        std::cout << i  << std::endl;
-    }
-
-    if (false) {
-        std::vector<std::string> vects;
-        vects.push_back(file->get_path());
-        auto param = Glib::Variant<std::vector<std::string>>::create(vects);
-        std::cout << "param " << file->get_path() << std::endl;
-        Glib::ustring method("set");
-        auto ret = dbusProxy->call_sync(method, cancel, param);
-        if (ret) {
-            std::cout << "called " << ret.print(true) << std::endl;
-        }
-        else {
-            std::cout << "called" << std::endl;
-        }
-    }
-}
-
 void
 StarWin::update(Glib::DateTime now, GeoPosition& pos)
 {
     if (m_backAppl->isDaemon()) {
+        m_lastUpdate = now;
         auto screen = Gdk::Screen::get_default();
         auto monitorNum = getDaemonDisplay();
          Gdk::Rectangle rect;
@@ -333,39 +443,88 @@ StarWin::update(Glib::DateTime now, GeoPosition& pos)
         int width = rect.get_width();
         int height = rect.get_height();
         std::cout << "Monitor size " << width << " x " << height << std::endl;
-        auto image = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, width, height);
+        auto image = Cairo::ImageSurface::create(
+                  isImageAlpha() ? Cairo::Format::FORMAT_ARGB32 : Cairo::Format::FORMAT_RGB24
+                , width, height);
         Layout layout(width, height);
-        auto ctx = Cairo::Context::create(image);
-        m_starPaint->drawImage(ctx, now, pos, layout);
+        {
+            auto ctx = Cairo::Context::create(image);
+            auto lock = m_starPaint->lock();
+            m_starPaint->drawImage(ctx, now, pos, layout);
+        }
         // create new
-        auto dateTime = now.format("%F_%H%M%S%f");  // build a long name, as updates work only when filename changes e.g. from settings dialog
-        auto fileName = psc::fmt::format("{}{}.png", IMAGE_PREFIX, dateTime);
-        auto localDir = m_fileLoader->getLocalDir();
-        auto temp = localDir->get_child(fileName);
-        //std::cout << "Temp " << temp->get_path() << std::endl;
-        image->write_to_png(temp->get_path());
-        auto dbusChannel = getDaemonDbusChannel();
-        auto dbusProperty = getDaemonDbusProperty();
-        //std::cout << "dbusChannel " << dbusChannel << " dbusProperty " << dbusProperty << std::endl;
-        if (!dbusChannel.empty()
-         && !dbusProperty.empty()) {
-            setBackgroundDbus(dbusChannel, dbusProperty, temp);
+        auto options = getEncodeOptions();
+        if (!m_imageEncoder) {
+            auto localDir = m_fileLoader->getLocalDir();
+            cleanUp(localDir);
+            m_imageOutput = std::make_shared<ImageOutput>(localDir->get_path(), IMAGE_PREFIX);
+            m_imageOutput->restoreShown(ImageEncoder::getExtension(options.format));
+            m_imageEncoder = std::make_shared<ImageEncoder>();
+            m_imageEncoder->signal_encoded().connect(sigc::mem_fun(*this, &StarWin::on_image_encoded));
         }
-        else {
-        // use exec
-            setBackgroundExec(temp);
+        // alternate the name, as updates work only when filename changes e.g. from settings dialog
+        auto path = m_imageOutput->getNext(ImageEncoder::getExtension(options.format));
+        //std::cout << "Path " << path << std::endl;
+        m_imageEncoder->encode(std::move(image), path, options);
+#       ifdef DEBUG
+        if (m_starPaint->getRenderAhead()) {
+            std::cout << "StarWin::update drawn ahead " << m_starPaint->getRenderAhead()->getHits()
+                      << " missed " << m_starPaint->getRenderAhead()->getMisses() << std::endl;
         }
-        cleanUp(localDir, fileName);
+#       endif
     }
     else {
         m_drawingArea->update(now, pos);
     }
 }
 
-// remove any leftover files
 void
-StarWin::cleanUp(Glib::RefPtr<Gio::File>& dir, const std::string& keepName)
+StarWin::on_image_encoded(const EncodeResult& result)
 {
+    if (!result.error.empty()) {
+        std::cout << "The image " << result.path << " was not written " << result.error << "!" << std::endl;
+        m_imageOutput->setUnused(result.path);
+        return;
+    }
+    if (result.skipped) {
+        std::cout << "Image unchanged checked " << static_cast<int>(result.seconds * 1000.0) << "ms" << std::endl;
+        m_imageOutput->setUnused(result.path);
+        return;
+    }
+    std::cout << "Image encoded " << result.size << " bytes " << static_cast<int>(result.seconds * 1000.0) << "ms" << std::endl;
+    auto temp = Gio::File::create_for_path(result.path);
+    auto dbusChannel = getDaemonDbusChannel();
+    auto dbusProperty = getDaemonDbusProperty();
+    //std::cout << "dbusChannel " << dbusChannel << " dbusProperty " << dbusProperty << std::endl;
+    if (!dbusChannel.empty()
+     && !dbusProperty.empty()) {
+        m_xfconf.set(dbusChannel, dbusProperty, temp);
+    }
+    else {
+    // use exec
+        setBackgroundExec(temp);
+    }
+    m_imageOutput->setShown(result.path);
+}
+
+// remove the files left by previous versions, that used a new name for each update,
+//   and the partial files of a encoding that was interrupted
+void
+StarWin::cleanUp(Glib::RefPtr<Gio::File>& dir)
+{
+    ImageOutput output(dir->get_path(), IMAGE_PREFIX);
+    auto isLeftover = [&output] (const std::string& name) {
+        if (StringUtils::endsWith(name, ImageEncoder::TEMP_SUFFIX)) {
+            return true;
+        }
+        for (auto format : {ImageFormat::Png, ImageFormat::Qoi}) {
+            auto extension = ImageEncoder::getExtension(format);
+            if (StringUtils::endsWith(name, extension)) {
+                return !output.isSlot(name, extension);
+            }
+        }
+        return false;
+    };
     auto cancel = Gio::Cancellable::create();
     auto enumer = dir->enumerate_children(cancel);
     while (true) {
@@ -375,8 +534,7 @@ StarWin::cleanUp(Glib::RefPtr<Gio::File>& dir, const std::string& keepName)
         }
         if (fileInfo->get_file_type() == Gio::FileType::FILE_TYPE_REGULAR
          && StringUtils::startsWith(fileInfo->get_name(), IMAGE_PREFIX)
-         && StringUtils::endsWith(fileInfo->get_name(), ".png")
-         && fileInfo->get_name() != keepName) {
+         && isLeftover(fileInfo->get_name())) {
             auto file = dir->get_child(fileInfo->get_name());
             file->remove();
         }
@@ -565,6 +723,14 @@ StarWin::do_close()
 void
 StarWin::showMessage(const Glib::ustring& msg, Gtk::MessageType msgType)
 {
+    auto mainContext = Glib::MainContext::get_default();
+    if (!mainContext->is_owner()) {     // e.g. from the render worker
+        mainContext->invoke([this, msg, msgType] {
+            showMessage(msg, msgType);
+            return false;
+        });
+        return;
+    }
     Gtk::MessageDialog messagedialog(*this, msg, false, msgType);
     messagedialog.run();
     messagedialog.hide();
@@ -606,6 +772,27 @@ StarWin::setDaemonDisplay(int daemonDisplay)
     m_config->setInteger(StarPaint::MAIN_GRP, DAEMON_DISPLAY_KEY, daemonDisplay);
 }
 
+bool
+StarWin::isDaemon()
+{
+    return m_backAppl->isDaemon();
+}
+
+EncodeOptions
+StarWin::getEncodeOptions()
+{
+    EncodeOptions options;
+    options.format = ImageEncoder::parseFormat(m_config->getString(DAEMON_GRP, IMAGE_FORMAT_KEY, "png"));
+    options.compression = m_config->getInteger(DAEMON_GRP, IMAGE_COMPRESSION_KEY, -1);
+    return options;
+}
+
+bool
+StarWin::isImageAlpha()
+{
+    return m_config->getBoolean(DAEMON_GRP, IMAGE_ALPHA_KEY, true);
+}
+
 Glib::ustring
 StarWin::getDaemonDbusChannel()
 {
@@ -630,6 +817,7 @@ StarWin::exportPdf()
 
     JulianDate jd(now);
     try {
+        auto lock = m_starPaint->lock();
         HaruRenderer haruRenderer;
         Layout layout = haruRenderer.getLayout();
         auto screen = get_screen();
@@ -645,6 +833,7 @@ StarWin::exportPdf()
         haruRenderer.showText(infoTxt, layout.getXOffs(), layout.getYOffs() + (layout.getHeight() -  layout.getMin()) / 2.0, TextAlign::LeftBottom);
         haruRenderer.setInvertY(true);      // as we work with cairo coordinates from here on
         m_starPaint->drawSky(&haruRenderer, jd, pos, layout);
+        lock.unlock();
         ImageFileChooser file_chooser(*this, true, {"pdf"});
         if (file_chooser.run() == Gtk::ResponseType::RESPONSE_ACCEPT) {
             haruRenderer.save(file_chooser.get_file()->get_path());
@@ -20,8 +20,12 @@
 
 #include <gtkmm.h>
 #include <memory>
+#include <mutex>
 
 #include "GeoPosition.hpp"
+#include "UpdateScheduler.hpp"
+#include "ImageEncoder.hpp"
+#include "XfconfSetting.hpp"
 #include "background_config.h"
 
 class StarDraw;
@@ -31,6 +35,7 @@ class AppMenu;
 class StarPaint;
 class KeyConfig;
 class FileLoader;
+class ImageOutput;
 
 class StarWin
 : public Gtk::ApplicationWindow
@@ -65,15 +70,20 @@ public:
     {
         return m_fileLoader;
     }
+    // hold while changing settings, see StarPaint::lock
+    std::unique_lock<std::mutex> lockPaint();
     int getIntervalMinutes();
     void setIntervalMinutes(int intervalMinutes);
     int getDaemonDisplay();
     void setDaemonDisplay(int daemonDisplay);
+    bool isDaemon();
 
     GeoPosition getGeoPosition();
     void setGeoPosition(const GeoPosition& geoPos);
     void update();
     void update(Glib::DateTime dateTime, GeoPosition& pos);
+    // draw again e.g. for a late module or a loaded catalog, keeping the cached layers
+    void refresh();
     void on_menu_param();
     void on_menu_time();
     static std::shared_ptr<KeyConfig> createConfig();
@@ -84,14 +94,22 @@ protected:
     void setupConfig();
     bool updatePeriodic();
     void updateTimer();
+    void getImageSize(int& width, int& height);
+    void watchScreenSaver();
+    void on_screensaver_signal(const Glib::ustring& sender, const Glib::ustring& signal, const Glib::VariantContainerBase& params);
+    // no updates while the screen is not visible
+    bool isPaused();
+    double getUpdateThreshold();
     void cancel();
     void on_mount(Glib::RefPtr<Gio::AsyncResult>& result);
     void on_eject(Glib::RefPtr<Gio::AsyncResult>& result);
-    void cleanUp(Glib::RefPtr<Gio::File>&dir, const std::string& keepName);
+    void cleanUp(Glib::RefPtr<Gio::File>&dir);
+    void on_image_encoded(const EncodeResult& result);
+    EncodeOptions getEncodeOptions();
+    // without alpha the smaller rgb24 is written
+    bool isImageAlpha();
     void exportPdf();
     void setBackgroundExec(const Glib::RefPtr<Gio::File>& file);
-    // leave this as an option as these are xfce internals
-    void setBackgroundDbus(const Glib::ustring& dbusChannel, const Glib::ustring& dbusProperty, const Glib::RefPtr<Gio::File>& file);
     Glib::ustring getDaemonDbusProperty();
     Glib::ustring getDaemonDbusChannel();
     static constexpr auto IMAGE_PREFIX{"starDesk_"};
@@ -99,10 +117,19 @@ protected:
     static constexpr auto DESKTOP_BACKGR_IMAGE{"$img"};
     static constexpr auto DESKTOP_BACKGR_KEY{"desktopBackground"};
     static constexpr auto UPDATE_INTERVAL_KEY{"updateIntervalMinutes"};
+    static constexpr auto UPDATE_THRESHOLD_KEY{"updateThresholdPixel"};    // update if the sky moved this far, 0 use the interval
+    static constexpr auto UPDATE_THRESHOLD_DEFAULT{5.0};                   // pixel, about a minute on 4K, two on full hd
+    static constexpr auto MAX_ADAPTIVE_DELAY{3600.0};                       // seconds
+    static constexpr auto AHEAD_TOLERANCE{2.0};     // seconds a wake may be off the planned time to use the sky drawn ahead
+    static constexpr auto SCREENSAVER_NAME{"org.freedesktop.ScreenSaver"};
+    static constexpr auto SCREENSAVER_PATH{"/org/freedesktop/ScreenSaver"};
     static constexpr auto DAEMON_DISPLAY_KEY{"daemonDisplay"};
     static constexpr auto DAEMON_GRP{"daemon"};
     static constexpr auto DBUS_CHANNEL_KEY{"dbusChannel"};
     static constexpr auto DBUS_PROPERTY_KEY{"dbusProperty"};
+    static constexpr auto IMAGE_FORMAT_KEY{"imageFormat"};              // png or qoi
+    static constexpr auto IMAGE_COMPRESSION_KEY{"imageCompression"};    // png 0..9, -1 default
+    static constexpr auto IMAGE_ALPHA_KEY{"imageAlpha"};
     static constexpr auto GRP_GLGLOBE_MAIN{"globe"};
     static constexpr auto LATITUDE_KEY{"lat"};
     static constexpr auto LONGITUDE_KEY{"lon"};
@@ -123,6 +150,15 @@ private:
     GPid m_pid;
     std::shared_ptr<StarPaint> m_starPaint;
     bool m_updateBlocked{false};
+    UpdateScheduler m_scheduler;
+    UpdateScheduler::Reason m_nextReason{UpdateScheduler::Reason::Interval};
+    Glib::DateTime m_nextUpdate;
+    Glib::DateTime m_lastUpdate;    // the time of the last daemon image
+    Glib::RefPtr<Gio::DBus::Proxy> m_screenSaver;
+    bool m_screenSaverActive{false};
+    std::shared_ptr<ImageOutput> m_imageOutput;
+    XfconfSetting m_xfconf;
+    std::shared_ptr<ImageEncoder> m_imageEncoder;
 
 #   ifdef USE_APPMENU
     std::shared_ptr<AppMenu> m_appMenu;
@@ -27,6 +27,12 @@ Sun::Sun()
 
 std::shared_ptr<RaDec>
 Sun::position(const JulianDate& jd)
+{
+    return std::make_shared<RaDec>(raDec(jd));
+}
+
+RaDec
+Sun::raDec(const JulianDate& jd)
 {
 	double n = jd.toJulianDateE2000day();
 	double L = std::fmod((280.460 + 0.9856474 * n), 360.0);
@@ -45,6 +51,6 @@ Sun::position(const JulianDate& jd)
 	if (ra < 0.0) {
 	    ra += Math::TWO_PI;
 	}
-	return std::make_shared<RaDec>(ra, dec);
+	return RaDec(ra, dec);
 }
 
@@ -35,6 +35,8 @@ public:
     explicit Sun(const Sun& orig) = delete;
     virtual ~Sun() = default;
 
+    static RaDec raDec(const JulianDate& jd);
+    // compatibility, allocates
     static std::shared_ptr<RaDec> position(const JulianDate& jd);
 
 private:
@@ -35,10 +35,15 @@
 #include <cpuid.h>
 #endif
 #include <fstream>              // ifstream
+#include <sstream>
+#include <cstring>
+#include <dirent.h>
+#include <charconv>
+#include <array>
+#include <fcntl.h>
 #include <bitset>
 #include <gtkmm.h>
 
-#include "FileLoader.hpp"
 #include "SysInfo.hpp"
 
 // for windows the infos are sparse
@@ -376,6 +381,26 @@ SysInfo::memInfo()
 #pragma GCC diagnostic pop
 }
 
+// the first line of small files e.g. from /sys
+std::string
+SysInfo::readLine(const std::string& path)
+{
+#   ifdef __linux
+    std::array<char, 128> buf;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return "";
+    }
+    auto size = ::read(fd, buf.data(), buf.size());
+    close(fd);
+    if (size > 0) {
+        std::string_view text(buf.data(), static_cast<size_t>(size));
+        return std::string(text.substr(0, text.find('\n')));
+    }
+#   endif
+    return "";
+}
+
 std::string
 SysInfo::netInfo()
 {
@@ -389,31 +414,19 @@ SysInfo::netInfo()
 				&& strncmp(ent->d_name, "e", 1) == 0) {
    				std::ostringstream oss1;
 				auto path = Glib::ustring::sprintf("%s/%s/operstate", sdir, ent->d_name);
-                LineReader lineReader(Gio::File::create_for_path(path));
-                std::string updown;
-                if (lineReader.hasNext()) {
-                    lineReader.next(updown);
-                }
+                std::string updown = readLine(path);
                 if (updown == "up") {
                     path = Glib::ustring::sprintf("%s/%s/speed", sdir, ent->d_name);
-                    LineReader lineReader2(Gio::File::create_for_path(path));
                     unsigned int speed{};
                     char unit = 'M';
-                    if (lineReader2.hasNext()) {
-                        std::string speedd;
-                        lineReader2.next(speedd);
-                        speed = std::stoi(speedd);
-                        if (speed >= 1000) {
-                            speed /= 1000;
-                            unit = 'G';
-                        }
+                    auto speedd = readLine(path);
+                    std::from_chars(speedd.data(), speedd.data() + speedd.size(), speed);
+                    if (speed >= 1000) {
+                        speed /= 1000;
+                        unit = 'G';
                     }
                     path = Glib::ustring::sprintf("%s/%s/duplex", sdir, ent->d_name);
-                    LineReader lineReader3(Gio::File::create_for_path(path));
-                    std::string duplex;
-                    if (lineReader3.hasNext()) {
-                        lineReader3.next(duplex);
-                    }
+                    std::string duplex = readLine(path);
                     auto conn = netConn(ent->d_name);
                     oss1 << ent->d_name
                          << " " << speed << unit
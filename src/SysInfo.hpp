@@ -19,6 +19,7 @@
 #pragma once
 
 #include <string>
+#include <list>
 
 /**
  * this became mostly posix/linux specific
@@ -39,6 +40,7 @@ public:
     std::string netInfo();
 protected:
     std::string netConn(const std::string& netintf);
+    static std::string readLine(const std::string& path);
 
 private:
 };
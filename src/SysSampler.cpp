@@ -0,0 +1,361 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <charconv>
+#include <cctype>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "SysSampler.hpp"
+#include "SysInfo.hpp"
+
+static std::string_view
+nextLine(std::string_view& text)
+{
+    auto end = text.find('\n');
+    auto line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return line;
+}
+
+static std::string_view
+nextField(std::string_view& line)
+{
+    auto start = line.find_first_not_of(' ');
+    if (start == std::string_view::npos) {
+        line = std::string_view();
+        return line;
+    }
+    line.remove_prefix(start);
+    auto end = line.find(' ');
+    auto field = line.substr(0, end);
+    line.remove_prefix(end == std::string_view::npos ? line.size() : end);
+    return field;
+}
+
+static bool
+nextNumber(std::string_view& line, uint64_t& value)
+{
+    auto field = nextField(line);
+    return !field.empty()
+        && std::from_chars(field.data(), field.data() + field.size(), value).ec == std::errc();
+}
+
+SysSampler::SysSampler(uint32_t seconds)
+: m_seconds{std::max(seconds, 1u)}
+, m_buffer(BUFFER_SIZE)
+{
+    for (size_t i = 0; i < PATHS.size(); ++i) {
+#       ifdef __linux
+        m_fds[i] = open(PATHS[i], O_RDONLY | O_CLOEXEC);
+#       else
+        m_fds[i] = -1;
+#       endif
+    }
+    sample();   // a first snapshot, the rates follow with the next
+    m_thread = std::thread(&SysSampler::run, this);
+}
+
+SysSampler::~SysSampler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stop = true;
+    }
+    m_stopCondition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    for (auto fd : m_fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+std::shared_ptr<const SysSnapshot>
+SysSampler::getSnapshot()
+{
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    return m_snapshot;
+}
+
+void
+SysSampler::run()
+{
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    while (!m_stopCondition.wait_for(lock, m_seconds, [this] {
+            return m_stop;
+        })) {
+        lock.unlock();
+        sample();
+        lock.lock();
+    }
+}
+
+// the proc files are created on read, so reading from the start gives the current values
+std::string_view
+SysSampler::read(int fd)
+{
+    if (fd < 0) {
+        return std::string_view();
+    }
+    auto size = pread(fd, m_buffer.data(), m_buffer.size(), 0);
+    if (size <= 0) {
+        return std::string_view();
+    }
+    return std::string_view(m_buffer.data(), static_cast<size_t>(size));
+}
+
+void
+SysSampler::sample()
+{
+    auto snapshot = std::make_shared<SysSnapshot>();
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(now - m_sampled).count();
+    const bool first = m_sequence == 0u;
+    snapshot->sequence = ++m_sequence;
+    CpuTimes all;
+    if (parseStat(read(m_fds[Stat]), all, m_coresNow)) {
+        if (!first) {
+            snapshot->cpu = getUsage(m_all, all);
+            snapshot->cores.reserve(m_coresNow.size());
+            for (size_t i = 0; i < m_coresNow.size(); ++i) {
+                snapshot->cores.push_back(i < m_cores.size() ? getUsage(m_cores[i], m_coresNow[i]) : 0.0f);
+            }
+        }
+        m_all = all;
+        m_cores.swap(m_coresNow);
+    }
+    parseLoadavg(read(m_fds[Loadavg]), snapshot->load);
+    parseMeminfo(read(m_fds[Meminfo]), snapshot->memTotalKb, snapshot->memAvailableKb);
+    uint64_t diskRead{}, diskWritten{};
+    if (parseDiskstats(read(m_fds[Diskstats]), diskRead, diskWritten)) {
+        if (!first && elapsed > 0.0) {
+            snapshot->diskReadRate = static_cast<double>(diskRead - std::min(diskRead, m_diskRead)) / elapsed;
+            snapshot->diskWriteRate = static_cast<double>(diskWritten - std::min(diskWritten, m_diskWritten)) / elapsed;
+        }
+        m_diskRead = diskRead;
+        m_diskWritten = diskWritten;
+    }
+    uint64_t netRx{}, netTx{};
+    if (parseNetDev(read(m_fds[NetDev]), netRx, netTx)) {
+        if (!first && elapsed > 0.0) {
+            snapshot->netRxRate = static_cast<double>(netRx - std::min(netRx, m_netRx)) / elapsed;
+            snapshot->netTxRate = static_cast<double>(netTx - std::min(netTx, m_netTx)) / elapsed;
+        }
+        m_netRx = netRx;
+        m_netTx = netTx;
+    }
+    m_sampled = now;
+    if (first
+     || m_sequence % NET_INFO_SAMPLES == 0u) {
+        SysInfo sysInfo;
+        m_netInfo = sysInfo.netInfo();
+    }
+    snapshot->netInfo = m_netInfo;
+    if (!first) {
+        auto& entry = m_history[m_historyNext];
+        entry.cpu = snapshot->cpu;
+        entry.load = static_cast<float>(snapshot->load[0]);
+        entry.memory = snapshot->memTotalKb > 0u
+                     ? static_cast<float>(snapshot->memTotalKb - std::min(snapshot->memAvailableKb, snapshot->memTotalKb)) / static_cast<float>(snapshot->memTotalKb)
+                     : 0.0f;
+        entry.disk = static_cast<float>(snapshot->diskReadRate + snapshot->diskWriteRate);
+        entry.net = static_cast<float>(snapshot->netRxRate + snapshot->netTxRate);
+        m_historyNext = (m_historyNext + 1u) % HISTORY;
+        m_historyCount = std::min(m_historyCount + 1u, HISTORY);
+    }
+    snapshot->history.reserve(m_historyCount);
+    for (size_t i = 0; i < m_historyCount; ++i) {
+        snapshot->history.push_back(m_history[(m_historyNext + HISTORY - m_historyCount + i) % HISTORY]);
+    }
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    m_snapshot = std::move(snapshot);
+}
+
+float
+SysSampler::getUsage(const CpuTimes& previous, const CpuTimes& current)
+{
+    if (current.total <= previous.total) {
+        return 0.0f;
+    }
+    const auto busy = current.busy - std::min(current.busy, previous.busy);
+    return std::min(static_cast<float>(busy) / static_cast<float>(current.total - previous.total), 1.0f);
+}
+
+// cpu  user nice system idle iowait irq softirq steal guest guest_nice
+bool
+SysSampler::parseStat(std::string_view text, CpuTimes& all, std::vector<CpuTimes>& cores)
+{
+    size_t core{};
+    bool found{false};
+    while (!text.empty()) {
+        auto line = nextLine(text);
+        if (!line.starts_with("cpu")) {
+            if (found) {
+                break;      // the cpus come first
+            }
+            continue;
+        }
+        auto name = nextField(line);
+        CpuTimes times;
+        uint64_t value;
+        for (uint32_t field = 0; field < 8u && nextNumber(line, value); ++field) {
+            times.total += value;
+            if (field != 3u && field != 4u) {   // idle and iowait
+                times.busy += value;
+            }
+        }
+        if (name == "cpu") {
+            all = times;
+        }
+        else {
+            if (core >= cores.size()) {
+                cores.resize(core + 1u);
+            }
+            cores[core] = times;
+            ++core;
+        }
+        found = true;
+    }
+    cores.resize(core);
+    return found;
+}
+
+// 0.52 0.58 0.59 1/467 12345
+bool
+SysSampler::parseLoadavg(std::string_view text, std::array<double, 3>& load)
+{
+    for (auto& value : load) {
+        auto field = nextField(text);
+        if (field.empty()
+         || std::from_chars(field.data(), field.data() + field.size(), value).ec != std::errc()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// MemTotal:       16318780 kB
+bool
+SysSampler::parseMeminfo(std::string_view text, uint64_t& totalKb, uint64_t& availableKb)
+{
+    uint32_t readmask{};
+    while (!text.empty() && readmask != 0x03u) {
+        auto line = nextLine(text);
+        auto name = nextField(line);
+        if (name == "MemTotal:" && nextNumber(line, totalKb)) {
+            readmask |= 0x01u;
+        }
+        else if (name == "MemAvailable:" && nextNumber(line, availableKb)) {
+            readmask |= 0x02u;
+        }
+    }
+    return readmask == 0x03u;
+}
+
+static bool
+isDisk(std::string_view name)
+{
+    for (auto virt : {"loop", "ram", "zram", "dm-", "md", "sr", "fd", "nbd"}) {
+        if (name.starts_with(virt)) {
+            return false;
+        }
+    }
+    if (name.starts_with("mmcblk")
+     && (name.find("boot") != std::string_view::npos
+      || name.find("rpmb") != std::string_view::npos)) {
+        return false;   // the hardware partitions mmcblk0boot0, mmcblk0rpmb
+    }
+    if (name.starts_with("nvme") || name.starts_with("mmcblk")) {   // nvme0n1p2, mmcblk0p1
+        auto part = name.rfind('p');
+        return part == std::string_view::npos
+            || part == 0u
+            || !std::isdigit(static_cast<unsigned char>(name[part - 1u]))
+            || part + 1u >= name.size();
+    }
+    return name.empty() || !std::isdigit(static_cast<unsigned char>(name.back()));   // sda2
+}
+
+//   8       0 sda 1234 0 56789 ...  sectors read is the 3rd, written the 7th value
+bool
+SysSampler::parseDiskstats(std::string_view text, uint64_t& readBytes, uint64_t& writtenBytes)
+{
+    constexpr uint64_t SECTOR_SIZE{512u};   // the kernel unit, independent of the device
+    bool found{false};
+    readBytes = 0u;
+    writtenBytes = 0u;
+    while (!text.empty()) {
+        auto line = nextLine(text);
+        uint64_t major, minor;
+        if (!nextNumber(line, major)
+         || !nextNumber(line, minor)) {
+            continue;
+        }
+        auto name = nextField(line);
+        if (!isDisk(name)) {
+            continue;
+        }
+        std::array<uint64_t, 7> values;
+        bool complete{true};
+        for (auto& value : values) {
+            complete &= nextNumber(line, value);
+        }
+        if (complete) {
+            readBytes += values[2] * SECTOR_SIZE;
+            writtenBytes += values[6] * SECTOR_SIZE;
+            found = true;
+        }
+    }
+    return found;
+}
+
+//  eth0: 1234 12 0 0 0 0 0 0 5678 ...  received bytes is the 1st, sent the 9th value
+bool
+SysSampler::parseNetDev(std::string_view text, uint64_t& rxBytes, uint64_t& txBytes)
+{
+    bool found{false};
+    rxBytes = 0u;
+    txBytes = 0u;
+    while (!text.empty()) {
+        auto line = nextLine(text);
+        auto colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;   // header
+        }
+        auto name = line.substr(0, colon);
+        name.remove_prefix(std::min(name.find_first_not_of(' '), name.size()));
+        if (name == "lo") {
+            continue;
+        }
+        line.remove_prefix(colon + 1u);
+        std::array<uint64_t, 9> values;
+        bool complete{true};
+        for (auto& value : values) {
+            complete &= nextNumber(line, value);
+        }
+        if (complete) {
+            rxBytes += values[0];
+            txBytes += values[8];
+            found = true;
+        }
+    }
+    return found;
+}
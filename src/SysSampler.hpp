@@ -0,0 +1,137 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+struct CpuTimes
+{
+    uint64_t busy{};
+    uint64_t total{};
+};
+
+// one entry of the history
+struct SysSample
+{
+    float cpu{};        // 0..1 of all cores
+    float load{};       // the 1 minute average
+    float memory{};     // 0..1 used
+    float disk{};       // bytes per second read + written
+    float net{};        // bytes per second received + sent
+};
+
+// the values are never changed once published
+struct SysSnapshot
+{
+    uint64_t sequence{};                // counts the samples
+    std::array<double, 3> load{};       // 1, 5, 15 minutes
+    float cpu{};
+    std::vector<float> cores;           // 0..1 each
+    uint64_t memTotalKb{};
+    uint64_t memAvailableKb{};
+    double diskReadRate{};              // bytes per second
+    double diskWriteRate{};
+    double netRxRate{};
+    double netTxRate{};
+    std::vector<SysSample> history;     // the oldest first
+    std::string netInfo;
+};
+
+/**
+ * samples the system load on its own thread,
+ *   so rendering only takes the latest snapshot without any i/o.
+ *   The /proc files are kept open and read with pread into a fixed buffer.
+ *   This is linux specific, other systems get empty snapshots.
+ */
+class SysSampler
+{
+public:
+    SysSampler(uint32_t seconds);
+    explicit SysSampler(const SysSampler& orig) = delete;
+    virtual ~SysSampler();
+
+    std::shared_ptr<const SysSnapshot> getSnapshot();
+    static constexpr size_t HISTORY{120u};
+    static constexpr uint64_t NET_INFO_SAMPLES{12u};   // the addresses rarely change, looked up every this samples
+
+    // parse the content of the /proc files, without allocation except for new cores
+    static bool parseStat(std::string_view text, CpuTimes& all, std::vector<CpuTimes>& cores);
+    static bool parseLoadavg(std::string_view text, std::array<double, 3>& load);
+    static bool parseMeminfo(std::string_view text, uint64_t& totalKb, uint64_t& availableKb);
+    // the sum of the disks, partitions and virtual devices are skipped
+    static bool parseDiskstats(std::string_view text, uint64_t& readBytes, uint64_t& writtenBytes);
+    // the sum of the interfaces, loopback is skipped
+    static bool parseNetDev(std::string_view text, uint64_t& rxBytes, uint64_t& txBytes);
+    static float getUsage(const CpuTimes& previous, const CpuTimes& current);
+
+protected:
+    void run();
+    void sample();
+    std::string_view read(int fd);
+
+private:
+    enum Source
+    {
+          Stat
+        , Loadavg
+        , Meminfo
+        , Diskstats
+        , NetDev
+        , SOURCES
+    };
+    static constexpr std::array<const char*, SOURCES> PATHS{
+          "/proc/stat"
+        , "/proc/loadavg"
+        , "/proc/meminfo"
+        , "/proc/diskstats"
+        , "/proc/net/dev"};
+    static constexpr size_t BUFFER_SIZE{64u * 1024u};  // the stat for many cores needs some space
+    const std::chrono::seconds m_seconds;
+    std::array<int, SOURCES> m_fds;
+    std::vector<char> m_buffer;
+    // the previous values, used by the sampler only
+    CpuTimes m_all;
+    std::vector<CpuTimes> m_cores;
+    std::vector<CpuTimes> m_coresNow;
+    uint64_t m_diskRead{};
+    uint64_t m_diskWritten{};
+    uint64_t m_netRx{};
+    uint64_t m_netTx{};
+    std::chrono::steady_clock::time_point m_sampled;
+    uint64_t m_sequence{};
+    std::string m_netInfo;
+    std::array<SysSample, HISTORY> m_history{};
+    size_t m_historyNext{};
+    size_t m_historyCount{};
+    std::mutex m_snapshotMutex;
+    std::shared_ptr<const SysSnapshot> m_snapshot;
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition;
+    bool m_stop{false};
+    std::thread m_thread;               // last, started with all members ready
+};
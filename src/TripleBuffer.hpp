@@ -0,0 +1,67 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * hands the newest value from one producer thread to one consumer thread
+ *   without locking. Each side owns one slot, the third is the latest,
+ *   they are exchanged with it by a atomic swap, so neither waits
+ *   and a value is never seen while it is written.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const TripleBuffer& orig) = delete;
+    virtual ~TripleBuffer() = default;
+
+    // the slot to fill, use from the producer only
+    T& getBack()
+    {
+        return m_slots[m_back];
+    }
+    // makes the back slot the latest, continues with the previous latest
+    //   (or the one the consumer returned)
+    void publish()
+    {
+        m_back = m_latest.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+    // the newest published value, use from the consumer only
+    T& getFront()
+    {
+        if ((m_latest.load(std::memory_order_relaxed) & FRESH) != 0u) {
+            m_front = m_latest.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return m_slots[m_front];
+    }
+
+private:
+    static constexpr uint32_t FRESH{4u};    // set with the index of m_latest if it was not yet taken
+    static constexpr uint32_t INDEX_MASK{3u};
+    std::array<T, 3> m_slots{};
+    std::atomic<uint32_t> m_latest{0u};
+    uint32_t m_back{1u};
+    uint32_t m_front{2u};
+};
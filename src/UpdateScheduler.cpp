@@ -0,0 +1,102 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "UpdateScheduler.hpp"
+#include "Math.hpp"
+
+double
+UpdateScheduler::getSkySpeed(double radius)
+{
+    return radius * Math::TWO_PI / SIDEREAL_DAY;
+}
+
+void
+UpdateScheduler::setThreshold(double pixel)
+{
+    m_threshold = pixel;
+}
+
+double
+UpdateScheduler::getThreshold() const
+{
+    return m_threshold;
+}
+
+void
+UpdateScheduler::setMaxDelay(double seconds)
+{
+    m_maxDelay = std::max(seconds, MIN_DELAY);
+}
+
+void
+UpdateScheduler::setCadence(uint32_t seconds)
+{
+    m_cadence = seconds;
+}
+
+double
+UpdateScheduler::getDelay(double now, double utcOffset, double radius, Reason& reason) const
+{
+    reason = Reason::Interval;
+    double delay = m_maxDelay;
+    const double speed = getSkySpeed(radius);
+    if (m_threshold > 0.0 && speed > 0.0) {
+        const double skyDelay = m_threshold / speed;
+        if (skyDelay < delay) {
+            delay = skyDelay;
+            reason = Reason::Sky;
+        }
+    }
+    if (m_cadence > 0u) {
+        // aligned to the local time e.g. the clock changes on the minute
+        const double cadence = static_cast<double>(m_cadence);
+        const double local = now + utcOffset;
+        const double cadenceDelay = (std::floor(local / cadence) + 1.0) * cadence - local + CADENCE_MARGIN;
+        if (cadenceDelay <= delay) {
+            delay = cadenceDelay;
+            reason = Reason::Cadence;
+        }
+    }
+    return std::max(delay, MIN_DELAY);
+}
+
+void
+UpdateScheduler::countWake(Reason reason, bool paused)
+{
+    if (paused) {
+        ++m_paused;
+    }
+    else {
+        ++m_wakes[static_cast<size_t>(reason)];
+    }
+}
+
+uint64_t
+UpdateScheduler::getWakes(Reason reason) const
+{
+    return m_wakes[static_cast<size_t>(reason)];
+}
+
+uint64_t
+UpdateScheduler::getPaused() const
+{
+    return m_paused;
+}
@@ -0,0 +1,71 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+
+/**
+ * decides when the next update is worth it.
+ *   The sky turns once a sidereal day, with the stereographic projection
+ *   the horizon moves fastest with radius * omega pixel per second,
+ *   so the sky needs a update when that reaches the threshold.
+ *   The modules may require updates at their cadence (e.g. the clock each minute)
+ *   and the max delay gives the upper limit.
+ *   All times are seconds (unix time, the offset of the local time for aligning).
+ */
+class UpdateScheduler
+{
+public:
+    UpdateScheduler() = default;
+    explicit UpdateScheduler(const UpdateScheduler& orig) = delete;
+    virtual ~UpdateScheduler() = default;
+
+    enum class Reason : uint32_t
+    {
+          Sky
+        , Cadence
+        , Interval
+    };
+    static constexpr auto SIDEREAL_DAY{86164.0905};    // seconds
+    static constexpr auto MIN_DELAY{1.0};               // seconds, keep some distance
+    static constexpr auto CADENCE_MARGIN{0.02};         // seconds, be sure to be past the change
+
+    // the pixel per second the sky moves at most for the given radius
+    static double getSkySpeed(double radius);
+    void setThreshold(double pixel);
+    double getThreshold() const;
+    void setMaxDelay(double seconds);
+    // the shortest cadence of the shown modules, 0 for none
+    void setCadence(uint32_t seconds);
+    // the seconds from now until the next update
+    double getDelay(double now, double utcOffset, double radius, Reason& reason) const;
+
+    // count the updates made and skipped (e.g. while locked)
+    void countWake(Reason reason, bool paused);
+    uint64_t getWakes(Reason reason) const;
+    uint64_t getPaused() const;
+
+private:
+    double m_threshold{};       // 0 only the cadence and max delay
+    double m_maxDelay{60.0};
+    uint32_t m_cadence{};
+    std::array<uint64_t, 3> m_wakes{};
+    uint64_t m_paused{};
+};
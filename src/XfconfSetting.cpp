@@ -0,0 +1,75 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+
+#include "XfconfSetting.hpp"
+
+void
+XfconfSetting::set(const Glib::ustring& channel, const Glib::ustring& property, const Glib::RefPtr<Gio::File>& file)
+{
+    if (m_failed) {
+        m_signalFailed.emit(file);
+        return;
+    }
+    if (!m_xfconf) {
+        const bool connecting = static_cast<bool>(m_pending);
+        m_pending = file;     // only the newest is of interest
+        if (!connecting) {
+            Gio::DBus::Proxy::create_for_bus(Gio::DBus::BusType::BUS_TYPE_SESSION
+                , XFCONF_NAME, XFCONF_PATH, XFCONF_NAME
+                , [this, channel, property] (Glib::RefPtr<Gio::AsyncResult>& result) {
+                try {
+                    m_xfconf = Gio::DBus::Proxy::create_for_bus_finish(result);
+                }
+                catch (const Glib::Error& exc) {
+                    std::cout << "No dbus for " << XFCONF_NAME << " using exec " << exc.what() << std::endl;
+                    m_failed = true;
+                }
+                auto pending = m_pending;
+                m_pending.reset();
+                set(channel, property, pending);
+            }
+            , Glib::RefPtr<Gio::DBus::InterfaceInfo>()
+            , Gio::DBus::ProxyFlags::PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES | Gio::DBus::ProxyFlags::PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS);
+        }
+        return;
+    }
+    auto value = Glib::Variant<Glib::VariantBase>::create(Glib::Variant<Glib::ustring>::create(file->get_path()));
+    auto params = Glib::VariantContainerBase::create_tuple(std::vector<Glib::VariantBase>{
+          Glib::Variant<Glib::ustring>::create(channel)
+        , Glib::Variant<Glib::ustring>::create(property)
+        , value});
+    m_xfconf->call("SetProperty", [this, file] (Glib::RefPtr<Gio::AsyncResult>& result) {
+        try {
+            m_xfconf->call_finish(result);
+        }
+        catch (const Glib::Error& exc) {
+            std::cout << "Setting the background with dbus failed " << exc.what() << " using exec" << std::endl;
+            m_signalFailed.emit(file);
+        }
+    }
+    , params
+    , DBUS_TIMEOUT_MS);
+}
+
+sigc::signal<void(const Glib::RefPtr<Gio::File>&)>
+XfconfSetting::signal_failed()
+{
+    return m_signalFailed;
+}
@@ -0,0 +1,51 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtkmm.h>
+
+/**
+ * sets a xfconf property e.g. the background of xfce4-desktop with dbus,
+ *   leave this as an option as these are xfce internals.
+ *   The proxy is created on first use and kept, so we connect once,
+ *   a file arriving while connecting replaces the pending one.
+ *   If there is no bus or the call fails the file is signaled as failed,
+ *   so the command can be used instead.
+ */
+class XfconfSetting
+{
+public:
+    XfconfSetting() = default;
+    explicit XfconfSetting(const XfconfSetting& orig) = delete;
+    virtual ~XfconfSetting() = default;
+
+    void set(const Glib::ustring& channel, const Glib::ustring& property, const Glib::RefPtr<Gio::File>& file);
+    // emitted on the main thread for a file that was not set with dbus
+    sigc::signal<void(const Glib::RefPtr<Gio::File>&)> signal_failed();
+
+    static constexpr auto XFCONF_NAME{"org.xfce.Xfconf"};
+    static constexpr auto XFCONF_PATH{"/org/xfce/Xfconf"};
+    static constexpr auto DBUS_TIMEOUT_MS{2000};
+
+private:
+    Glib::RefPtr<Gio::DBus::Proxy> m_xfconf;
+    Glib::RefPtr<Gio::File> m_pending;      // waiting for the proxy
+    bool m_failed{false};
+    sigc::signal<void(const Glib::RefPtr<Gio::File>&)> m_signalFailed;
+};
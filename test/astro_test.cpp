@@ -19,6 +19,19 @@
 #include <memory>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <new>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <filesystem>
+#include <array>
+#include <csignal>
 #include <StringUtils.hpp>
 #include <psc_format.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -28,14 +41,58 @@
 #include "JulianDate.hpp"
 #include "GeoPosition.hpp"
 #include "RaDec.hpp"
+#include "Point2D.hpp"
 #include "Math.hpp"
 #include "Planets.hpp"
 #include "MessierLoader.hpp"
 #include "FileLoader.hpp"
 #include "Moon.hpp"
+#include "Sun.hpp"
 #include "Phase.hpp"
+#include "HorizonMatrix.hpp"
+#include "CatalogFile.hpp"
+#include "StarTiles.hpp"
+#include "SkyIndex.hpp"
+#include "PolylineStore.hpp"
+#include "SpriteAtlas.hpp"
+#include "Rasterizer.hpp"
+#include "RecordingRenderer.hpp"
+#include "BandPool.hpp"
+#include "UpdateScheduler.hpp"
+#include "ImageEncoder.hpp"
+#include "ImageOutput.hpp"
+#include "XfconfSetting.hpp"
+#include "Compositor.hpp"
+#include "SysSampler.hpp"
+#include "ModuleWorker.hpp"
+#include "TripleBuffer.hpp"
 //#include "HaruRenderer.hpp"
 
+// count the allocations, to check the drawing path is allocation free
+static std::atomic<size_t> allocations{0};
+
+void*
+operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
 static constexpr auto expAz = 155.96;
 static constexpr auto expAlt = 69.0103;
 static constexpr auto raExp = 2.09998;
@@ -241,6 +298,604 @@ test_moon()
     return true;
 }
 
+static bool
+test_horizonMatrix()
+{
+    constexpr size_t count{10000};
+    JulianDate jd{2459349.210248739};
+    GeoPosition geoPos{274.236400, 38.2464000};
+    Layout layout{1920, 1080};
+    std::mt19937 gen{4711};
+    std::uniform_real_distribution<double> raDist{0.0, Math::TWO_PI};
+    std::uniform_real_distribution<double> decDist{-Math::PI / 2.0, Math::PI / 2.0};
+    std::vector<std::shared_ptr<RaDec>> raDecs;
+    UnitVectors vectors;
+    for (size_t i = 0; i < count; ++i) {
+        auto raDec = std::make_shared<RaDec>(raDist(gen), decDist(gen));
+        raDecs.push_back(raDec);
+        vectors.add(*raDec);
+    }
+    std::vector<double> x(count), y(count), z(count);
+    HorizonMatrix horizon(geoPos, jd);
+    horizon.toScreen(vectors, layout, x, y, z);
+    for (size_t i = 0; i < count; ++i) {
+        auto azAlt = geoPos.toAzimutAltitude(raDecs[i], jd);
+        if (std::abs(std::sin(azAlt->getAltitude()) - z[i]) > numLowError) {
+            std::cout << "horizon z " << z[i] << " exp " << std::sin(azAlt->getAltitude()) << std::endl;
+            return false;
+        }
+        if (azAlt->isVisible()) {
+            auto p = azAlt->toScreen(layout);
+            if (std::abs(p.getX() - x[i]) > numHighError
+             || std::abs(p.getY() - y[i]) > numHighError) {
+                std::cout << "horizon x " << x[i] << " y " << y[i]
+                          << " exp x " << p.getX() << " y " << p.getY() << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// write, map and project quantized positions
+static bool
+test_catalog()
+{
+    constexpr size_t count{1000};
+    JulianDate jd{2459349.210248739};
+    GeoPosition geoPos{274.236400, 38.2464000};
+    Layout layout{1920, 1080};
+    std::mt19937 gen{4711};
+    std::uniform_real_distribution<double> raDist{0.0, Math::TWO_PI};
+    std::uniform_real_distribution<double> decDist{-Math::PI / 2.0, Math::PI / 2.0};
+    UnitVectors vectors;
+    std::vector<int16_t> qx, qy, qz, vmag;
+    for (size_t i = 0; i < count; ++i) {
+        vectors.add(raDist(gen), decDist(gen));
+        qx.push_back(UnitVectors::quantize(vectors.getX()[i]));
+        qy.push_back(UnitVectors::quantize(vectors.getY()[i]));
+        qz.push_back(UnitVectors::quantize(vectors.getZ()[i]));
+        vmag.push_back(CatalogFile::quantizeMagnitude(static_cast<double>(i) / 100.0));
+    }
+    auto fileName = Glib::canonicalize_filename("catalog_test.bgcat", Glib::get_current_dir());
+    CatalogWriter writer;
+    writer.add<int16_t>(CatalogSectionType::StarX, qx);
+    writer.add<int16_t>(CatalogSectionType::StarY, qy);
+    writer.add<int16_t>(CatalogSectionType::StarZ, qz);
+    writer.add<int16_t>(CatalogSectionType::StarVmag, vmag);
+    if (!writer.write(fileName)) {
+        return false;
+    }
+    bool ret = true;
+    {
+        CatalogFile catalog;
+        if (!catalog.map(fileName)) {
+            ret = false;
+        }
+        auto x = catalog.getSection<int16_t>(CatalogSectionType::StarX);
+        auto y = catalog.getSection<int16_t>(CatalogSectionType::StarY);
+        auto z = catalog.getSection<int16_t>(CatalogSectionType::StarZ);
+        auto mag = catalog.getSection<int16_t>(CatalogSectionType::StarVmag);
+        if (x.size() != count
+         || catalog.getSection<int32_t>(CatalogSectionType::StarX).size() != 0u       // wrong record size
+         || catalog.getSection<int16_t>(CatalogSectionType::MilkywayX).size() != 0u
+         || std::abs(CatalogFile::toMagnitude(mag[count - 1]) - 9.99) > numLowError) {
+            std::cout << "catalog unexpected sections " << x.size() << std::endl;
+            ret = false;
+        }
+        if (ret) {
+            UnitVectors quantized;
+            quantized.setQuantized(x, y, z);
+            HorizonMatrix horizon(geoPos, jd);
+            std::vector<double> sx(count), sy(count), sz(count);
+            std::vector<double> qsx(count), qsy(count), qsz(count);
+            horizon.toScreen(vectors, layout, sx, sy, sz);
+            horizon.toScreen(quantized, layout, qsx, qsy, qsz);
+            for (size_t i = 0; i < count; ++i) {
+                if (sz[i] >= 0.0
+                 && (std::abs(sx[i] - qsx[i]) > numHighestError
+                  || std::abs(sy[i] - qsy[i]) > numHighestError)) {
+                    std::cout << "catalog x " << qsx[i] << " y " << qsy[i]
+                              << " exp x " << sx[i] << " y " << sy[i] << std::endl;
+                    ret = false;
+                    break;
+                }
+            }
+        }
+        if (ret
+         && (!catalog.map(fileName)        // mapped again, replacing the first
+          || catalog.getSection<int16_t>(CatalogSectionType::StarX).size() != count)) {
+            std::cout << "catalog remap" << std::endl;
+            ret = false;
+        }
+    }
+    if (ret) {
+        // a count that wraps the section size to 0 is not accepted
+        std::fstream file(fileName, std::ios::in | std::ios::out | std::ios::binary);
+        CatalogSection section{};
+        file.seekg(sizeof(CatalogHeader));
+        file.read(reinterpret_cast<char*>(&section), sizeof(section));
+        section.count = std::numeric_limits<uint64_t>::max() / section.recordSize + 1u;
+        file.seekp(sizeof(CatalogHeader));
+        file.write(reinterpret_cast<const char*>(&section), sizeof(section));
+        file.close();
+        CatalogFile catalog;
+        if (catalog.map(fileName)
+         || catalog.getSection<int16_t>(CatalogSectionType::StarY).size() != 0u) {
+            std::cout << "catalog wrapped section accepted" << std::endl;
+            ret = false;
+        }
+    }
+    std::remove(fileName.c_str());
+    return ret;
+}
+
+// every star above the horizon has to be in a visible tile
+static bool
+test_tiles()
+{
+    constexpr size_t count{20000};
+    JulianDate jd{2459349.210248739};
+    GeoPosition geoPos{274.236400, 38.2464000};
+    std::mt19937 gen{4711};
+    std::uniform_real_distribution<double> raDist{0.0, Math::TWO_PI};
+    std::uniform_real_distribution<double> sinDecDist{-1.0, 1.0};
+    std::uniform_real_distribution<double> magDist{-1.0, 12.0};
+    std::vector<CatalogStar> stars;
+    for (size_t i = 0; i < count; ++i) {
+        stars.push_back(CatalogStar{raDist(gen), std::asin(sinDecDist(gen)), magDist(gen), static_cast<int32_t>(i)});
+    }
+    auto tiles = StarTiles::build(stars);
+    HorizonMatrix horizon(geoPos, jd);
+    size_t sum{}, visibleTiles{};
+    for (auto& tile : tiles) {
+        if (tile.first != sum) {
+            std::cout << "tiles not contiguous " << tile.first << " exp " << sum << std::endl;
+            return false;
+        }
+        sum += tile.count;
+        const bool visible = StarTiles::isVisible(tile, horizon);
+        if (visible) {
+            ++visibleTiles;
+        }
+        for (size_t i = tile.first; i < tile.first + tile.count; ++i) {
+            if (i > tile.first
+             && stars[i].vmag < stars[i - 1].vmag) {
+                std::cout << "tile not sorted at " << i << std::endl;
+                return false;
+            }
+            const double cosDec = std::cos(stars[i].dec);
+            double x, y, z;
+            horizon.toHorizon(cosDec * std::cos(stars[i].ra), cosDec * std::sin(stars[i].ra), std::sin(stars[i].dec), x, y, z);
+            if (z >= 0.0 && !visible) {
+                std::cout << "star " << i << " z " << z << " in invisible tile" << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "tiles " << tiles.size() << " visible " << visibleTiles << std::endl;
+    return sum == count;
+}
+
+// each polyline with a point above the horizon has to be found
+static bool
+test_skyIndex()
+{
+    constexpr uint32_t count{500};
+    JulianDate jd{2459349.210248739};
+    GeoPosition geoPos{274.236400, 38.2464000};
+    std::mt19937 gen{4712};
+    std::uniform_real_distribution<double> raDist{0.0, Math::TWO_PI};
+    std::uniform_real_distribution<double> sinDecDist{-1.0, 1.0};
+    std::uniform_real_distribution<double> stepDist{-0.1, 0.1};
+    std::vector<UnitVectors> lines(count);
+    SkyIndex index;
+    for (uint32_t i = 0; i < count; ++i) {
+        double ra = raDist(gen);
+        double dec = std::asin(sinDecDist(gen));
+        for (uint32_t p = 0; p < 5; ++p) {
+            lines[i].add(ra, dec);
+            ra += stepDist(gen);
+            dec = std::clamp(dec + stepDist(gen), -Math::HALF_PI, Math::HALF_PI);
+        }
+        index.add(i, lines[i]);
+    }
+    HorizonMatrix horizon(geoPos, jd);
+    std::vector<uint8_t> visible;
+    index.query(horizon, 0.0, visible);
+    if (visible.size() != count) {
+        std::cout << "index size " << visible.size() << " exp " << count << std::endl;
+        return false;
+    }
+    uint32_t visibleCount{};
+    for (uint32_t i = 0; i < count; ++i) {
+        bool above = false;
+        for (size_t p = 0; p < lines[i].size(); ++p) {
+            double x, y, z;
+            horizon.toHorizon(lines[i].getX()[p], lines[i].getY()[p], lines[i].getZ()[p], x, y, z);
+            above |= z >= 0.0;
+        }
+        if (above && !visible[i]) {
+            std::cout << "line " << i << " above horizon not in index" << std::endl;
+            return false;
+        }
+        if (visible[i]) {
+            ++visibleCount;
+        }
+    }
+    std::cout << "index cells " << SkyIndex::getCellCount() << " visible " << visibleCount << " of " << count << std::endl;
+    // about half should be culled
+    return visibleCount < count * 3 / 4;
+}
+
+// the packed polylines shall give the same vertices as the single ones
+static bool
+test_polylineStore()
+{
+    std::mt19937 gen{4714};
+    std::uniform_real_distribution<double> raDist{0.0, Math::TWO_PI};
+    std::uniform_real_distribution<double> decDist{-Math::HALF_PI, Math::HALF_PI};
+    std::vector<UnitVectors> lines(20);
+    PolylineStore store;
+    for (uint32_t l = 0; l < lines.size(); ++l) {
+        for (uint32_t p = 0; p < l + 2u; ++p) {
+            lines[l].add(raDist(gen), decDist(gen));
+        }
+        store.add(lines[l], static_cast<int32_t>(l), l / 4u);
+    }
+    if (store.size() != lines.size()) {
+        std::cout << "store size " << store.size() << " exp " << lines.size() << std::endl;
+        return false;
+    }
+    const auto& vertices = store.getVertices();
+    for (uint32_t l = 0; l < lines.size(); ++l) {
+        const auto& line = store.getLine(l);
+        if (line.count != lines[l].size()
+         || line.value != static_cast<int32_t>(l)
+         || line.group != l / 4u) {
+            std::cout << "store line " << l << " unexpected info" << std::endl;
+            return false;
+        }
+        for (size_t p = 0; p < line.count; ++p) {
+            if (vertices.getX()[line.first + p] != lines[l].getX()[p]
+             || vertices.getZ()[line.first + p] != lines[l].getZ()[p]) {
+                std::cout << "store line " << l << " vertex " << p << " differs" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// after warm-up the per object computations of drawSky shall not allocate
+static bool
+test_allocation()
+{
+    constexpr size_t count{2000};
+    JulianDate jd{2459349.210248739};
+    GeoPosition geoPos{274.236400, 38.2464000};
+    Layout layout{1920, 1080};
+    Planets planets;
+    std::mt19937 gen{4713};
+    std::uniform_real_distribution<double> raDist{0.0, Math::TWO_PI};
+    std::uniform_real_distribution<double> sinDecDist{-1.0, 1.0};
+    std::vector<RaDec> raDecs;
+    UnitVectors vectors;
+    for (size_t i = 0; i < count; ++i) {
+        raDecs.emplace_back(raDist(gen), std::asin(sinDecDist(gen)));
+        vectors.add(raDecs.back());
+    }
+    std::vector<double> x(count), y(count), z(count);
+    // the messier labels, longer than the short string optimization
+    const std::vector<Glib::ustring> names{"M31 Andromeda Galaxy", "M42 Great Orion Nebula", "M45 Pleiades"};
+    PointClusters clusters;
+    double sum{};
+    size_t allocated{};
+    for (uint32_t frame = 0; frame < 3; ++frame) {
+        const size_t before = allocations;
+        HorizonMatrix horizon(geoPos, jd);
+        horizon.toScreen(vectors, layout, x, y, z);
+        clusters.clear();
+        for (size_t i = 0; i < raDecs.size(); ++i) {
+            auto azAlt = geoPos.toAzimutAltitude(raDecs[i], jd);
+            if (azAlt.isVisible()) {
+                auto p = azAlt.toScreen(layout);
+                sum += p.getX();
+                if (i < 200u) {     // as draw_messier
+                    clusters.add(MagPoint(p, 5.0), names[i % names.size()], 100.0);
+                }
+            }
+        }
+        for (uint32_t first = 0; first < clusters.size(); ++first) {
+            if (clusters.isFirst(first)) {
+                sum += static_cast<double>(clusters.getName(first).size());
+            }
+        }
+        for (auto& planet : planets.getOtherPlanets()) {
+            sum += geoPos.toAzimutAltitude(planet->raDec(jd), jd).getAltitude();
+        }
+        sum += geoPos.toAzimutAltitude(Sun::raDec(jd), jd).getAltitude();
+        sum += geoPos.toAzimutAltitude(Moon::raDec(jd), jd).getAltitude();
+        if (frame > 0) {    // the first frame may setup e.g. planets
+            allocated += allocations - before;
+        }
+    }
+    std::cout << "allocations " << allocated << " sum " << sum << " clusters " << clusters.size() << std::endl;
+    PointClusters near;
+    near.add(MagPoint(Point2D(10.0, 10.0), 1.0), names[0], 20.0);
+    near.add(MagPoint(Point2D(50.0, 10.0), 2.0), names[1], 20.0);
+    near.add(MagPoint(Point2D(25.0, 10.0), 3.0), names[2], 20.0);
+    if (near.getName(0u) != "M31 Andromeda Galaxy, M45 Pleiades"
+     || !near.isFirst(1u)
+     || near.getCluster(2u) != 0u) {
+        std::cout << "clusters " << near.getName(0u) << std::endl;
+        return false;
+    }
+    return allocated == 0;
+}
+
+// sum of the mask in pixel
+static double
+coverage(const Cairo::RefPtr<Cairo::ImageSurface>& sprite)
+{
+    double sum{};
+    const auto data = sprite->get_data();
+    for (int y = 0; y < sprite->get_height(); ++y) {
+        for (int x = 0; x < sprite->get_width(); ++x) {
+            sum += static_cast<double>(data[y * sprite->get_stride() + x]) / 255.0;
+        }
+    }
+    return sum;
+}
+
+static bool
+test_spriteAtlas()
+{
+    SpriteAtlas atlas;
+    atlas.setSize(1920, 1080);
+    int left{}, top{};
+    constexpr auto r{3.0};
+    auto disc = atlas.getDisc(100.25, 50.0, r, left, top);
+    auto area = coverage(disc);
+    if (std::abs(area - Math::PI * r * r) > 0.5) {
+        std::cout << "sprite disc area " << area << " exp " << Math::PI * r * r << std::endl;
+        return false;
+    }
+    // the center x + 0.25 is at the origin of the sprite
+    if (left != 100 - 4 || top != 50 - 4) {
+        std::cout << "sprite disc pos " << left << "," << top << std::endl;
+        return false;
+    }
+    // same radius and sub-pixel shall reuse the sprite
+    auto again = atlas.getDisc(10.26, 20.0, r + 0.01, left, top);
+    if (again != disc || left != 10 - 4) {
+        std::cout << "sprite disc not reused" << std::endl;
+        return false;
+    }
+    // a cone with the volume of a third
+    auto diffuse = atlas.getDiffuse(0.0, 0.0, r, left, top);
+    auto volume = coverage(diffuse);
+    if (std::abs(volume - Math::PI * r * r / 3.0) > 0.5) {
+        std::cout << "sprite diffuse volume " << volume << " exp " << Math::PI * r * r / 3.0 << std::endl;
+        return false;
+    }
+    if (atlas.getSpriteCount() != 2u
+     || atlas.isCached(SpriteAtlas::MAX_RADIUS + 1.0)) {
+        std::cout << "sprite count " << atlas.getSpriteCount() << std::endl;
+        return false;
+    }
+    atlas.setSize(800, 600);
+    return atlas.getSpriteCount() == 0u;
+}
+
+// sum of the alpha in pixel
+static double
+alphaSum(const std::vector<uint32_t>& image)
+{
+    double sum{};
+    for (auto p : image) {
+        sum += static_cast<double>(p >> 24) / 255.0;
+    }
+    return sum;
+}
+
+static void
+rasterScene(Rasterizer& rasterizer)
+{
+    auto white = RasterPaint{RasterPaint::premultiply(1.0, 1.0, 1.0, 1.0), nullptr};
+    rasterizer.moveTo(10.5, 10.5);     // a square of 100 pixel
+    rasterizer.lineTo(20.5, 10.5);
+    rasterizer.lineTo(20.5, 20.5);
+    rasterizer.lineTo(10.5, 20.5);
+    rasterizer.fill(white);
+    constexpr int segments{256};
+    for (int i = 0; i < segments; ++i) {    // a circle clipped to the image
+        double a = Math::TWO_PI * i / segments;
+        rasterizer.lineTo(64.0 + 20.0 * std::cos(a), 127.0 + 20.0 * std::sin(a));
+    }
+    rasterizer.fill(white);
+}
+
+// a zigzag with a miter (90 degree) and a bevel (beyond the limit) join
+static constexpr double zigzag[][2]{{20.0, 40.0}, {60.0, 40.0}, {60.0, 80.0}, {64.0, 20.0}, {100.0, 90.0}};
+
+// the alpha of the rasterizer compared to cairo for the scene, max and mean difference 0..255
+static void
+compareCairo(const std::vector<uint32_t>& image, int size, int& maxDiff, double& meanDiff)
+{
+    auto surface = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, size, size);
+    auto ctx = Cairo::Context::create(surface);
+    ctx->set_source_rgb(1.0, 1.0, 1.0);
+    ctx->move_to(10.5, 10.5);
+    ctx->line_to(20.5, 10.5);
+    ctx->line_to(20.5, 20.5);
+    ctx->line_to(10.5, 20.5);
+    ctx->fill();
+    constexpr int segments{256};
+    for (int i = 0; i < segments; ++i) {
+        double a = Math::TWO_PI * i / segments;
+        ctx->line_to(64.0 + 20.0 * std::cos(a), 127.0 + 20.0 * std::sin(a));
+    }
+    ctx->fill();
+    ctx->set_line_width(4.0);
+    for (auto& p : zigzag) {
+        ctx->line_to(p[0], p[1]);
+    }
+    ctx->stroke();
+    surface->flush();
+    maxDiff = 0;
+    double sum{};
+    for (int y = 0; y < size; ++y) {
+        auto row = reinterpret_cast<const uint32_t*>(surface->get_data() + y * surface->get_stride());
+        for (int x = 0; x < size; ++x) {
+            const int diff = std::abs(static_cast<int>(row[x] >> 24) - static_cast<int>(image[y * size + x] >> 24));
+            maxDiff = std::max(maxDiff, diff);
+            sum += diff;
+        }
+    }
+    meanDiff = sum / (static_cast<double>(size) * size);
+}
+
+static bool
+test_rasterizer()
+{
+    constexpr int size{128};
+    std::vector<uint32_t> image(size * size, 0u);
+    Rasterizer rasterizer(image.data(), size, size, size * sizeof(uint32_t));
+    rasterScene(rasterizer);
+    rasterizer.render();
+    const double circle = Math::PI * 20.0 * 20.0;
+    auto area = alphaSum(image);
+    auto exp = 100.0 + circle / 2.0 + 40.0;   // the upper half and the row below the center
+    if (std::abs(area - exp) > 1.0) {
+        std::cout << "raster area " << area << " exp " << exp << std::endl;
+        return false;
+    }
+    // the bands shall give the same result
+    std::vector<uint32_t> banded(size * size, 0u);
+    Rasterizer bandRasterizer(banded.data(), size, size, size * sizeof(uint32_t));
+    rasterScene(bandRasterizer);
+    BandPool pool(4u);
+    bandRasterizer.render(&pool);
+    if (banded != image) {
+        std::cout << "raster bands differ" << std::endl;
+        return false;
+    }
+    // the shapes and joins shall match cairo within the anti-aliasing
+    for (auto& p : zigzag) {
+        rasterizer.lineTo(p[0], p[1]);
+    }
+    rasterizer.stroke(4.0, RasterPaint{RasterPaint::premultiply(1.0, 1.0, 1.0, 1.0), nullptr});
+    rasterScene(rasterizer);
+    std::fill(image.begin(), image.end(), 0u);
+    rasterizer.render(&pool);
+    int maxDiff{};
+    double meanDiff{};
+    compareCairo(image, size, maxDiff, meanDiff);
+    if (maxDiff > 48 || meanDiff > 0.5) {
+        std::cout << "raster to cairo max diff " << maxDiff << " mean " << meanDiff << std::endl;
+        return false;
+    }
+    // clip to a circle and paint the whole image with a gradient
+    std::fill(image.begin(), image.end(), 0u);
+    for (int i = 0; i < 256; ++i) {
+        double a = Math::TWO_PI * i / 256;
+        rasterizer.lineTo(64.0 + 30.0 * std::cos(a), 64.0 + 30.0 * std::sin(a));
+    }
+    rasterizer.clip();
+    auto gradient = std::make_shared<RasterGradient>();
+    gradient->cx = 64.0;
+    gradient->cy = 64.0;
+    gradient->r0 = 0.0;
+    gradient->r1 = 30.0;
+    gradient->stops.emplace_back(0.0, RasterPaint::premultiply(1.0, 1.0, 1.0, 1.0));
+    gradient->stops.emplace_back(1.0, RasterPaint::premultiply(1.0, 1.0, 1.0, 0.0));
+    rasterizer.moveTo(0.0, 0.0);
+    rasterizer.lineTo(size, 0.0);
+    rasterizer.lineTo(size, size);
+    rasterizer.lineTo(0.0, size);
+    rasterizer.fill(RasterPaint{f32x4{}, gradient});
+    // a line of 40 pixel with width 2
+    rasterizer.setClip(Rasterizer::NO_CLIP);
+    rasterizer.moveTo(4.0, 100.0);
+    rasterizer.lineTo(44.0, 100.0);
+    rasterizer.stroke(2.0, RasterPaint{RasterPaint::premultiply(1.0, 1.0, 1.0, 1.0), nullptr});
+    BandPool oddPool(3u);
+    rasterizer.render(&oddPool);
+    area = alphaSum(image);
+    exp = circle * 900.0 / 400.0 / 3.0 + 80.0;    // the cone volume
+    if (std::abs(area - exp) > 2.0) {
+        std::cout << "raster gradient " << area << " exp " << exp << std::endl;
+        return false;
+    }
+    return true;
+}
+// a scene with sharp corners near the band edges
+static void
+bandScene(Renderer* renderer)
+{
+    RenderColor back(0.0, 0.0, 0.2);
+    renderer->setSource(back);
+    renderer->rectangle(0.0, 0.0, 256.0, 256.0);
+    renderer->fill();
+    RenderColor lineColor(0.8, 0.8, 0.8);
+    renderer->setSource(lineColor);
+    renderer->setLineWidth(6.0);
+    PolylineBatch lines;
+    lines.begin();      // the miter of the corner at 110 reaches the band below 128
+    lines.add(40.0, 10.0);
+    lines.add(52.6, 110.0);
+    lines.add(65.2, 10.0);
+    renderer->polylines(lines.getX(), lines.getY(), lines.getOffsets());
+    renderer->moveTo(140.0, 240.0);     // the same with a path, the corner at 140 reaches the band above
+    renderer->lineTo(152.6, 140.0);
+    renderer->lineTo(165.2, 240.0);
+    renderer->stroke();
+    DotBatch stars;
+    for (int i = 0; i < 16; ++i) {
+        stars.add(8.0 + i * 15.0, 60.0 + i * 8.3, 1.0 + (i % 4));
+    }
+    renderer->dots(stars.getX(), stars.getY(), stars.getRadius());
+}
+
+static bool
+test_bandedRendering()
+{
+    constexpr int size{256};
+    auto atlas = std::make_shared<SpriteAtlas>();
+    atlas->setSize(size, size);
+    auto image = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, size, size);
+    {
+        CairoRenderer renderer(Cairo::Context::create(image));
+        renderer.setAtlas(atlas);
+        bandScene(&renderer);
+    }
+    image->flush();
+    auto banded = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, size, size);
+    BandPool pool(4u);
+    std::vector<std::shared_ptr<SpriteAtlas>> bandAtlases;
+    for (int run = 0; run < 2; ++run) {     // the second reuses the threads
+        RecordingRenderer recording;
+        bandScene(&recording);
+        recording.renderBands(banded, pool, bandAtlases);
+    }
+    banded->flush();
+    int maxDiff{};
+    for (int y = 0; y < size; ++y) {
+        auto rowA = image->get_data() + y * image->get_stride();
+        auto rowB = banded->get_data() + y * banded->get_stride();
+        for (int x = 0; x < size * 4; ++x) {
+            maxDiff = std::max(maxDiff, std::abs(static_cast<int>(rowA[x]) - static_cast<int>(rowB[x])));
+        }
+    }
+    if (bandAtlases.size() != 4u
+     || maxDiff > 2) {
+        std::cout << "banded atlases " << bandAtlases.size() << " max diff " << maxDiff << std::endl;
+        return false;
+    }
+    return true;
+}
+
 // if you want to debug the phase display use this
 //static bool
 //test_pdf()
@@ -315,6 +970,515 @@ test_moon()
 /*
  *
  */
+static bool
+test_updateScheduler()
+{
+    UpdateScheduler scheduler;
+    UpdateScheduler::Reason reason;
+    // without threshold the sky motion is not considered
+    scheduler.setMaxDelay(60.0);
+    auto interval = scheduler.getDelay(1000.0, 0.0, 2160.0, reason);
+    if (std::abs(interval - 60.0) > 0.001
+     || reason != UpdateScheduler::Reason::Interval) {
+        std::cout << "schedule default delay " << interval << std::endl;
+        return false;
+    }
+    scheduler.setThreshold(1.0);
+    scheduler.setMaxDelay(3600.0);
+    // a full hd screen moves a pixel in ~25s
+    auto delay = scheduler.getDelay(1000.0, 0.0, 540.0, reason);
+    auto exp = UpdateScheduler::SIDEREAL_DAY / (540.0 * Math::TWO_PI);
+    if (std::abs(delay - exp) > 0.001
+     || reason != UpdateScheduler::Reason::Sky) {
+        std::cout << "schedule sky delay " << delay << " exp " << exp << std::endl;
+        return false;
+    }
+    // a tiny image hardly moves
+    scheduler.setMaxDelay(60.0);
+    delay = scheduler.getDelay(1000.0, 0.0, 10.0, reason);
+    if (std::abs(delay - 60.0) > 0.001
+     || reason != UpdateScheduler::Reason::Interval) {
+        std::cout << "schedule interval delay " << delay << std::endl;
+        return false;
+    }
+    // the clock wants the next minute
+    scheduler.setCadence(60u);
+    delay = scheduler.getDelay(1000.0, 0.0, 10.0, reason);
+    exp = 20.0 + UpdateScheduler::CADENCE_MARGIN;
+    if (std::abs(delay - exp) > 0.001
+     || reason != UpdateScheduler::Reason::Cadence) {
+        std::cout << "schedule cadence delay " << delay << " exp " << exp << std::endl;
+        return false;
+    }
+    // aligned to the local time
+    scheduler.setMaxDelay(3600.0);
+    scheduler.setCadence(3600u);
+    delay = scheduler.getDelay(3000.0, 1800.0, 1.0, reason);
+    exp = 2400.0 + UpdateScheduler::CADENCE_MARGIN;
+    if (std::abs(delay - exp) > 0.001) {
+        std::cout << "schedule local delay " << delay << " exp " << exp << std::endl;
+        return false;
+    }
+    scheduler.countWake(UpdateScheduler::Reason::Cadence, false);
+    scheduler.countWake(UpdateScheduler::Reason::Sky, true);
+    if (scheduler.getWakes(UpdateScheduler::Reason::Cadence) != 1u
+     || scheduler.getWakes(UpdateScheduler::Reason::Sky) != 0u
+     || scheduler.getPaused() != 1u) {
+        std::cout << "schedule wakes" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool
+test_imageEncoder()
+{
+    constexpr int size{8};
+    constexpr int stride{(size + 1) * static_cast<int>(sizeof(uint32_t))};
+    std::vector<uint32_t> image((size + 1) * size, 0xff000000u);
+    auto data = reinterpret_cast<const uint8_t*>(image.data());
+    // black is the start pixel so all is a run
+    auto qoi = ImageEncoder::encodeQoi(data, size, size, stride, true);
+    if (qoi.size() != 14u + 2u + 8u
+     || qoi[12] != 4u
+     || qoi[14] != (0xc0u | 61u)) {
+        std::cout << "qoi run size " << qoi.size() << std::endl;
+        return false;
+    }
+    image[10] = 0xff102030u;
+    qoi = ImageEncoder::encodeQoi(data, size, size, stride, false);
+    // run, rgb, rgb (black was not indexed), run
+    if (qoi.size() != 14u + 1u + 4u + 4u + 1u + 8u
+     || qoi[12] != 3u
+     || qoi[16] != 0x10u) {
+        std::cout << "qoi rgb size " << qoi.size() << std::endl;
+        return false;
+    }
+    auto hash = ImageEncoder::hash(data, size, size, stride);
+    image[size] = 1u;   // the padding is ignored
+    if (ImageEncoder::hash(data, size, size, stride) != hash) {
+        std::cout << "hash uses padding" << std::endl;
+        return false;
+    }
+    image[size - 1] = 1u;
+    if (ImageEncoder::hash(data, size, size, stride) == hash) {
+        std::cout << "hash unchanged" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool
+test_imageOutput()
+{
+    ImageOutput output("/tmp", "star_");
+    auto first = output.getNext(".png");
+    output.setShown(first);
+    auto second = output.getNext(".png");
+    output.setShown(second);
+    if (first != "/tmp/star_a.png"
+     || second != "/tmp/star_b.png"
+     || output.getNext(".png") != first) {
+        std::cout << "output slots " << first << " " << second << std::endl;
+        return false;
+    }
+    // requested again before the previous was shown, the shown stays untouched
+    auto pending = output.getNext(".png");
+    if (pending != first) {
+        std::cout << "output pending " << pending << std::endl;
+        return false;
+    }
+    output.setShown(pending);
+    // a skipped image leaves the slot free
+    auto skipped = output.getNext(".png");
+    output.setUnused(skipped);
+    if (skipped != second
+     || output.getNext(".png") != second) {
+        std::cout << "output skipped " << skipped << std::endl;
+        return false;
+    }
+    // after a restart the newest file is taken as shown
+    auto dir = std::filesystem::temp_directory_path() / "imageOutputTest";
+    std::filesystem::create_directories(dir);
+    ImageOutput restarted(dir.string(), "star_");
+    auto shownBefore = (dir / "star_a.png").string();
+    std::ofstream(dir / "star_b.png") << "b";
+    std::ofstream(shownBefore) << "a";
+    std::filesystem::last_write_time(dir / "star_b.png", std::filesystem::last_write_time(shownBefore) - std::chrono::hours(1));
+    restarted.restoreShown(".png");
+    auto restartNext = restarted.getNext(".png");
+    std::filesystem::remove_all(dir);
+    if (restarted.getShown() != shownBefore
+     || restartNext != (dir / "star_b.png").string()) {
+        std::cout << "output restart " << restarted.getShown() << " next " << restartNext << std::endl;
+        return false;
+    }
+    if (!output.isSlot("star_b.png", ".png")
+     || output.isSlot("star_2026-01-01_120000.png", ".png")) {
+        std::cout << "output slot names" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool
+test_compositor()
+{
+    auto image = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, 64, 64);
+    auto ctx = Cairo::Context::create(image);
+    Compositor compositor;
+    int draws{};
+    auto draw = [&draws] (const Cairo::RefPtr<Cairo::Context>&) {
+        ++draws;
+    };
+    for (size_t key : {1u, 1u, 2u, 2u}) {
+        compositor.begin(64, 64);
+        compositor.paint(ctx, "mod", key, 0.0, 0.0, 32, 32, draw);
+        compositor.paint(ctx, "live", Compositor::UNCACHED, 0.0, 32.0, 32, 32, draw);
+        compositor.end();
+    }
+    if (draws != 2 + 4
+     || compositor.getHits("mod") != 2u
+     || compositor.getMisses("mod") != 2u
+     || compositor.getHits("live") != 0u
+     || compositor.getMisses("live") != 4u) {
+        std::cout << "compositor draws " << draws
+                  << " hits " << compositor.getHits("mod")
+                  << " misses " << compositor.getMisses("mod") << std::endl;
+        return false;
+    }
+    compositor.invalidate();
+    compositor.begin(64, 64);
+    compositor.paint(ctx, "mod", 2u, 0.0, 0.0, 32, 32, draw);
+    compositor.end();
+    if (compositor.getMisses("mod") != 3u) {
+        std::cout << "compositor invalidate misses " << compositor.getMisses("mod") << std::endl;
+        return false;
+    }
+    // a layer drawn ahead is used without drawing, also if uncached
+    compositor.begin(64, 64);
+    compositor.prepare("live", Compositor::UNCACHED, Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, 32, 32));
+    if (!compositor.isCurrent("live", Compositor::UNCACHED, 32, 32)
+     || compositor.isCurrent("mod", 3u, 32, 32)) {
+        std::cout << "compositor current" << std::endl;
+        return false;
+    }
+    draws = 0;
+    compositor.paint(ctx, "live", Compositor::UNCACHED, 0.0, 32.0, 32, 32, draw);
+    // a late layer shows the last surface
+    if (!compositor.paintLast(ctx, "mod", 0.0, 0.0)
+     || compositor.paintLast(ctx, "none", 0.0, 0.0)) {
+        std::cout << "compositor last" << std::endl;
+        return false;
+    }
+    compositor.end();
+    if (draws != 0
+     || !compositor.isCurrent("mod", 2u, 32, 32)) {
+        std::cout << "compositor prepared draws " << draws << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool
+test_sysSampler()
+{
+    CpuTimes all;
+    std::vector<CpuTimes> cores;
+    if (!SysSampler::parseStat("cpu  100 0 100 700 100 0 0 0 0 0\n"
+                               "cpu0 50 0 50 300 100 0 0 0 0 0\n"
+                               "cpu1 50 0 50 400 0 0 0 0 0 0\n"
+                               "intr 12345\n", all, cores)
+     || cores.size() != 2u
+     || all.total != 1000u
+     || all.busy != 200u) {
+        std::cout << "sampler stat busy " << all.busy << " total " << all.total << " cores " << cores.size() << std::endl;
+        return false;
+    }
+    CpuTimes later{all.busy + 50u, all.total + 100u};
+    if (std::abs(SysSampler::getUsage(all, later) - 0.5f) > 1.0e-6f) {
+        std::cout << "sampler usage " << SysSampler::getUsage(all, later) << std::endl;
+        return false;
+    }
+    std::array<double, 3> load;
+    if (!SysSampler::parseLoadavg("0.52 0.40 0.33 2/1234 5678\n", load)
+     || std::abs(load[0] - 0.52) > 1.0e-9
+     || std::abs(load[2] - 0.33) > 1.0e-9) {
+        std::cout << "sampler loadavg " << load[0] << std::endl;
+        return false;
+    }
+    uint64_t totalKb{}, availableKb{};
+    if (!SysSampler::parseMeminfo("MemTotal:       16000000 kB\n"
+                                  "MemFree:         1000000 kB\n"
+                                  "MemAvailable:    8000000 kB\n", totalKb, availableKb)
+     || totalKb != 16000000u
+     || availableKb != 8000000u) {
+        std::cout << "sampler meminfo " << totalKb << " " << availableKb << std::endl;
+        return false;
+    }
+    // only the disks count, partitions, loop, network and mmc boot devices are skipped
+    uint64_t readBytes{}, writtenBytes{};
+    if (!SysSampler::parseDiskstats(
+            "   8       0 sda 10 0 200 0 20 0 100 0 0 0 0\n"
+            "   8       1 sda1 10 0 200 0 20 0 100 0 0 0 0\n"
+            " 259       0 nvme0n1 10 0 2 0 20 0 4 0 0 0 0\n"
+            " 259       1 nvme0n1p1 10 0 2 0 20 0 4 0 0 0 0\n"
+            "   7       0 loop0 10 0 1000 0 0 0 0 0 0 0 0\n"
+            " 179       0 mmcblk0 10 0 8 0 20 0 16 0 0 0 0\n"
+            " 179       1 mmcblk0p1 10 0 8 0 20 0 16 0 0 0 0\n"
+            " 179       8 mmcblk0boot0 10 0 1000 0 0 0 0 0 0 0 0\n"
+            " 179      16 mmcblk0rpmb 10 0 1000 0 0 0 0 0 0 0 0\n"
+            "  43       0 nbd0 10 0 1000 0 0 0 0 0 0 0 0\n", readBytes, writtenBytes)
+     || readBytes != 210u * 512u
+     || writtenBytes != 120u * 512u) {
+        std::cout << "sampler diskstats " << readBytes << " " << writtenBytes << std::endl;
+        return false;
+    }
+    uint64_t rxBytes{}, txBytes{};
+    if (!SysSampler::parseNetDev(
+            "Inter-|   Receive                                                |  Transmit\n"
+            " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n"
+            "    lo:  5000      10    0    0    0     0          0         0     5000      10    0    0    0     0       0          0\n"
+            "  eth0:  1000      10    0    0    0     0          0         0     2000      10    0    0    0     0       0          0\n", rxBytes, txBytes)
+     || rxBytes != 1000u
+     || txBytes != 2000u) {
+        std::cout << "sampler netdev " << rxBytes << " " << txBytes << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// a module slower than the budget is finished late and shown by the following image
+static bool
+test_moduleWorker()
+{
+    ModuleWorker worker;
+    std::atomic<int> drawn{0};
+    worker.submit("slow", 1u, 16, 16, 0, [&drawn] (const Cairo::RefPtr<Cairo::Context>&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        ++drawn;
+        return std::string("slow failed");     // shown by the caller
+    });
+    worker.submit("fast", 2u, 16, 16, 0, [] (const Cairo::RefPtr<Cairo::Context>&) {
+        return std::string();
+    });
+    if (worker.wait(std::chrono::milliseconds(50))
+     || worker.getOverruns() != 1u
+     || !worker.isBusy("slow")
+     || worker.isBusy("fast")) {     // dropped, submitted again with the next image
+        std::cout << "worker overrun " << worker.getOverruns() << std::endl;
+        return false;
+    }
+    std::vector<ModuleWorker::Result> results;
+    worker.take(results);
+    if (!results.empty()
+     || !worker.wait(ModuleWorker::NO_BUDGET)) {
+        std::cout << "worker early results " << results.size() << std::endl;
+        return false;
+    }
+    worker.take(results);
+    if (results.size() != 1u
+     || results[0].name != "slow"
+     || results[0].key != 1u
+     || !results[0].surface
+     || results[0].error != "slow failed"
+     || drawn != 1) {
+        std::cout << "worker late results " << results.size() << std::endl;
+        return false;
+    }
+    // the late result replaces the last layer, also if the key moved on
+    auto image = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, 64, 64);
+    auto ctx = Cairo::Context::create(image);
+    Compositor compositor;
+    compositor.begin(64, 64);
+    compositor.prepare(results[0].name, results[0].key, std::move(results[0].surface));
+    if (!compositor.hasPrepared("slow")
+     || compositor.isCurrent("slow", 2u, 16, 16)
+     || !compositor.paintLast(ctx, "slow", 0.0, 0.0)
+     || compositor.hasPrepared("slow")
+     || !compositor.isCurrent("slow", 1u, 16, 16)) {
+        std::cout << "worker late layer" << std::endl;
+        return false;
+    }
+    compositor.end();
+    // a module that does not return is left behind
+    auto hung = std::make_shared<ModuleWorker>();
+    hung->submit("hung", 1u, 16, 16, 0, [] (const Cairo::RefPtr<Cairo::Context>&) {
+        std::this_thread::sleep_for(ModuleWorker::STOP_GRACE * 2);
+        return std::string();
+    });
+    hung->wait(std::chrono::milliseconds(10));
+    auto start = std::chrono::steady_clock::now();
+    hung.reset();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (elapsed >= ModuleWorker::STOP_GRACE * 2) {
+        std::cout << "worker blocked by hung module" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// the render worker hands the images over with this
+static bool
+test_tripleBuffer()
+{
+    struct Frame
+    {
+        uint32_t number;
+        uint32_t check;     // written separately to see a frame that is still written
+    };
+    TripleBuffer<Frame> buffer;
+    std::atomic<bool> stop{false};
+    uint32_t published{};
+    std::thread producer([&buffer, &stop, &published] {
+        uint32_t number{};
+        while (!stop) {
+            ++number;
+            auto& frame = buffer.getBack();
+            frame.number = number;
+            frame.check = number * 3u;
+            buffer.publish();
+        }
+        published = number;
+    });
+    while (buffer.getFront().number == 0u) {
+        std::this_thread::yield();
+    }
+    uint32_t last{};
+    uint32_t taken{};
+    bool valid{true};
+    for (uint32_t read = 0; read < 200000u; ++read) {
+        auto& frame = buffer.getFront();
+        if (frame.check != frame.number * 3u
+         || frame.number < last) {
+            valid = false;
+        }
+        if (frame.number != last) {
+            ++taken;
+        }
+        last = frame.number;
+    }
+    stop = true;
+    producer.join();
+    auto& frame = buffer.getFront();
+    if (!valid
+     || frame.number != published
+     || frame.check != published * 3u) {
+        std::cout << "triple buffer valid " << valid << " last " << frame.number << " exp " << published << std::endl;
+        return false;
+    }
+    std::cout << "triple buffer taken " << taken << " of " << published << std::endl;
+    return true;
+}
+
+// a private bus with a stand-in xfconf, so the users desktop stays untouched
+static bool
+test_xfconfSetting()
+{
+#   ifdef __unix
+    auto daemon = Glib::find_program_in_path("dbus-daemon");
+    if (daemon.empty()) {
+        std::cout << "xfconf no dbus-daemon, skipped" << std::endl;
+        return true;
+    }
+    GPid pid;
+    int out;
+    Glib::spawn_async_with_pipes(Glib::get_current_dir()
+        , std::vector<std::string>{daemon, "--session", "--nofork", "--print-address=1"}
+        , Glib::SpawnFlags::SPAWN_DEFAULT, Glib::SlotSpawnChildSetup(), &pid, nullptr, &out, nullptr);
+    auto stream = fdopen(out, "r");
+    std::array<char, 512> line{};
+    const bool started = std::fgets(line.data(), static_cast<int>(line.size()), stream) != nullptr;
+    std::fclose(stream);
+    std::string address{line.data()};
+    while (!address.empty()
+        && address.back() == '\n') {
+        address.pop_back();
+    }
+    bool ok = started && !address.empty();
+    if (!ok) {
+        std::cout << "xfconf no bus address" << std::endl;
+    }
+    std::vector<std::string> received;
+    if (ok) {
+        try {
+            Glib::setenv("DBUS_SESSION_BUS_ADDRESS", address, true);
+            auto service = Gio::DBus::Connection::create_for_address_sync(address
+                    , Gio::DBus::ConnectionFlags::CONNECTION_FLAGS_AUTHENTICATION_CLIENT
+                    | Gio::DBus::ConnectionFlags::CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION);
+            auto node = Gio::DBus::NodeInfo::create_for_xml(
+                  "<node><interface name='org.xfce.Xfconf'>"
+                  "<method name='SetProperty'>"
+                  "<arg type='s' name='channel' direction='in'/>"
+                  "<arg type='s' name='property' direction='in'/>"
+                  "<arg type='v' name='value' direction='in'/>"
+                  "</method></interface></node>");
+            Gio::DBus::InterfaceVTable vtable([&received] (const Glib::RefPtr<Gio::DBus::Connection>&
+                    , const Glib::ustring&, const Glib::ustring&, const Glib::ustring&, const Glib::ustring&
+                    , const Glib::VariantContainerBase& params
+                    , const Glib::RefPtr<Gio::DBus::MethodInvocation>& invocation) {
+                Glib::Variant<Glib::ustring> property;
+                params.get_child(property, 1);
+                if (property.get() != "/backdrop/last-image") {
+                    invocation->return_error(Gio::DBus::Error(Gio::DBus::Error::INVALID_ARGS, "unknown property"));
+                    return;
+                }
+                Glib::Variant<Glib::VariantBase> value;
+                params.get_child(value, 2);
+                received.push_back(Glib::VariantBase::cast_dynamic<Glib::Variant<Glib::ustring>>(value.get()).get());
+                invocation->return_value(Glib::VariantContainerBase());
+            });
+            service->register_object(XfconfSetting::XFCONF_PATH, node->lookup_interface(XfconfSetting::XFCONF_NAME), vtable);
+            service->call_sync("/org/freedesktop/DBus", "org.freedesktop.DBus", "RequestName"
+                    , Glib::VariantContainerBase::create_tuple(std::vector<Glib::VariantBase>{
+                          Glib::Variant<Glib::ustring>::create(XfconfSetting::XFCONF_NAME)
+                        , Glib::Variant<guint32>::create(0u)})
+                    , "org.freedesktop.DBus");
+            XfconfSetting setting;
+            std::vector<std::string> failed;
+            setting.signal_failed().connect([&failed] (const Glib::RefPtr<Gio::File>& file) {
+                failed.push_back(file->get_path());
+            });
+            bool timedOut{false};
+            auto timeout = Glib::signal_timeout().connect([&timedOut] {
+                timedOut = true;
+                return false;
+            }, 5000);
+            auto context = Glib::MainContext::get_default();
+            // the first while connecting is replaced
+            setting.set("xfce4-desktop", "/backdrop/last-image", Gio::File::create_for_path("/tmp/star_a.png"));
+            setting.set("xfce4-desktop", "/backdrop/last-image", Gio::File::create_for_path("/tmp/star_b.png"));
+            while (received.empty() && !timedOut) {
+                context->iteration(true);
+            }
+            // a refused call uses the command
+            setting.set("xfce4-desktop", "/backdrop/unknown", Gio::File::create_for_path("/tmp/star_a.png"));
+            while (failed.empty() && !timedOut) {
+                context->iteration(true);
+            }
+            timeout.disconnect();
+            if (received.size() != 1u
+             || received[0] != "/tmp/star_b.png"
+             || failed.size() != 1u
+             || failed[0] != "/tmp/star_a.png") {
+                std::cout << "xfconf received " << received.size() << " failed " << failed.size() << std::endl;
+                ok = false;
+            }
+            service->close_sync();
+        }
+        catch (const Glib::Error& exc) {
+            std::cout << "xfconf bus error " << exc.what() << std::endl;
+            ok = false;
+        }
+    }
+    kill(pid, SIGTERM);
+    Glib::spawn_close_pid(pid);
+    return ok;
+#   else
+    return true;
+#   endif
+}
+
 int main(int argc, char** argv)
 {
     //std::locale::global(std::locale("de_DE.ISO-8859-15@euro"));
@@ -348,5 +1512,56 @@ int main(int argc, char** argv)
     if (!test_moon()) {
         return 9;
     }
+    if (!test_horizonMatrix()) {
+        return 11;
+    }
+    if (!test_catalog()) {
+        return 12;
+    }
+    if (!test_tiles()) {
+        return 13;
+    }
+    if (!test_skyIndex()) {
+        return 14;
+    }
+    if (!test_allocation()) {
+        return 15;
+    }
+    if (!test_polylineStore()) {
+        return 16;
+    }
+    if (!test_spriteAtlas()) {
+        return 17;
+    }
+    if (!test_rasterizer()) {
+        return 18;
+    }
+    if (!test_updateScheduler()) {
+        return 19;
+    }
+    if (!test_imageEncoder()) {
+        return 20;
+    }
+    if (!test_imageOutput()) {
+        return 21;
+    }
+    if (!test_compositor()) {
+        return 22;
+    }
+    if (!test_sysSampler()) {
+        return 23;
+    }
+    if (!test_bandedRendering()) {
+        return 24;
+    }
+    if (!test_moduleWorker()) {
+        return 25;
+    }
+    if (!test_tripleBuffer()) {
+        return 26;
+    }
+    if (!test_xfconfSetting()) {
+        return 27;
+    }
     return 0;
 }
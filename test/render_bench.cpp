@@ -0,0 +1,184 @@
+/* -*- Mode: c++; c-basic-offset: 4; tab-width: 4;  coding: utf-8; -*-  */
+/*
+ * Copyright (C) 2026 RPf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <clocale>
+#include <gtkmm.h>
+
+#include "Renderer.hpp"
+#include "PixelRenderer.hpp"
+#include "RecordingRenderer.hpp"
+#include "SpriteAtlas.hpp"
+#include "Math.hpp"
+
+// compares the cairo, the banded cairo and the pixel renderer for a sky like scene,
+//   run with meson test --benchmark
+
+static constexpr int WIDTH{3840};
+static constexpr int HEIGHT{2160};
+static constexpr int RUNS{5};
+
+static void
+drawScene(Renderer* renderer)
+{
+    std::mt19937 gen{4711};
+    const double r = HEIGHT / 2.0;
+    std::uniform_real_distribution<double> posDist{-r, r};
+    std::uniform_real_distribution<double> radiusDist{0.0, 1.0};
+    renderer->save();
+    auto grad = renderer->createRadialGradient(WIDTH / 2, HEIGHT / 2, r / 3.0, WIDTH / 2, HEIGHT / 2, r);
+    RenderColor start(0.0, 0.0, 0.2);
+    RenderColor stop(0.1, 0.1, 0.3);
+    grad->addColorStop(0.0, start);
+    grad->addColorStop(1.0, stop);
+    renderer->setSource(grad);
+    renderer->rectangle(0.0, 0.0, WIDTH, HEIGHT);
+    renderer->fill();
+    renderer->translate(WIDTH / 2, HEIGHT / 2);
+    renderer->circle(0.0, 0.0, r);
+    renderer->clip();
+    RenderColor lineColor(0.4, 0.4, 0.4);
+    renderer->setSource(lineColor);
+    renderer->setLineWidth(HEIGHT / 600.0);
+    PolylineBatch lines;
+    for (int l = 0; l < 500; ++l) {
+        lines.begin();
+        double x = posDist(gen);
+        double y = posDist(gen);
+        for (int p = 0; p < 10; ++p) {
+            lines.add(x, y);
+            x += posDist(gen) / 20.0;
+            y += posDist(gen) / 20.0;
+        }
+    }
+    renderer->polylines(lines.getX(), lines.getY(), lines.getOffsets());
+    RenderColor starColor(0.8, 0.8, 0.8);
+    renderer->setSource(starColor);
+    DotBatch stars;
+    for (int s = 0; s < 20000; ++s) {
+        const double rs = radiusDist(gen);
+        stars.add(posDist(gen), posDist(gen), 0.5 + 6.0 * rs * rs * rs);
+    }
+    renderer->dots(stars.getX(), stars.getY(), stars.getRadius());
+    for (int m = 0; m < 100; ++m) {
+        RenderColor mstart(0.6, 0.6, 0.6, 1.0);
+        RenderColor mstop(0.6, 0.6, 0.6, 0.0);
+        renderer->diffuseDot(posDist(gen), posDist(gen), HEIGHT / 300.0, mstart, mstop);
+    }
+    renderer->showPhase(Phase(0.3), r / 2.0, -r / 2.0, HEIGHT / 200.0);
+    Pango::FontDescription font("Sans 7");
+    auto text = renderer->createText(font);
+    RenderColor textColor(0.6, 0.6, 0.6);
+    renderer->setSource(textColor);
+    for (int t = 0; t < 100; ++t) {
+        text->setText(Glib::ustring::sprintf("Label %d", t % 20));
+        renderer->showText(text, posDist(gen), posDist(gen), TextAlign::LeftTop);
+    }
+    renderer->restore();
+}
+
+static double
+measure(const std::function<void(const Cairo::RefPtr<Cairo::ImageSurface>&)>& draw, Cairo::RefPtr<Cairo::ImageSurface>& image)
+{
+    double best{1.0e9};
+    for (int run = 0; run < RUNS; ++run) {
+        image = Cairo::ImageSurface::create(Cairo::Format::FORMAT_ARGB32, WIDTH, HEIGHT);
+        auto start = std::chrono::steady_clock::now();
+        draw(image);
+        image->flush();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+// mean absolute difference of the channels 0..255
+static double
+difference(const Cairo::RefPtr<Cairo::ImageSurface>& a, const Cairo::RefPtr<Cairo::ImageSurface>& b)
+{
+    double sum{};
+    for (int y = 0; y < HEIGHT; ++y) {
+        auto rowA = a->get_data() + y * a->get_stride();
+        auto rowB = b->get_data() + y * b->get_stride();
+        for (int x = 0; x < WIDTH * 4; ++x) {
+            sum += std::abs(static_cast<int>(rowA[x]) - static_cast<int>(rowB[x]));
+        }
+    }
+    return sum / (static_cast<double>(WIDTH) * HEIGHT * 4.0);
+}
+
+int
+main(int argc, char** argv)
+{
+    std::setlocale(LC_ALL, "");
+    auto atlas = std::make_shared<SpriteAtlas>();
+    atlas->setSize(WIDTH, HEIGHT);
+    Cairo::RefPtr<Cairo::ImageSurface> cairoImage;
+    auto cairoMs = measure([&] (const Cairo::RefPtr<Cairo::ImageSurface>& image) {
+        auto ctx = Cairo::Context::create(image);
+        CairoRenderer renderer(ctx);
+        renderer.setAtlas(atlas);
+        drawScene(&renderer);
+    }, cairoImage);
+    Cairo::RefPtr<Cairo::ImageSurface> tiledImage;
+    std::vector<std::shared_ptr<SpriteAtlas>> bandAtlases;
+    BandPool bandPool(0u);
+    auto tiledMs = measure([&] (const Cairo::RefPtr<Cairo::ImageSurface>& image) {
+        RecordingRenderer renderer;
+        drawScene(&renderer);
+        renderer.renderBands(image, bandPool, bandAtlases);
+    }, tiledImage);
+    Cairo::RefPtr<Cairo::ImageSurface> singleImage;
+    auto singleMs = measure([&] (const Cairo::RefPtr<Cairo::ImageSurface>& image) {
+        PixelRenderer renderer(image);
+        renderer.setAtlas(atlas);
+        drawScene(&renderer);
+        renderer.finish();
+    }, singleImage);
+    Cairo::RefPtr<Cairo::ImageSurface> bandImage;
+    auto bandMs = measure([&] (const Cairo::RefPtr<Cairo::ImageSurface>& image) {
+        PixelRenderer renderer(image, &bandPool);
+        renderer.setAtlas(atlas);
+        drawScene(&renderer);
+        renderer.finish();
+    }, bandImage);
+    std::cout << "image " << WIDTH << "x" << HEIGHT << " best of " << RUNS << std::endl
+              << "  cairo " << cairoMs << "ms" << std::endl
+              << "  cairo " << std::thread::hardware_concurrency() << " bands "
+              << tiledMs << "ms speedup " << cairoMs / tiledMs << std::endl
+              << "  pixel " << singleMs << "ms speedup " << cairoMs / singleMs << std::endl
+              << "  pixel " << std::thread::hardware_concurrency() << " threads "
+              << bandMs << "ms speedup " << cairoMs / bandMs << std::endl;
+    auto tiledDiff = difference(cairoImage, tiledImage);
+    std::cout << "  bands mean difference " << tiledDiff << std::endl;
+    if (tiledDiff >= 0.5) {
+        std::cout << "the cairo bands show seams!" << std::endl;
+        return 3;
+    }
+    auto diff = difference(cairoImage, bandImage);
+    std::cout << "  mean difference " << diff << std::endl;
+    if (difference(singleImage, bandImage) != 0.0) {
+        std::cout << "the bands differ from the single thread result!" << std::endl;
+        return 1;
+    }
+    return diff < 2.0 ? 0 : 2;     // shall look the same
+}